@@ -0,0 +1,59 @@
+#include "actionblockbasis.h"
+
+#include <limits>
+
+ActionBlockBasis::ActionBlockBasis(const boost::shared_ptr<const LSPIStateBasis> &state_basis, const unsigned int &num_actions)
+    : state_basis_(state_basis), num_actions_(num_actions) {
+
+    if (!state_basis_ || num_actions_ == 0 || static_cast<double>(num_actions_) * state_basis_->NumFeatures() > 2147483647.0) {
+        throw InvalidParameterException();
+    }
+}
+
+unsigned int ActionBlockBasis::NumFeatures() const {
+    return num_actions_ * state_basis_->NumFeatures();
+}
+
+unsigned int ActionBlockBasis::NumActions() const {
+    return num_actions_;
+}
+
+const LSPIStateBasis& ActionBlockBasis::StateBasis() const {
+    return *state_basis_;
+}
+
+void ActionBlockBasis::QValues(const unsigned int *indices, const double *values, const unsigned int &num_features, const Eigen::VectorXd &weights, Eigen::VectorXd &q_values) const {
+    const unsigned int num_state_features = state_basis_->NumFeatures();
+    q_values.resize(num_actions_);
+    for (unsigned int a = 0; a < num_actions_; ++a) {
+        const double *block = weights.data() + static_cast<std::size_t>(a) * num_state_features;
+        double q = 0.0;
+        for (unsigned int k = 0; k < num_features; ++k) {
+            q += block[indices[k]] * values[k];
+        }
+        q_values(a) = q;
+    }
+}
+
+unsigned int ActionBlockBasis::Greedy(SampleFactory &sample_factory, const Eigen::VectorXd &q_values) {
+    double best_q = -std::numeric_limits<double>::max();
+    unsigned int num_best = 0;
+    unsigned int first_best = 0;
+    for (unsigned int a = 0; a < q_values.size(); ++a) {
+        if (q_values(a) > best_q) {
+            best_q = q_values(a);
+            num_best = 1;
+            first_best = a;
+        } else if (q_values(a) == best_q) {
+            ++num_best;
+        }
+    }
+
+    unsigned int tie = sample_factory.SampleRandomNatural() % num_best;
+    for (unsigned int a = first_best; a < q_values.size(); ++a) {
+        if (q_values(a) == best_q && tie-- == 0) {
+            return a;
+        }
+    }
+    return first_best;
+}
@@ -0,0 +1,46 @@
+#ifndef ACTIONBLOCKBASIS_H
+#define ACTIONBLOCKBASIS_H
+
+#include "lspistatebasis.h"
+#include "samplefactory.h"
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <eigen3/Eigen/Dense>
+
+class ActionBlockBasis {
+    /*
+    * This class represents LSPI features of a state and an action index with one block of weights per action: the
+    * features of (s, a) are the state basis' features of s placed into block a, feature a * S + i for state feature i
+    * of S. Hence Q(s, a) = w_a^T psi(s), a sample's features have as many nonzeros as its state features and A of LSTDQ
+    * only has nonzero blocks (a, a') for the transitions of the samples.
+    *
+    * The greedy policy evaluates the state features once and one sparse dot product per action.
+    */
+public:
+    ActionBlockBasis(const boost::shared_ptr<const LSPIStateBasis> &state_basis, const unsigned int &num_actions);
+
+    // The number of weights, NumActions() blocks of the state basis' features
+    unsigned int NumFeatures() const;
+
+    unsigned int NumActions() const;
+
+    const LSPIStateBasis& StateBasis() const;
+
+    // Computes the Q values "q_values" of all actions of the state with "num_features" state features "indices" and "values"
+    void QValues(const unsigned int *indices, const double *values, const unsigned int &num_features, const Eigen::VectorXd &weights, Eigen::VectorXd &q_values) const;
+
+    // Returns the index of the highest Q value of "q_values", "sample_factory" breaks ties uniformly
+    static unsigned int Greedy(SampleFactory &sample_factory, const Eigen::VectorXd &q_values);
+
+    // ActionBlockBasis can throw the following exceptions
+    class Exception {};
+    class InvalidParameterException : public Exception {};
+
+private:
+    boost::shared_ptr<const LSPIStateBasis> state_basis_;
+
+    unsigned int num_actions_;
+};
+
+#endif // ACTIONBLOCKBASIS_H
@@ -0,0 +1,107 @@
+#include "actionblockpolicy.h"
+
+#include <cstring>
+#include <fstream>
+
+const char ActionBlockPolicy::kMagic[8] = {'L', 'S', 'P', 'I', 'A', 'B', 'P', '\0'};
+const boost::uint32_t ActionBlockPolicy::kVersion;
+
+ActionBlockPolicy::ActionBlockPolicy(const ActionBlockBasis &basis, const Eigen::VectorXd &weights, const boost::uint32_t &state_type, const boost::uint64_t &action_set_hash)
+    : basis_(basis), weights_(weights), state_type_(state_type), action_set_hash_(action_set_hash) {
+
+    if (weights_.size() != basis_.NumFeatures()) {
+        throw InvalidWeightsException();
+    }
+}
+
+boost::shared_ptr<ActionBlockPolicy> ActionBlockPolicy::FromFile(const std::string &path_to_file) {
+    std::ifstream file(path_to_file.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw FileNotReadableException();
+    }
+
+    char magic[8];
+    boost::uint32_t header[4];
+    boost::uint64_t action_set_hash = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&action_set_hash), sizeof(action_set_hash));
+    if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || header[0] != kVersion || header[2] == 0) {
+        throw InvalidFileFormatException();
+    }
+
+    boost::shared_ptr<ActionBlockBasis> basis;
+    try {
+        basis.reset(new ActionBlockBasis(LSPIStateBasis::ReadFrom(file), header[2]));
+    } catch (const LSPIStateBasis::Exception &exception) {
+        throw InvalidFileFormatException();
+    } catch (const ActionBlockBasis::Exception &exception) {
+        throw InvalidFileFormatException();
+    }
+    if (basis->NumFeatures() != header[3]) {
+        throw InvalidFileFormatException();
+    }
+
+    Eigen::VectorXd weights(header[3]);
+    file.read(reinterpret_cast<char*>(weights.data()), weights.size() * sizeof(double));
+    if (!file || file.peek() != std::ifstream::traits_type::eof()) {
+        throw InvalidFileFormatException();
+    }
+
+    return boost::shared_ptr<ActionBlockPolicy>(new ActionBlockPolicy(*basis, weights, header[1], action_set_hash));
+}
+
+void ActionBlockPolicy::WriteToFile(const std::string &path_to_file) const {
+    std::ofstream file(path_to_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw FileNotWritableException();
+    }
+
+    const boost::uint32_t header[4] = {kVersion, state_type_, basis_.NumActions(), static_cast<boost::uint32_t>(weights_.size())};
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&action_set_hash_), sizeof(action_set_hash_));
+    basis_.StateBasis().WriteTo(file);
+    file.write(reinterpret_cast<const char*>(weights_.data()), weights_.size() * sizeof(double));
+    file.close();
+    if (!file) {
+        throw FileNotWritableException();
+    }
+}
+
+void ActionBlockPolicy::Pi(const std::vector<SampleFactory*> &sample_factories, const StateMatrix &states, std::vector<unsigned int> &actions) const {
+    if (states.cols() != StateDimension() || sample_factories.size() != static_cast<std::size_t>(states.rows())) {
+        throw InvalidStatesException();
+    }
+
+    const unsigned int num_states = states.rows();
+    std::vector<unsigned int> indices;
+    std::vector<double> values;
+    Eigen::VectorXd q_values;
+    actions.resize(num_states);
+    for (unsigned int i = 0; i < num_states; ++i) {
+        basis_.StateBasis().Features(states.data() + static_cast<std::size_t>(i) * states.cols(), indices, values);
+        basis_.QValues(indices.data(), values.data(), indices.size(), weights_, q_values);
+        actions[i] = ActionBlockBasis::Greedy(*sample_factories[i], q_values);
+    }
+}
+
+const ActionBlockBasis& ActionBlockPolicy::Basis() const {
+    return basis_;
+}
+
+const Eigen::VectorXd& ActionBlockPolicy::Weights() const {
+    return weights_;
+}
+
+unsigned int ActionBlockPolicy::StateDimension() const {
+    return basis_.StateBasis().StateDimension();
+}
+
+boost::uint32_t ActionBlockPolicy::StateType() const {
+    return state_type_;
+}
+
+boost::uint64_t ActionBlockPolicy::ActionSetHash() const {
+    return action_set_hash_;
+}
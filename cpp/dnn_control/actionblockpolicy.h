@@ -0,0 +1,76 @@
+#ifndef ACTIONBLOCKPOLICY_H
+#define ACTIONBLOCKPOLICY_H
+
+#include "actionblockbasis.h"
+#include "samplefactory.h"
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <eigen3/Eigen/Dense>
+
+class ActionBlockPolicy {
+    /*
+    * This class represents the greedy policy of the LSPI weights of an ActionBlockBasis, e.g. of a radial basis grid or
+    * tile coding, whose Q values are one sparse dot product per action.
+    *
+    * The policy file keeps the state basis with the weights, so a run which computes the basis from its samples can be
+    * evaluated without them. Like the samples, the policy keeps their state type and action set hash. Pi only reads the
+    * policy, so concurrent simulations share one policy. All values are stored in native byte order:
+    *
+    *   char magic[8] = "LSPIABP", uint32 version, uint32 state type, uint32 number of actions A,
+    *   uint32 number of weights N, uint64 action set hash, the state basis as written by LSPIStateBasis::WriteTo,
+    *   double weights[N]
+    */
+public:
+    // A batch of states, one state per row
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> StateMatrix;
+
+    // The magic bytes at the beginning of every policy file
+    const static char kMagic[8];
+
+    // The current format version
+    const static boost::uint32_t kVersion = 1;
+
+    // The greedy policy of "weights" of "basis" for the MDP of samples of state type "state_type" and action set hash "action_set_hash"
+    ActionBlockPolicy(const ActionBlockBasis &basis, const Eigen::VectorXd &weights, const boost::uint32_t &state_type, const boost::uint64_t &action_set_hash);
+
+    // Reads the policy file "path_to_file"
+    static boost::shared_ptr<ActionBlockPolicy> FromFile(const std::string &path_to_file);
+
+    // Writes the policy to file "path_to_file"
+    void WriteToFile(const std::string &path_to_file) const;
+
+    // Computes the index of the action with the highest Q value of every state of "states" into "actions", "sample_factories[i]" breaks the ties of state i
+    void Pi(const std::vector<SampleFactory*> &sample_factories, const StateMatrix &states, std::vector<unsigned int> &actions) const;
+
+    const ActionBlockBasis& Basis() const;
+
+    const Eigen::VectorXd& Weights() const;
+
+    unsigned int StateDimension() const;
+
+    boost::uint32_t StateType() const;
+
+    boost::uint64_t ActionSetHash() const;
+
+    // ActionBlockPolicy can throw the following exceptions
+    class Exception {};
+    class InvalidWeightsException : public Exception {};
+    class InvalidStatesException : public Exception {};
+    class FileNotWritableException : public Exception {};
+    class FileNotReadableException : public Exception {};
+    class InvalidFileFormatException : public Exception {};
+
+private:
+    ActionBlockBasis basis_;
+
+    Eigen::VectorXd weights_;
+
+    boost::uint32_t state_type_;
+
+    boost::uint64_t action_set_hash_;
+};
+
+#endif // ACTIONBLOCKPOLICY_H
@@ -105,6 +105,10 @@ double Asteroid::EvaluatePointWithStandardEquation(const Vector3D &position) con
     return result;
 }
 
+bool Asteroid::PositionIsInside(const Vector3D &position) const {
+    return EvaluatePointWithStandardEquation(position) < 1.0;
+}
+
 double Asteroid::AngularVelocityPeriod() const {
     return angular_velocity_period_;
 }
@@ -2,10 +2,12 @@
 #define ASTEROID_H
 
 #include "vector.h"
+#include "gravitymodel.h"
+#include "shapemodel.h"
 
 #include <boost/tuple/tuple.hpp>
 
-class Asteroid {
+class Asteroid : public GravityModel, public ShapeModel {
     /*
      * This class represents the dynamics and gravity of an asteroid shaped as a rigid ellipsoid having different
      * rotational properties along its three principal inertia axis (Ix, Iy, Iz).
@@ -20,6 +22,9 @@ class Asteroid {
      * Implementation for the gravity is largely inspired from Dario Cersosimo EVALUATION OF NOVEL HOVERING STRATEGIES TO IMPROVE GRAVITY-TRACTOR DEFLECTION MERITS paragraph 3.2.2.
      *
      * Implementation for the nearest point on the surface is largely ported from David Eberly "Distance from a Point to an Ellipse, an Ellipsoid, or a Hyperellipsoid".
+     *
+     * The ellipsoid is the default GravityModel and ShapeModel, other models (e.g. PolyhedronGravity) can replace it in
+     * ODESystem, PhysicsSnapshot and SensorSimulator while the asteroid keeps providing the rotation.
 */
 public:
     Asteroid();
@@ -29,13 +34,16 @@ public:
     Asteroid(const Vector3D &semi_axis, const double &density, const Vector2D &angular_velocity_xz, const double &time_bias);
 
     // Computes the gravity components in asteroid centered RF at an outside point "position" which is also in asteroid centered RF
-    Vector3D GravityAccelerationAtPosition(const Vector3D &position) const;
+    virtual Vector3D GravityAccelerationAtPosition(const Vector3D &position) const;
 
     // Computes w ("velocity") and d/dt ("acceleration") w of the asteroid rotating RF at time "time"
     boost::tuple<Vector3D, Vector3D> AngularVelocityAndAccelerationAtTime(const double &time) const;
 
     // Computes the distance "distance" and orthogonal projection of a position "position" outside the asteroid onto the asteroid's surface "point" in asteroid centered RF
-    boost::tuple<Vector3D, double> NearestPointOnSurfaceToPosition(const Vector3D &position) const;
+    virtual boost::tuple<Vector3D, double> NearestPointOnSurfaceToPosition(const Vector3D &position) const;
+
+    // Returns true if x^2/a^2 + y^2/b^2 + z^2/c^2 < 1 for position "position"
+    virtual bool PositionIsInside(const Vector3D &position) const;
 
     // Computes "Latitude" and "Longitude" for cartesian coordinates [x,y,z] which have to belong to the asteroid's surface
     boost::tuple<double, double> LatitudeAndLongitudeAtPosition(const Vector3D &position) const;
@@ -0,0 +1,84 @@
+#include "asteroidcache.h"
+#include "samplefactory.h"
+#include "constants.h"
+#include "configuration.h"
+
+std::mutex AsteroidCache::mutex_;
+unsigned int AsteroidCache::capacity_ = ASTC_CAPACITY;
+std::map<AsteroidCache::Key, boost::shared_ptr<const Asteroid> > AsteroidCache::asteroids_;
+std::deque<AsteroidCache::Key> AsteroidCache::insertion_order_;
+
+AsteroidCache::AsteroidParameters AsteroidCache::SampleAsteroidParameters(const unsigned int &random_seed) {
+    SampleFactory asteroid_sf(random_seed);
+
+    const double c_semi_axis = asteroid_sf.SampleUniformReal(100.0, 8000.0);
+    const double b_semi_axis_n = asteroid_sf.SampleUniformReal(1.1, 2.0);
+    const double a_semi_axis_n = asteroid_sf.SampleUniformReal(1.1 * b_semi_axis_n, 4.0);
+    const Vector3D &semi_axis = {a_semi_axis_n * c_semi_axis, b_semi_axis_n * c_semi_axis, c_semi_axis};
+    const double density = asteroid_sf.SampleUniformReal(1500.0, 3000.0);
+    const double magn_angular_velocity = 0.85 * sqrt((kGravitationalConstant * 4.0/3.0 * kPi * semi_axis[0] * semi_axis[1] * semi_axis[2] * density) / (semi_axis[0] * semi_axis[0] * semi_axis[0]));
+    const Vector2D &angular_velocity_xz = {asteroid_sf.SampleSign() * asteroid_sf.SampleUniformReal(magn_angular_velocity * 0.5, magn_angular_velocity), asteroid_sf.SampleSign() * asteroid_sf.SampleUniformReal(magn_angular_velocity * 0.5, magn_angular_velocity)};
+    const double time_bias = asteroid_sf.SampleUniformReal(0.0, 12.0 * 60 * 60);
+
+    return boost::make_tuple(semi_axis, density, angular_velocity_xz, time_bias);
+}
+
+boost::shared_ptr<const Asteroid> AsteroidCache::AsteroidWithParameters(const AsteroidParameters &asteroid_parameters) {
+    const Vector3D &semi_axis = boost::get<0>(asteroid_parameters);
+    const double &density = boost::get<1>(asteroid_parameters);
+    const Vector2D &angular_velocity_xz = boost::get<2>(asteroid_parameters);
+    const double &time_bias = boost::get<3>(asteroid_parameters);
+    const Key key = {semi_axis[0], semi_axis[1], semi_axis[2], density, angular_velocity_xz[0], angular_velocity_xz[1], time_bias};
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::map<Key, boost::shared_ptr<const Asteroid> >::const_iterator it = asteroids_.find(key);
+        if (it != asteroids_.end()) {
+            return it->second;
+        }
+    }
+
+    // construct outside of the lock, concurrent misses on the same key build equal asteroids
+    const boost::shared_ptr<const Asteroid> asteroid(new Asteroid(semi_axis, density, angular_velocity_xz, time_bias));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::pair<std::map<Key, boost::shared_ptr<const Asteroid> >::iterator, bool> result = asteroids_.insert(std::make_pair(key, asteroid));
+    if (result.second) {
+        insertion_order_.push_back(key);
+        Shrink();
+    }
+    return result.first->second;
+}
+
+boost::shared_ptr<const Asteroid> AsteroidCache::AsteroidForSeed(const unsigned int &random_seed) {
+    return AsteroidWithParameters(SampleAsteroidParameters(random_seed));
+}
+
+unsigned int AsteroidCache::Capacity() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+void AsteroidCache::SetCapacity(const unsigned int &capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    Shrink();
+}
+
+unsigned int AsteroidCache::Size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return asteroids_.size();
+}
+
+void AsteroidCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    asteroids_.clear();
+    insertion_order_.clear();
+}
+
+void AsteroidCache::Shrink() {
+    while (asteroids_.size() > capacity_) {
+        asteroids_.erase(insertion_order_.front());
+        insertion_order_.pop_front();
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef ASTEROIDCACHE_H
+#define ASTEROIDCACHE_H
+
+#include "vector.h"
+#include "asteroid.h"
+
+#include <boost/array.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include <deque>
+#include <map>
+#include <mutex>
+
+class AsteroidCache {
+    /*
+    * This class shares constructed asteroids between simulations. Asteroids are keyed by their physical parameters
+    * (semi axis, density, angular velocity in x and z, time bias), so every simulation, target position and initial
+    * spacecraft state using the same asteroid parameters works with the same instance and its precomputed values.
+    * The cache is thread safe and holds at most Capacity() asteroids, the oldest entry is dropped first. Simulations
+    * keep their asteroid alive on their own, dropping an entry never invalidates a returned asteroid.
+    */
+public:
+    // The physical parameters of an asteroid (semi_axis, density, angular_velocity_xz, time_bias)
+    typedef boost::tuple<Vector3D, double, Vector2D, double> AsteroidParameters;
+
+    // Samples the asteroid parameters every simulation derives from seed "random_seed"
+    static AsteroidParameters SampleAsteroidParameters(const unsigned int &random_seed);
+
+    // Returns the asteroid with parameters "asteroid_parameters", it gets constructed if it is not cached
+    static boost::shared_ptr<const Asteroid> AsteroidWithParameters(const AsteroidParameters &asteroid_parameters);
+
+    // Returns the asteroid sampled from seed "random_seed"
+    static boost::shared_ptr<const Asteroid> AsteroidForSeed(const unsigned int &random_seed);
+
+    // Returns the maximum number of cached asteroids
+    static unsigned int Capacity();
+
+    // Sets the maximum number of cached asteroids and drops the oldest ones if needed
+    static void SetCapacity(const unsigned int &capacity);
+
+    // Returns the number of cached asteroids
+    static unsigned int Size();
+
+    // Drops all cached asteroids
+    static void Clear();
+
+private:
+    // semi_axis[0..2], density, angular_velocity_xz[0..1], time_bias
+    typedef boost::array<double, 7> Key;
+
+    // Drops the oldest entries until the cache fits into capacity_, lock has to be held
+    static void Shrink();
+
+    // Guards all members below
+    static std::mutex mutex_;
+
+    // Maximum number of cached asteroids
+    static unsigned int capacity_;
+
+    // The cached asteroids
+    static std::map<Key, boost::shared_ptr<const Asteroid> > asteroids_;
+
+    // Keys in insertion order
+    static std::deque<Key> insertion_order_;
+};
+
+#endif // ASTEROIDCACHE_H
@@ -0,0 +1,69 @@
+#include "benchmarks.h"
+#include "vector.h"
+#include "samplefactory.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+static const unsigned int kNumBenchmarkInputs = 1024;
+
+// The fictitious accelerations as they were computed before VectorRotatingFrameAcceleration existed
+static Vector3D ComposedRotatingFrameAcceleration(const Vector3D &external_acceleration, const Vector3D &angular_velocity, const Vector3D &angular_acceleration, const Vector3D &position, const Vector3D &velocity) {
+    const Vector3D euler_acceleration = VectorCrossProduct(angular_acceleration, position);
+    const Vector3D centrifugal_acceleration = VectorCrossProduct(angular_velocity, VectorCrossProduct(angular_velocity, position));
+    const Vector3D coriolis_acceleration = VectorCrossProduct(VectorMul(2.0, angular_velocity), velocity);
+
+    Vector3D result;
+    for (unsigned int i = 0; i < 3; ++i) {
+        result[i] = external_acceleration[i]
+                - coriolis_acceleration[i]
+                - euler_acceleration[i]
+                - centrifugal_acceleration[i];
+    }
+    return result;
+}
+
+static std::vector<Vector3D> RandomVectors(SampleFactory &sample_factory, const double &scale) {
+    std::vector<Vector3D> vectors(kNumBenchmarkInputs);
+    for (unsigned int i = 0; i < kNumBenchmarkInputs; ++i) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            vectors[i][j] = sample_factory.SampleUniformReal(-scale, scale);
+        }
+    }
+    return vectors;
+}
+
+template <typename Kernel>
+static double TimeKernel(Kernel kernel, const unsigned int &num_evaluations, const std::vector<Vector3D> &external_accelerations, const std::vector<Vector3D> &angular_velocities, const std::vector<Vector3D> &angular_accelerations, const std::vector<Vector3D> &positions, const std::vector<Vector3D> &velocities, Vector3D &checksum) {
+    checksum = {0.0, 0.0, 0.0};
+    const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < num_evaluations; ++i) {
+        const unsigned int k = i % kNumBenchmarkInputs;
+        const Vector3D result = kernel(external_accelerations[k], angular_velocities[k], angular_accelerations[k], positions[k], velocities[k]);
+        for (unsigned int j = 0; j < 3; ++j) {
+            checksum[j] += result[j];
+        }
+    }
+    const std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / num_evaluations;
+}
+
+void BenchmarkVectorKernels(const unsigned int &num_evaluations) {
+    SampleFactory sample_factory(0);
+    const std::vector<Vector3D> external_accelerations = RandomVectors(sample_factory, 1e-3);
+    const std::vector<Vector3D> angular_velocities = RandomVectors(sample_factory, 1e-3);
+    const std::vector<Vector3D> angular_accelerations = RandomVectors(sample_factory, 1e-7);
+    const std::vector<Vector3D> positions = RandomVectors(sample_factory, 1e4);
+    const std::vector<Vector3D> velocities = RandomVectors(sample_factory, 1.0);
+
+    Vector3D checksum_composed;
+    Vector3D checksum_fused;
+    const double ns_composed = TimeKernel(ComposedRotatingFrameAcceleration, num_evaluations, external_accelerations, angular_velocities, angular_accelerations, positions, velocities, checksum_composed);
+    const double ns_fused = TimeKernel(VectorRotatingFrameAcceleration, num_evaluations, external_accelerations, angular_velocities, angular_accelerations, positions, velocities, checksum_fused);
+
+    std::cout << "Rotating frame acceleration (" << num_evaluations << " evaluations)" << std::endl;
+    std::cout << "   composed: " << ns_composed << " ns/op, checksum " << VectorToString(checksum_composed) << std::endl;
+    std::cout << "   fused:    " << ns_fused << " ns/op, checksum " << VectorToString(checksum_fused) << std::endl;
+    std::cout << "   speedup:  " << ns_composed / ns_fused << std::endl;
+}
@@ -0,0 +1,7 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+// Times the rotating frame acceleration composed of VectorCrossProduct calls against the fused vector kernel
+void BenchmarkVectorKernels(const unsigned int &num_evaluations=10000000);
+
+#endif // BENCHMARKS_H
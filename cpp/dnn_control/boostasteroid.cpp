@@ -1,7 +1,34 @@
 #include "boostasteroid.h"
 #include "vector.h"
+#include "boosttrajectorypropagator.h"
+#include "scopedgilrelease.h"
+
 #include <iostream>
 
+// Returns "values" as a C contiguous float64 array, which is "values" itself if it already is one
+static np::ndarray ContiguousDoubleArray(const bp::object &values) {
+    const bp::object numpy = bp::import("numpy");
+    return bp::extract<np::ndarray>(numpy.attr("ascontiguousarray")(values, numpy.attr("float64")));
+}
+
+// Returns "positions" as a C contiguous float64 array of shape (N, 3)
+static np::ndarray PositionArray(const bp::object &positions) {
+    np::ndarray positions_py = ContiguousDoubleArray(positions);
+    if (positions_py.get_nd() != 2 || positions_py.shape(1) != 3) {
+        PyErr_SetString(PyExc_ValueError, "positions must have shape (N, 3)");
+        bp::throw_error_already_set();
+    }
+    return positions_py;
+}
+
+// Returns a new uninitialized float64 array of shape (rows, columns), or (rows,) if columns is 0
+static np::ndarray EmptyArray(const unsigned int &rows, const unsigned int &columns) {
+    if (columns == 0) {
+        return np::empty(bp::make_tuple(rows), np::dtype::get_builtin<double>());
+    }
+    return np::empty(bp::make_tuple(rows, columns), np::dtype::get_builtin<double>());
+}
+
 BoostAsteroid::BoostAsteroid(const bp::list &semi_axis, const double &density, const bp::list &angular_velocity_xz, const double &time_bias) {
     const Vector3D semi_axis_cpp = {bp::extract<double>(semi_axis[0]),
         bp::extract<double>(semi_axis[1]),
@@ -11,9 +38,11 @@ BoostAsteroid::BoostAsteroid(const bp::list &semi_axis, const double &density, c
         bp::extract<double>(angular_velocity_xz[1])};
 
     asteroid_cpp_ = new Asteroid(semi_axis_cpp, density, angular_velocity_cpp_xz, time_bias);
+    surface_geometry_cpp_ = new SurfaceGeometry(*asteroid_cpp_);
 }
 
 BoostAsteroid::~BoostAsteroid() {
+    delete surface_geometry_cpp_;
     delete asteroid_cpp_;
 }
 
@@ -103,13 +132,174 @@ bp::list BoostAsteroid::IntersectLineToCenterFromPosition(const bp::list &positi
     return surface_point_py;
 }
 
+np::ndarray BoostAsteroid::GravityAccelerationAtPositions(const bp::object &positions) const {
+    const np::ndarray positions_py = PositionArray(positions);
+    const unsigned int num_positions = positions_py.shape(0);
+    np::ndarray gravities_py = EmptyArray(num_positions, 3);
+
+    const double *positions_cpp = reinterpret_cast<const double*>(positions_py.get_data());
+    double *gravities_cpp = reinterpret_cast<double*>(gravities_py.get_data());
+    {
+        ScopedGILRelease gil_release;
+        for (unsigned int i = 0; i < num_positions; ++i) {
+            const Vector3D position = {positions_cpp[3 * i], positions_cpp[3 * i + 1], positions_cpp[3 * i + 2]};
+            const Vector3D gravity = asteroid_cpp_->GravityAccelerationAtPosition(position);
+            for (unsigned int j = 0; j < 3; ++j) {
+                gravities_cpp[3 * i + j] = gravity[j];
+            }
+        }
+    }
+
+    return gravities_py;
+}
+
+bp::tuple BoostAsteroid::AngularVelocityAndAccelerationAtTimes(const bp::object &times) const {
+    const np::ndarray times_py = ContiguousDoubleArray(times);
+    if (times_py.get_nd() != 1) {
+        PyErr_SetString(PyExc_ValueError, "times must have shape (N,)");
+        bp::throw_error_already_set();
+    }
+    const unsigned int num_times = times_py.shape(0);
+    np::ndarray angular_velocities_py = EmptyArray(num_times, 3);
+    np::ndarray angular_accelerations_py = EmptyArray(num_times, 3);
+
+    const double *times_cpp = reinterpret_cast<const double*>(times_py.get_data());
+    double *angular_velocities_cpp = reinterpret_cast<double*>(angular_velocities_py.get_data());
+    double *angular_accelerations_cpp = reinterpret_cast<double*>(angular_accelerations_py.get_data());
+    {
+        ScopedGILRelease gil_release;
+        for (unsigned int i = 0; i < num_times; ++i) {
+            const boost::tuple<Vector3D, Vector3D> result = asteroid_cpp_->AngularVelocityAndAccelerationAtTime(times_cpp[i]);
+            const Vector3D &angular_velocity = boost::get<0>(result);
+            const Vector3D &angular_acceleration = boost::get<1>(result);
+            for (unsigned int j = 0; j < 3; ++j) {
+                angular_velocities_cpp[3 * i + j] = angular_velocity[j];
+                angular_accelerations_cpp[3 * i + j] = angular_acceleration[j];
+            }
+        }
+    }
+
+    return bp::make_tuple(angular_velocities_py, angular_accelerations_py);
+}
+
+bp::tuple BoostAsteroid::NearestPointsOnSurfaceToPositions(const bp::object &positions) const {
+    const np::ndarray positions_py = PositionArray(positions);
+    const unsigned int num_positions = positions_py.shape(0);
+    np::ndarray surface_points_py = EmptyArray(num_positions, 3);
+    np::ndarray distances_py = EmptyArray(num_positions, 0);
+
+    const double *positions_cpp = reinterpret_cast<const double*>(positions_py.get_data());
+    double *surface_points_cpp = reinterpret_cast<double*>(surface_points_py.get_data());
+    double *distances_cpp = reinterpret_cast<double*>(distances_py.get_data());
+    {
+        ScopedGILRelease gil_release;
+        for (unsigned int i = 0; i < num_positions; ++i) {
+            const Vector3D position = {positions_cpp[3 * i], positions_cpp[3 * i + 1], positions_cpp[3 * i + 2]};
+            const boost::tuple<Vector3D, double> result = surface_geometry_cpp_->NearestPointOnSurfaceToPosition(position);
+            const Vector3D &surface_point = boost::get<0>(result);
+            for (unsigned int j = 0; j < 3; ++j) {
+                surface_points_cpp[3 * i + j] = surface_point[j];
+            }
+            distances_cpp[i] = boost::get<1>(result);
+        }
+    }
+
+    return bp::make_tuple(surface_points_py, distances_py);
+}
+
+bp::tuple BoostAsteroid::LatitudesAndLongitudesAtPositions(const bp::object &positions) const {
+    const np::ndarray positions_py = PositionArray(positions);
+    const unsigned int num_positions = positions_py.shape(0);
+    np::ndarray latitudes_py = EmptyArray(num_positions, 0);
+    np::ndarray longitudes_py = EmptyArray(num_positions, 0);
+
+    const double *positions_cpp = reinterpret_cast<const double*>(positions_py.get_data());
+    double *latitudes_cpp = reinterpret_cast<double*>(latitudes_py.get_data());
+    double *longitudes_cpp = reinterpret_cast<double*>(longitudes_py.get_data());
+    {
+        ScopedGILRelease gil_release;
+        for (unsigned int i = 0; i < num_positions; ++i) {
+            const Vector3D position = {positions_cpp[3 * i], positions_cpp[3 * i + 1], positions_cpp[3 * i + 2]};
+            const boost::tuple<double, double> result = asteroid_cpp_->LatitudeAndLongitudeAtPosition(position);
+            latitudes_cpp[i] = boost::get<0>(result);
+            longitudes_cpp[i] = boost::get<1>(result);
+        }
+    }
+
+    return bp::make_tuple(latitudes_py, longitudes_py);
+}
+
+np::ndarray BoostAsteroid::IntersectLinesToCenterFromPositions(const bp::object &positions) const {
+    const np::ndarray positions_py = PositionArray(positions);
+    const unsigned int num_positions = positions_py.shape(0);
+    np::ndarray surface_points_py = EmptyArray(num_positions, 3);
+
+    const double *positions_cpp = reinterpret_cast<const double*>(positions_py.get_data());
+    double *surface_points_cpp = reinterpret_cast<double*>(surface_points_py.get_data());
+    {
+        ScopedGILRelease gil_release;
+        for (unsigned int i = 0; i < num_positions; ++i) {
+            const Vector3D position = {positions_cpp[3 * i], positions_cpp[3 * i + 1], positions_cpp[3 * i + 2]};
+            const Vector3D surface_point = asteroid_cpp_->IntersectLineToCenterFromPosition(position);
+            for (unsigned int j = 0; j < 3; ++j) {
+                surface_points_cpp[3 * i + j] = surface_point[j];
+            }
+        }
+    }
+
+    return surface_points_py;
+}
+
+np::ndarray BoostAsteroid::PositionsAtLatitudesAndLongitudes(const bp::object &latitudes, const bp::object &longitudes) const {
+    const np::ndarray latitudes_py = ContiguousDoubleArray(latitudes);
+    const np::ndarray longitudes_py = ContiguousDoubleArray(longitudes);
+    if (latitudes_py.get_nd() != 1 || longitudes_py.get_nd() != 1 || latitudes_py.shape(0) != longitudes_py.shape(0)) {
+        PyErr_SetString(PyExc_ValueError, "latitudes and longitudes must have shape (N,)");
+        bp::throw_error_already_set();
+    }
+    const unsigned int num_positions = latitudes_py.shape(0);
+    np::ndarray positions_py = EmptyArray(num_positions, 3);
+
+    const double *latitudes_cpp = reinterpret_cast<const double*>(latitudes_py.get_data());
+    const double *longitudes_cpp = reinterpret_cast<const double*>(longitudes_py.get_data());
+    double *positions_cpp = reinterpret_cast<double*>(positions_py.get_data());
+    {
+        ScopedGILRelease gil_release;
+        for (unsigned int i = 0; i < num_positions; ++i) {
+            const Vector3D position = surface_geometry_cpp_->PositionAtLatitudeAndLongitude(latitudes_cpp[i], longitudes_cpp[i]);
+            for (unsigned int j = 0; j < 3; ++j) {
+                positions_cpp[3 * i + j] = position[j];
+            }
+        }
+    }
+
+    return positions_py;
+}
+
 double BoostAsteroid::AngularVelocityPeriod() const {
     return asteroid_cpp_->AngularVelocityPeriod();
 }
 
+const Asteroid& BoostAsteroid::AsteroidCpp() const {
+    return *asteroid_cpp_;
+}
+
+static void TranslatePositionInsideException(const Asteroid::PositionInsideException &exception) {
+    PyErr_SetString(PyExc_ValueError, "position inside the asteroid");
+}
+
+static void TranslateAsteroidException(const Asteroid::Exception &exception) {
+    PyErr_SetString(PyExc_ValueError, "invalid asteroid parameters or position");
+}
+
 BOOST_PYTHON_MODULE(boost_asteroid)
 {
-    bp::class_<BoostAsteroid>("BoostAsteroid", bp::init<const bp::list &, const double &, const bp::list &, const double &>())
+    np::initialize();
+
+    bp::register_exception_translator<Asteroid::Exception>(&TranslateAsteroidException);
+    bp::register_exception_translator<Asteroid::PositionInsideException>(&TranslatePositionInsideException);
+
+    bp::class_<BoostAsteroid, boost::noncopyable>("BoostAsteroid", bp::init<const bp::list &, const double &, const bp::list &, const double &>())
             .def("gravity_acceleration_at_position", &BoostAsteroid::GravityAccelerationAtPosition)
             .def("angular_velocity_and_acceleration_at_time", &BoostAsteroid::AngularVelocityAndAccelerationAtTime)
             .def("nearest_point_on_surface_to_position", &BoostAsteroid::NearestPointOnSurfaceToPosition)
@@ -117,6 +307,14 @@ BOOST_PYTHON_MODULE(boost_asteroid)
             .def("semi_axis", &BoostAsteroid::SemiAxis)
             .def("intersect_line_to_center_from_position", &BoostAsteroid::IntersectLineToCenterFromPosition)
             .def("angular_velocity_period", &BoostAsteroid::AngularVelocityPeriod)
+            .def("gravity_acceleration_at_positions", &BoostAsteroid::GravityAccelerationAtPositions)
+            .def("angular_velocity_and_acceleration_at_times", &BoostAsteroid::AngularVelocityAndAccelerationAtTimes)
+            .def("nearest_points_on_surface_to_positions", &BoostAsteroid::NearestPointsOnSurfaceToPositions)
+            .def("latitudes_and_longitudes_at_positions", &BoostAsteroid::LatitudesAndLongitudesAtPositions)
+            .def("intersect_lines_to_center_from_positions", &BoostAsteroid::IntersectLinesToCenterFromPositions)
+            .def("positions_at_latitudes_and_longitudes", &BoostAsteroid::PositionsAtLatitudesAndLongitudes)
             ;
+
+    ExportBoostTrajectoryPropagator();
 }
 
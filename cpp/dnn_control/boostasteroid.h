@@ -1,9 +1,15 @@
+#ifndef BOOSTASTEROID_H
+#define BOOSTASTEROID_H
+
 #include "asteroid.h"
+#include "surfacegeometry.h"
 
 #include <boost/tuple/tuple.hpp>
 #include <boost/python.hpp>
+#include <boost/python/numpy.hpp>
 
 namespace bp = boost::python;
+namespace np = boost::python::numpy;
 
 class BoostAsteroid {
 public:
@@ -20,11 +26,35 @@ public:
     
     bp::list IntersectLineToCenterFromPosition(const bp::list &position) const;
 
+    // Batched versions of the above: "positions" is anything convertible to a float64 array of shape (N, 3), "times" of
+    // shape (N,). The loops run in C++ without the global interpreter lock, the results are new arrays of N rows.
+
+    np::ndarray GravityAccelerationAtPositions(const bp::object &positions) const;
+
+    bp::tuple AngularVelocityAndAccelerationAtTimes(const bp::object &times) const;
+
+    bp::tuple NearestPointsOnSurfaceToPositions(const bp::object &positions) const;
+
+    bp::tuple LatitudesAndLongitudesAtPositions(const bp::object &positions) const;
+
+    np::ndarray IntersectLinesToCenterFromPositions(const bp::object &positions) const;
+
+    // Inverse of latitudes_and_longitudes_at_positions: surface points (N, 3) of latitudes (N,) and longitudes (N,)
+    np::ndarray PositionsAtLatitudesAndLongitudes(const bp::object &latitudes, const bp::object &longitudes) const;
+
     bp::list SemiAxis() const;
 
     double AngularVelocityPeriod() const;
 
+    // The wrapped cpp Asteroid
+    const Asteroid& AsteroidCpp() const;
+
 private:
     // cpp Asteroid
     Asteroid *asteroid_cpp_;
+
+    // Surface queries of asteroid_cpp_
+    SurfaceGeometry *surface_geometry_cpp_;
 };
+
+#endif // BOOSTASTEROID_H
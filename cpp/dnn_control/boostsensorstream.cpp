@@ -0,0 +1,138 @@
+#include "boostsensorstream.h"
+
+#include "scopedgilrelease.h"
+
+#include <vector>
+
+// Returns the column indexes in "indexes" or all "num_columns" columns if it is None
+static std::vector<unsigned int> ColumnsOfIndexes(const bp::object &indexes, const unsigned int &num_columns) {
+    std::vector<unsigned int> columns;
+    if (indexes.is_none()) {
+        for (unsigned int i = 0; i < num_columns; ++i) {
+            columns.push_back(i);
+        }
+    } else {
+        const unsigned int num_indexes = bp::len(indexes);
+        for (unsigned int i = 0; i < num_indexes; ++i) {
+            columns.push_back(bp::extract<unsigned int>(indexes[i]));
+        }
+    }
+    return columns;
+}
+
+// A read only array of shape (rows, columns) viewing "data", kept alive by "owner"
+static np::ndarray View(const double *data, const unsigned int &rows, const unsigned int &columns, const bp::object &owner) {
+    return np::from_data(data, np::dtype::get_builtin<double>(), bp::make_tuple(rows, columns), bp::make_tuple(columns * sizeof(double), sizeof(double)), owner);
+}
+
+BoostSensorStream::BoostSensorStream(const std::string &path_to_file, const unsigned int &num_lines) {
+    ScopedGILRelease release;
+    stream_cpp_ = SensorStream::FromTextFile(path_to_file, num_lines);
+}
+
+BoostSensorStream::BoostSensorStream(const boost::shared_ptr<SensorStream> &stream)
+    : stream_cpp_(stream) {
+
+}
+
+BoostSensorStream::~BoostSensorStream() {
+
+}
+
+BoostSensorStream BoostSensorStream::FromShardFile(const std::string &path_to_file, const unsigned long long &offset) {
+    return BoostSensorStream(SensorStream::FromShardFile(path_to_file, offset));
+}
+
+unsigned int BoostSensorStream::NumRows() const {
+    return stream_cpp_->NumRows();
+}
+
+unsigned int BoostSensorStream::Dimensions() const {
+    return stream_cpp_->Dimensions();
+}
+
+unsigned int BoostSensorStream::Columns() const {
+    return stream_cpp_->Columns();
+}
+
+np::ndarray BoostSensorStream::SensorData(const bp::object &self) {
+    const SensorStream &stream = *bp::extract<const BoostSensorStream&>(self)().stream_cpp_;
+    return View(stream.SensorData(), stream.NumRows(), stream.Dimensions(), self);
+}
+
+np::ndarray BoostSensorStream::Thrusts(const bp::object &self) {
+    const SensorStream &stream = *bp::extract<const BoostSensorStream&>(self)().stream_cpp_;
+    return View(stream.Thrusts(), stream.NumRows(), 3, self);
+}
+
+bp::tuple BoostSensorStream::Windows(const unsigned int &sequence_length, const bp::object &feature_indexes, const bp::object &label_indexes, const unsigned int &stride) const {
+    bp::list streams;
+    streams.append(*this);
+    return WindowsOfStreams(streams, sequence_length, feature_indexes, label_indexes, stride);
+}
+
+bp::tuple BoostSensorStream::WindowsOfStreams(const bp::list &streams, const unsigned int &sequence_length, const bp::object &feature_indexes, const bp::object &label_indexes, const unsigned int &stride) {
+    const unsigned int num_streams = bp::len(streams);
+    std::vector<boost::shared_ptr<SensorStream> > streams_cpp;
+    for (unsigned int i = 0; i < num_streams; ++i) {
+        streams_cpp.push_back(bp::extract<const BoostSensorStream&>(streams[i])().stream_cpp_);
+    }
+
+    const unsigned int num_columns = (num_streams > 0 ? streams_cpp.front()->Columns() : 0);
+    const std::vector<unsigned int> feature_columns = ColumnsOfIndexes(feature_indexes, num_columns);
+    const std::vector<unsigned int> label_columns = ColumnsOfIndexes(label_indexes, num_columns);
+
+    unsigned int num_windows = 0;
+    for (unsigned int i = 0; i < num_streams; ++i) {
+        num_windows += streams_cpp.at(i)->NumWindows(sequence_length, stride);
+    }
+
+    // the windows are written straight into the arrays' memory
+    const unsigned int window_size = sequence_length * feature_columns.size();
+    np::ndarray features = np::empty(bp::make_tuple(num_windows, window_size), np::dtype::get_builtin<double>());
+    np::ndarray labels = np::empty(bp::make_tuple(num_windows, label_columns.size()), np::dtype::get_builtin<double>());
+    double *features_data = reinterpret_cast<double*>(features.get_data());
+    double *labels_data = reinterpret_cast<double*>(labels.get_data());
+
+    {
+        ScopedGILRelease release;
+        for (unsigned int i = 0; i < num_streams; ++i) {
+            const SensorStream &stream = *streams_cpp.at(i);
+            stream.MaterializeWindows(sequence_length, feature_columns, label_columns, stride, features_data, labels_data);
+
+            const unsigned int stream_windows = stream.NumWindows(sequence_length, stride);
+            features_data += static_cast<unsigned long long>(stream_windows) * window_size;
+            labels_data += static_cast<unsigned long long>(stream_windows) * label_columns.size();
+        }
+    }
+
+    return bp::make_tuple(features, labels);
+}
+
+static void TranslateSensorStreamException(const SensorStream::Exception &exception) {
+    PyErr_SetString(PyExc_ValueError, "invalid sensor stream file, column or stride");
+}
+
+static void TranslateFileNotReadableException(const SensorStream::FileNotReadableException &exception) {
+    PyErr_SetString(PyExc_IOError, "sensor stream file not readable");
+}
+
+BOOST_PYTHON_MODULE(boost_sensor_stream)
+{
+    np::initialize();
+
+    bp::register_exception_translator<SensorStream::Exception>(&TranslateSensorStreamException);
+    bp::register_exception_translator<SensorStream::FileNotReadableException>(&TranslateFileNotReadableException);
+
+    bp::class_<BoostSensorStream>("BoostSensorStream", bp::init<const std::string &, bp::optional<const unsigned int &> >())
+            .def("num_rows", &BoostSensorStream::NumRows)
+            .def("dimensions", &BoostSensorStream::Dimensions)
+            .def("columns", &BoostSensorStream::Columns)
+            .def("sensor_data", &BoostSensorStream::SensorData)
+            .def("thrusts", &BoostSensorStream::Thrusts)
+            .def("windows", &BoostSensorStream::Windows, (bp::arg("sequence_length"), bp::arg("feature_indexes")=bp::object(), bp::arg("label_indexes")=bp::object(), bp::arg("stride")=1))
+            ;
+
+    bp::def("load_shard", &BoostSensorStream::FromShardFile);
+    bp::def("windows", &BoostSensorStream::WindowsOfStreams, (bp::arg("streams"), bp::arg("sequence_length"), bp::arg("feature_indexes")=bp::object(), bp::arg("label_indexes")=bp::object(), bp::arg("stride")=1));
+}
@@ -0,0 +1,39 @@
+#include "sensorstream.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/python.hpp>
+#include <boost/python/numpy.hpp>
+
+namespace bp = boost::python;
+namespace np = boost::python::numpy;
+
+class BoostSensorStream {
+public:
+    // Loads the first "num_lines" rows (0 for all) of a sensor stream text file
+    BoostSensorStream(const std::string &path_to_file, const unsigned int &num_lines=0);
+    BoostSensorStream(const boost::shared_ptr<SensorStream> &stream);
+    ~BoostSensorStream();
+
+    // Maps the data set at byte "offset" of a shard file
+    static BoostSensorStream FromShardFile(const std::string &path_to_file, const unsigned long long &offset);
+
+    unsigned int NumRows() const;
+
+    unsigned int Dimensions() const;
+
+    unsigned int Columns() const;
+
+    // Read only arrays viewing the stream's memory, they keep the stream "self" alive
+    static np::ndarray SensorData(const bp::object &self);
+    static np::ndarray Thrusts(const bp::object &self);
+
+    // Sliding window design matrix and labels of this stream
+    bp::tuple Windows(const unsigned int &sequence_length, const bp::object &feature_indexes, const bp::object &label_indexes, const unsigned int &stride) const;
+
+    // Sliding window design matrix and labels of several streams, concatenated
+    static bp::tuple WindowsOfStreams(const bp::list &streams, const unsigned int &sequence_length, const bp::object &feature_indexes, const bp::object &label_indexes, const unsigned int &stride);
+
+private:
+    // cpp SensorStream
+    boost::shared_ptr<SensorStream> stream_cpp_;
+};
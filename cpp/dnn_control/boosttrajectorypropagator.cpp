@@ -0,0 +1,146 @@
+#include "boosttrajectorypropagator.h"
+#include "scopedgilrelease.h"
+
+// Returns "values" as a C contiguous float64 array with "columns" columns (0 for a vector), throws ValueError otherwise
+static np::ndarray DoubleArray(const bp::object &values, const unsigned int &columns, const char *error_message) {
+    const bp::object numpy = bp::import("numpy");
+    np::ndarray array = bp::extract<np::ndarray>(numpy.attr("ascontiguousarray")(values, numpy.attr("float64")));
+    const bool valid = (columns == 0 ? array.get_nd() == 1 : array.get_nd() == 2 && array.shape(1) == static_cast<Py_intptr_t>(columns));
+    if (!valid) {
+        PyErr_SetString(PyExc_ValueError, error_message);
+        bp::throw_error_already_set();
+    }
+    return array;
+}
+
+// Copies the rows of "array" into "values"
+template <typename T>
+static void RowsOfArray(const np::ndarray &array, std::vector<T> &values) {
+    const double *data = reinterpret_cast<const double*>(array.get_data());
+    const unsigned int num_columns = T().size();
+    values.resize(array.shape(0));
+    for (unsigned int i = 0; i < values.size(); ++i) {
+        for (unsigned int j = 0; j < num_columns; ++j) {
+            values[i][j] = data[i * num_columns + j];
+        }
+    }
+}
+
+// Returns a new (rows.size(), T::size()) float64 array of "rows"
+template <typename T>
+static np::ndarray ArrayOfRows(const std::vector<T> &rows) {
+    const unsigned int num_columns = T().size();
+    np::ndarray array = np::empty(bp::make_tuple(rows.size(), num_columns), np::dtype::get_builtin<double>());
+    double *data = reinterpret_cast<double*>(array.get_data());
+    for (unsigned int i = 0; i < rows.size(); ++i) {
+        for (unsigned int j = 0; j < num_columns; ++j) {
+            data[i * num_columns + j] = rows[i][j];
+        }
+    }
+    return array;
+}
+
+BoostTrajectoryPropagator::BoostTrajectoryPropagator(const bp::object &asteroid, const double &spacecraft_specific_impulse, const double &spacecraft_minimum_mass, const bool &fuel_usage_enabled, const double &minimum_step_size)
+    : asteroid_(asteroid) {
+    const BoostAsteroid &boost_asteroid = bp::extract<const BoostAsteroid&>(asteroid);
+    propagator_cpp_ = new TrajectoryPropagator(boost_asteroid.AsteroidCpp(), spacecraft_specific_impulse, spacecraft_minimum_mass, fuel_usage_enabled, minimum_step_size);
+}
+
+BoostTrajectoryPropagator::~BoostTrajectoryPropagator() {
+    delete propagator_cpp_;
+}
+
+bp::tuple BoostTrajectoryPropagator::Propagate(const bp::object &initial_system_state, const bp::object &times, const bp::object &thrusts) const {
+    const np::ndarray initial_system_state_py = DoubleArray(initial_system_state, 0, "initial state must have shape (7,)");
+    const np::ndarray times_py = DoubleArray(times, 0, "times must have shape (N,)");
+    const np::ndarray thrusts_py = DoubleArray(thrusts, 3, "thrusts must have shape (N - 1, 3) or (N, 3)");
+    if (initial_system_state_py.shape(0) != 7) {
+        PyErr_SetString(PyExc_ValueError, "initial state must have shape (7,)");
+        bp::throw_error_already_set();
+    }
+
+    SystemState initial_system_state_cpp;
+    const double *initial_system_state_data = reinterpret_cast<const double*>(initial_system_state_py.get_data());
+    std::copy(initial_system_state_data, initial_system_state_data + 7, initial_system_state_cpp.begin());
+
+    const double *times_data = reinterpret_cast<const double*>(times_py.get_data());
+    const std::vector<double> times_cpp(times_data, times_data + times_py.shape(0));
+
+    std::vector<Vector3D> thrusts_cpp;
+    RowsOfArray(thrusts_py, thrusts_cpp);
+
+    std::vector<SystemState> system_states;
+    std::vector<Quaternion> attitudes;
+    {
+        ScopedGILRelease gil_release;
+        propagator_cpp_->Propagate(initial_system_state_cpp, times_cpp, thrusts_cpp, system_states, attitudes);
+    }
+
+    return bp::make_tuple(ArrayOfRows(system_states), ArrayOfRows(attitudes));
+}
+
+np::ndarray BoostTrajectoryPropagator::Attitudes(const bp::object &times) const {
+    const np::ndarray times_py = DoubleArray(times, 0, "times must have shape (N,)");
+    const double *times_data = reinterpret_cast<const double*>(times_py.get_data());
+    const std::vector<double> times_cpp(times_data, times_data + times_py.shape(0));
+
+    std::vector<Quaternion> attitudes;
+    {
+        ScopedGILRelease gil_release;
+        propagator_cpp_->Attitudes(times_cpp, attitudes);
+    }
+
+    return ArrayOfRows(attitudes);
+}
+
+np::ndarray BoostTrajectoryPropagator::RotationMatrices(const bp::object &attitudes) {
+    const np::ndarray attitudes_py = DoubleArray(attitudes, 4, "attitudes must have shape (N, 4)");
+    std::vector<Quaternion> attitudes_cpp;
+    RowsOfArray(attitudes_py, attitudes_cpp);
+
+    np::ndarray rotations_py = np::empty(bp::make_tuple(attitudes_cpp.size(), 3, 3), np::dtype::get_builtin<double>());
+    double *rotations_data = reinterpret_cast<double*>(rotations_py.get_data());
+    for (unsigned int i = 0; i < attitudes_cpp.size(); ++i) {
+        const boost::array<double,9> rotation = TrajectoryPropagator::RotationMatrix(attitudes_cpp[i]);
+        std::copy(rotation.begin(), rotation.end(), rotations_data + 9 * i);
+    }
+
+    return rotations_py;
+}
+
+np::ndarray BoostTrajectoryPropagator::BodyToInertial(const bp::object &attitudes, const bp::object &vectors) {
+    const np::ndarray attitudes_py = DoubleArray(attitudes, 4, "attitudes must have shape (N, 4)");
+    const np::ndarray vectors_py = DoubleArray(vectors, 3, "vectors must have shape (N, 3)");
+    if (attitudes_py.shape(0) != vectors_py.shape(0)) {
+        PyErr_SetString(PyExc_ValueError, "attitudes and vectors must have the same number of rows");
+        bp::throw_error_already_set();
+    }
+
+    std::vector<Quaternion> attitudes_cpp;
+    RowsOfArray(attitudes_py, attitudes_cpp);
+    std::vector<Vector3D> vectors_cpp;
+    RowsOfArray(vectors_py, vectors_cpp);
+
+    for (unsigned int i = 0; i < vectors_cpp.size(); ++i) {
+        vectors_cpp[i] = TrajectoryPropagator::BodyToInertial(attitudes_cpp[i], vectors_cpp[i]);
+    }
+
+    return ArrayOfRows(vectors_cpp);
+}
+
+static void TranslateInvalidScheduleException(const TrajectoryPropagator::InvalidScheduleException &exception) {
+    PyErr_SetString(PyExc_ValueError, "times must be increasing and need one thrust per interval");
+}
+
+void ExportBoostTrajectoryPropagator() {
+    bp::register_exception_translator<TrajectoryPropagator::InvalidScheduleException>(&TranslateInvalidScheduleException);
+
+    bp::class_<BoostTrajectoryPropagator, boost::noncopyable>("TrajectoryPropagator", bp::init<const bp::object &, const double &, const double &, const bool &, bp::optional<const double &> >())
+            .def("propagate", &BoostTrajectoryPropagator::Propagate)
+            .def("attitudes", &BoostTrajectoryPropagator::Attitudes)
+            .def("rotation_matrices", &BoostTrajectoryPropagator::RotationMatrices)
+            .staticmethod("rotation_matrices")
+            .def("body_to_inertial", &BoostTrajectoryPropagator::BodyToInertial)
+            .staticmethod("body_to_inertial")
+            ;
+}
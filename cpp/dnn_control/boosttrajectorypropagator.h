@@ -0,0 +1,37 @@
+#ifndef BOOSTTRAJECTORYPROPAGATOR_H
+#define BOOSTTRAJECTORYPROPAGATOR_H
+
+#include "boostasteroid.h"
+#include "trajectorypropagator.h"
+
+class BoostTrajectoryPropagator {
+public:
+    // "asteroid" is a BoostAsteroid, it is kept alive by the propagator
+    BoostTrajectoryPropagator(const bp::object &asteroid, const double &spacecraft_specific_impulse, const double &spacecraft_minimum_mass, const bool &fuel_usage_enabled, const double &minimum_step_size=0.1);
+    ~BoostTrajectoryPropagator();
+
+    // Integrates initial state (7,) over times (N,) with thrusts (N - 1, 3) or (N, 3), the last row is unused.
+    // Returns (states (M, 7), attitudes (M, 4)) for the M <= N times reached before a crash or running out of fuel.
+    bp::tuple Propagate(const bp::object &initial_system_state, const bp::object &times, const bp::object &thrusts) const;
+
+    // Returns the asteroid's attitudes (N, 4) at times (N,)
+    np::ndarray Attitudes(const bp::object &times) const;
+
+    // Returns the body to inertial rotation matrices (N, 3, 3) of attitudes (N, 4)
+    static np::ndarray RotationMatrices(const bp::object &attitudes);
+
+    // Returns body frame vectors (N, 3) in the inertial frame of attitudes (N, 4)
+    static np::ndarray BodyToInertial(const bp::object &attitudes, const bp::object &vectors);
+
+private:
+    // The python BoostAsteroid, referenced by the cpp propagator
+    bp::object asteroid_;
+
+    // cpp TrajectoryPropagator
+    TrajectoryPropagator *propagator_cpp_;
+};
+
+// Registers BoostTrajectoryPropagator in the current module
+void ExportBoostTrajectoryPropagator();
+
+#endif // BOOSTTRAJECTORYPROPAGATOR_H
@@ -48,6 +48,10 @@
 #define ODES_ENABLE_FUEL   true
 
 
+// Class AsteroidCache configs
+#define ASTC_CAPACITY   10000
+
+
 // Class PaGMOSimulation configs
 #define PGMOS_IC_INERTIAL_ZERO_VELOCITY      0
 #define PGMOS_IC_INERTIAL_ORBITAL_VELOCITY   1
@@ -75,6 +79,41 @@
 #define LSPR_GAMMA  0.9
 #define LSPR_EPSILON 1e-10
 #define LSPR_WRITE_ACTION_SET_TO_FILE   true
+#define LSPR_NUM_THREADS    0
+#define LSPR_EVALUATION_LANE_SIZE   8
+#define LSPR_WRITE_SAMPLES_TO_FILE  false
+#define LSPR_REUSE_SAMPLES_FILE false
+#define LSPR_CHECKPOINT_EVERY_ITERATION true
+#define LSPR_RESUME_FROM_CHECKPOINT false
+
+#define LSPR_BASIS_QUADRATIC    0   // Quadratic features of state and thrust.
+#define LSPR_BASIS_RADIAL_BASIS_GRID    1   // Gaussian radial basis functions on a grid over the states, one block of weights per action.
+#define LSPR_BASIS_TILE_CODING  2   // Hashed tile coding of the states, one block of weights per action.
+
+#define LSPR_BASIS  LSPR_BASIS_QUADRATIC
+#define LSPR_BASIS_GRID_SIZE    3
+#define LSPR_BASIS_NUM_TILINGS  4
+#define LSPR_BASIS_MEMORY_SIZE  1024
+#define LSPR_BASIS_RIDGE    1e-6
+
+#define LSPR_ENGINE_LSPI    0   // Least squares policy iteration with the basis LSPR_BASIS.
+#define LSPR_ENGINE_FITTED_Q_ITERATION  1   // Fitted Q iteration with the regressor LSPR_FQI_REGRESSOR, for states no basis fits.
+
+#define LSPR_ENGINE LSPR_ENGINE_LSPI
+
+#define LSPR_FQI_REGRESSOR_NEAREST_NEIGHBORS    0   // Kernel weighted k nearest neighbors from a k-d tree.
+#define LSPR_FQI_REGRESSOR_NEURAL_NETWORK   1   // Feed forward neural network with one hidden layer.
+
+#define LSPR_FQI_REGRESSOR  LSPR_FQI_REGRESSOR_NEAREST_NEIGHBORS
+#define LSPR_FQI_MAX_ITERATIONS 100
+#define LSPR_FQI_NUM_CANDIDATE_ACTIONS  4
+#define LSPR_FQI_NUM_NEIGHBORS  8
+#define LSPR_FQI_BANDWIDTH  0.5
+#define LSPR_FQI_ERROR_BOUND    1.0
+#define LSPR_FQI_HIDDEN_UNITS   32
+#define LSPR_FQI_EPOCHS 1
+#define LSPR_FQI_BATCH_SIZE 256
+#define LSPR_FQI_LEARNING_RATE  1e-3
 
 // Other stuff configs, not relevant for simulation
 #define OUTPUT_ROOT_PATH   "/home/willist/Documents/dnn/"
@@ -90,6 +129,12 @@
 #define PATH_TO_LSPI_POST_EVALUATION_FILE   OUTPUT_ROOT_PATH "results/post_evaluation_lspi_" TASK_NAME ".txt"
 #define PATH_TO_LSPI_ACTION_SET_FILE    OUTPUT_ROOT_PATH "results/lspi_action_set_" TASK_NAME ".txt"
 #define PATH_TO_LSPI_WEIGHT_VECTOR_FILE OUTPUT_ROOT_PATH "results/lspi_weights_" TASK_NAME ".txt"
+#define PATH_TO_LSPI_BASIS_POLICY_FILE    OUTPUT_ROOT_PATH "results/lspi_basis_policy_" TASK_NAME ".bin"
+#define PATH_TO_LSPI_SAMPLES_FILE   OUTPUT_ROOT_PATH "results/lspi_samples_" TASK_NAME ".bin"
+#define PATH_TO_LSPI_CHECKPOINT_FILE    OUTPUT_ROOT_PATH "results/lspi_checkpoint_" TASK_NAME ".bin"
+#define PATH_TO_LSPI_METRICS_FILE   OUTPUT_ROOT_PATH "results/lspi_metrics_" TASK_NAME ".txt"
+#define PATH_TO_LSPI_FQI_POLICY_FILE    OUTPUT_ROOT_PATH "results/lspi_fqi_policy_" TASK_NAME ".bin"
+#define PATH_TO_LSPI_FQI_METRICS_FILE   OUTPUT_ROOT_PATH "results/lspi_fqi_metrics_" TASK_NAME ".txt"
 #define PATH_TO_SENSOR_DATA_FOLDER  OUTPUT_ROOT_PATH    "data/raw/"
 #define PATH_TO_AUTOENCODER_LAYER_CONFIGURATION OUTPUT_ROOT_PATH "autoencoder/" CNN_STACKED_AUTOENCODER_CONFIGURATION "/"
 
@@ -139,6 +184,28 @@ inline void ConfigurationLSPI() {
     std::cout << "LSPR_IC_POSITION_OFFSET_ENABLED   " << ToString(LSPR_IC_POSITION_OFFSET_ENABLED) << std::endl;
     std::cout << "LSPR_IC_VELOCITY_NON_ZERO   " << ToString(LSPR_IC_VELOCITY_NON_ZERO) << std::endl;
     std::cout << "LSPR_WRITE_ACTION_SET_TO_FILE   " << ToString(LSPR_WRITE_ACTION_SET_TO_FILE) << std::endl;
+    std::cout << "LSPR_NUM_THREADS   " << LSPR_NUM_THREADS << std::endl;
+    std::cout << "LSPR_EVALUATION_LANE_SIZE   " << LSPR_EVALUATION_LANE_SIZE << std::endl;
+    std::cout << "LSPR_WRITE_SAMPLES_TO_FILE   " << ToString(LSPR_WRITE_SAMPLES_TO_FILE) << std::endl;
+    std::cout << "LSPR_REUSE_SAMPLES_FILE   " << ToString(LSPR_REUSE_SAMPLES_FILE) << std::endl;
+    std::cout << "LSPR_CHECKPOINT_EVERY_ITERATION   " << ToString(LSPR_CHECKPOINT_EVERY_ITERATION) << std::endl;
+    std::cout << "LSPR_RESUME_FROM_CHECKPOINT   " << ToString(LSPR_RESUME_FROM_CHECKPOINT) << std::endl;
+    std::cout << "LSPR_BASIS   " << LSPR_BASIS << std::endl;
+    std::cout << "LSPR_BASIS_GRID_SIZE   " << LSPR_BASIS_GRID_SIZE << std::endl;
+    std::cout << "LSPR_BASIS_NUM_TILINGS   " << LSPR_BASIS_NUM_TILINGS << std::endl;
+    std::cout << "LSPR_BASIS_MEMORY_SIZE   " << LSPR_BASIS_MEMORY_SIZE << std::endl;
+    std::cout << "LSPR_BASIS_RIDGE   " << LSPR_BASIS_RIDGE << std::endl;
+    std::cout << "LSPR_ENGINE   " << LSPR_ENGINE << std::endl;
+    std::cout << "LSPR_FQI_REGRESSOR   " << LSPR_FQI_REGRESSOR << std::endl;
+    std::cout << "LSPR_FQI_MAX_ITERATIONS   " << LSPR_FQI_MAX_ITERATIONS << std::endl;
+    std::cout << "LSPR_FQI_NUM_CANDIDATE_ACTIONS   " << LSPR_FQI_NUM_CANDIDATE_ACTIONS << std::endl;
+    std::cout << "LSPR_FQI_NUM_NEIGHBORS   " << LSPR_FQI_NUM_NEIGHBORS << std::endl;
+    std::cout << "LSPR_FQI_BANDWIDTH   " << LSPR_FQI_BANDWIDTH << std::endl;
+    std::cout << "LSPR_FQI_ERROR_BOUND   " << LSPR_FQI_ERROR_BOUND << std::endl;
+    std::cout << "LSPR_FQI_HIDDEN_UNITS   " << LSPR_FQI_HIDDEN_UNITS << std::endl;
+    std::cout << "LSPR_FQI_EPOCHS   " << LSPR_FQI_EPOCHS << std::endl;
+    std::cout << "LSPR_FQI_BATCH_SIZE   " << LSPR_FQI_BATCH_SIZE << std::endl;
+    std::cout << "LSPR_FQI_LEARNING_RATE   " << LSPR_FQI_LEARNING_RATE << std::endl;
     std::cout << std::endl;
 }
 
@@ -0,0 +1,377 @@
+#include "ensembleintegrator.h"
+#include "modifiedcontrolledrungekutta.h"
+#include "constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const unsigned int kStateDimension = 7;
+
+// Runge-Kutta Cash-Karp 5(4) tableau as in odeint::runge_kutta_cash_karp54
+static const unsigned int kNumStages = 6;
+static const double kStageA[kNumStages - 1][kNumStages - 1] = {
+    {1.0 / 5.0, 0.0, 0.0, 0.0, 0.0},
+    {3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0},
+    {3.0 / 10.0, -9.0 / 10.0, 6.0 / 5.0, 0.0, 0.0},
+    {-11.0 / 54.0, 5.0 / 2.0, -70.0 / 27.0, 35.0 / 27.0, 0.0},
+    {1631.0 / 55296.0, 175.0 / 512.0, 575.0 / 13824.0, 44275.0 / 110592.0, 253.0 / 4096.0}};
+static const double kStageB[kNumStages] = {37.0 / 378.0, 0.0, 250.0 / 621.0, 125.0 / 594.0, 0.0, 512.0 / 1771.0};
+static const double kStageErrorB[kNumStages] = {37.0 / 378.0 - 2825.0 / 27648.0, 0.0, 250.0 / 621.0 - 18575.0 / 48384.0, 125.0 / 594.0 - 13525.0 / 55296.0, -277.0 / 14336.0, 512.0 / 1771.0 - 1.0 / 4.0};
+static const double kStageC[kNumStages] = {0.0, 1.0 / 5.0, 3.0 / 10.0, 3.0 / 5.0, 1.0, 7.0 / 8.0};
+static const unsigned int kStepperOrder = 5;
+static const unsigned int kErrorOrder = 4;
+
+// odeint::default_error_checker tolerances
+static const double kAbsoluteTolerance = 1e-6;
+static const double kRelativeTolerance = 1e-6;
+
+// odeint::failed_step_checker limit of consecutive rejected steps
+static const unsigned int kMaximumTrials = 500;
+
+EnsembleIntegrator::EnsembleIntegrator(const unsigned int &num_lanes, const double &minimum_step_size)
+    : num_lanes_(num_lanes), minimum_step_size_(minimum_step_size),
+      asteroids_(num_lanes, NULL), state_(kStateDimension * num_lanes, 0.0), time_(num_lanes, 0.0), dt_(num_lanes, 0.0), end_time_(num_lanes, 0.0),
+      trials_(num_lanes, 0), status_(num_lanes, Crashed), lane_mask_(num_lanes, 0), fault_(num_lanes, NoFault),
+      spacecraft_minimum_mass_(num_lanes, 0.0), mass_flow_(num_lanes, 0.0), spacecraft_specific_impulse_(num_lanes, 0.0), fuel_usage_enabled_(num_lanes, 0),
+      thrust_(3 * num_lanes, 0.0), perturbations_acceleration_(3 * num_lanes, 0.0), acceleration_(3 * num_lanes, 0.0),
+      gravity_acceleration_(3 * num_lanes, 0.0), angular_velocity_(3 * num_lanes, 0.0), angular_acceleration_(3 * num_lanes, 0.0),
+      dxdt_(kStateDimension * num_lanes, 0.0), stages_(kNumStages - 1, std::vector<double>(kStateDimension * num_lanes, 0.0)),
+      stage_state_(kStateDimension * num_lanes, 0.0), stage_time_(num_lanes, 0.0), state_new_(kStateDimension * num_lanes, 0.0), state_error_(kStateDimension * num_lanes, 0.0) {
+
+}
+
+void EnsembleIntegrator::SetLane(const unsigned int &lane, const Asteroid &asteroid, const SystemState &state, const double &time, const double &spacecraft_specific_impulse, const double &spacecraft_minimum_mass, const bool &fuel_usage_enabled) {
+    asteroids_.at(lane) = &asteroid;
+    for (unsigned int d = 0; d < kStateDimension; ++d) {
+        state_[d * num_lanes_ + lane] = state[d];
+    }
+    time_[lane] = time;
+    spacecraft_specific_impulse_[lane] = spacecraft_specific_impulse;
+    spacecraft_minimum_mass_[lane] = spacecraft_minimum_mass;
+    fuel_usage_enabled_[lane] = fuel_usage_enabled;
+    status_[lane] = Running;
+
+    SetLaneControl(lane, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, 0.0);
+}
+
+void EnsembleIntegrator::SetLaneControl(const unsigned int &lane, const Vector3D &perturbations_acceleration, const Vector3D &thrust, const double &engine_noise) {
+    for (unsigned int i = 0; i < 3; ++i) {
+        perturbations_acceleration_.at(i * num_lanes_ + lane) = perturbations_acceleration[i];
+        thrust_[i * num_lanes_ + lane] = thrust[i];
+    }
+
+    // the mass flow is constant for the whole integration, same expression as in ODESystem
+    if (fuel_usage_enabled_[lane]) {
+        const double specific_impulse = spacecraft_specific_impulse_[lane];
+        mass_flow_[lane] = -VectorNorm(thrust) / ((specific_impulse + specific_impulse * engine_noise) * kEarthAcceleration);
+    } else {
+        mass_flow_[lane] = 0.0;
+    }
+}
+
+unsigned int EnsembleIntegrator::NumLanes() const {
+    return num_lanes_;
+}
+
+SystemState EnsembleIntegrator::LaneState(const unsigned int &lane) const {
+    SystemState state;
+    for (unsigned int d = 0; d < kStateDimension; ++d) {
+        state[d] = state_.at(d * num_lanes_ + lane);
+    }
+    return state;
+}
+
+double EnsembleIntegrator::LaneTime(const unsigned int &lane) const {
+    return time_.at(lane);
+}
+
+Vector3D EnsembleIntegrator::LaneAcceleration(const unsigned int &lane) const {
+    const Vector3D acceleration = {acceleration_.at(lane), acceleration_[num_lanes_ + lane], acceleration_[2 * num_lanes_ + lane]};
+    return acceleration;
+}
+
+EnsembleIntegrator::LaneStatus EnsembleIntegrator::StatusOfLane(const unsigned int &lane) const {
+    return status_.at(lane);
+}
+
+void EnsembleIntegrator::StopLane(const unsigned int &lane, const LaneStatus &status) {
+    status_[lane] = status;
+    lane_mask_[lane] = 0;
+}
+
+void EnsembleIntegrator::EvaluateDerivatives(const std::vector<double> &states, const std::vector<double> &times, std::vector<double> &derivatives) {
+    const unsigned int n = num_lanes_;
+    const double *x = &states[0];
+    const double *g = &gravity_acceleration_[0];
+    const double *w = &angular_velocity_[0];
+    const double *dw = &angular_acceleration_[0];
+    const double *thrust = &thrust_[0];
+    const double *perturbations = &perturbations_acceleration_[0];
+
+    // the asteroid dependent terms are scalar per lane
+    for (unsigned int lane = 0; lane < n; ++lane) {
+        fault_[lane] = NoFault;
+        if (!lane_mask_[lane]) {
+            continue;
+        }
+
+        // check if spacecraft is out of fuel
+        if (x[6 * n + lane] <= spacecraft_minimum_mass_[lane]) {
+            fault_[lane] = MassBelowMinimum;
+            lane_mask_[lane] = 0;
+            continue;
+        }
+
+        const Asteroid &asteroid = *asteroids_[lane];
+        const Vector3D &position = {x[lane], x[n + lane], x[2 * n + lane]};
+        try {
+            const Vector3D gravity_acceleration = asteroid.GravityAccelerationAtPosition(position);
+            for (unsigned int i = 0; i < 3; ++i) {
+                gravity_acceleration_[i * n + lane] = gravity_acceleration[i];
+            }
+        } catch (const Asteroid::Exception &exception) {
+            fault_[lane] = PositionInside;
+            lane_mask_[lane] = 0;
+            continue;
+        }
+
+        const boost::tuple<Vector3D, Vector3D> result = asteroid.AngularVelocityAndAccelerationAtTime(times[lane]);
+        const Vector3D &angular_velocity = boost::get<0>(result);
+        const Vector3D &angular_acceleration = boost::get<1>(result);
+        for (unsigned int i = 0; i < 3; ++i) {
+            angular_velocity_[i * n + lane] = angular_velocity[i];
+            angular_acceleration_[i * n + lane] = angular_acceleration[i];
+        }
+    }
+
+    // Fp + Fg + Fc - 2w x r' - w' x r - w x (w x r) over all lanes, same operation order as ODESystem.
+    // Masked out lanes keep their derivatives, a lane retrying its step still needs d/dt state at the step start.
+    double *dxdt = &derivatives[0];
+    for (unsigned int lane = 0; lane < n; ++lane) {
+        if (!lane_mask_[lane]) {
+            continue;
+        }
+
+        const double coef_mass = 1.0 / x[6 * n + lane];
+
+        const double r_0 = x[lane];
+        const double r_1 = x[n + lane];
+        const double r_2 = x[2 * n + lane];
+        const double v_0 = x[3 * n + lane];
+        const double v_1 = x[4 * n + lane];
+        const double v_2 = x[5 * n + lane];
+
+        const double w_0 = w[lane];
+        const double w_1 = w[n + lane];
+        const double w_2 = w[2 * n + lane];
+        const double w2_0 = 2.0 * w_0;
+        const double w2_1 = 2.0 * w_1;
+        const double w2_2 = 2.0 * w_2;
+        const double dw_0 = dw[lane];
+        const double dw_1 = dw[n + lane];
+        const double dw_2 = dw[2 * n + lane];
+
+        const double external_0 = perturbations[lane] + g[lane] + coef_mass * thrust[lane];
+        const double external_1 = perturbations[n + lane] + g[n + lane] + coef_mass * thrust[n + lane];
+        const double external_2 = perturbations[2 * n + lane] + g[2 * n + lane] + coef_mass * thrust[2 * n + lane];
+
+        const double wr_0 = w_1 * r_2 - w_2 * r_1;
+        const double wr_1 = w_2 * r_0 - w_0 * r_2;
+        const double wr_2 = w_0 * r_1 - w_1 * r_0;
+
+        dxdt[lane] = v_0;
+        dxdt[n + lane] = v_1;
+        dxdt[2 * n + lane] = v_2;
+        dxdt[3 * n + lane] = external_0 - (w2_1 * v_2 - w2_2 * v_1) - (dw_1 * r_2 - dw_2 * r_1) - (w_1 * wr_2 - w_2 * wr_1);
+        dxdt[4 * n + lane] = external_1 - (w2_2 * v_0 - w2_0 * v_2) - (dw_2 * r_0 - dw_0 * r_2) - (w_2 * wr_0 - w_0 * wr_2);
+        dxdt[5 * n + lane] = external_2 - (w2_0 * v_1 - w2_1 * v_0) - (dw_0 * r_1 - dw_1 * r_0) - (w_0 * wr_1 - w_1 * wr_0);
+        dxdt[6 * n + lane] = mass_flow_[lane];
+    }
+}
+
+unsigned int EnsembleIntegrator::Integrate(const double &duration) {
+    const unsigned int n = num_lanes_;
+    const double epsilon = std::numeric_limits<double>::epsilon();
+
+    // start of integrate_adaptive: every running lane begins with the minimum step size
+    unsigned int num_integrating = 0;
+    for (unsigned int lane = 0; lane < n; ++lane) {
+        lane_mask_[lane] = (status_[lane] == Running);
+        end_time_[lane] = time_[lane] + duration;
+        dt_[lane] = minimum_step_size_;
+        trials_[lane] = 0;
+    }
+
+    // d/dt state at the step start, faults are not caught here, just as in try_step
+    EvaluateDerivatives(state_, time_, dxdt_);
+    for (unsigned int lane = 0; lane < n; ++lane) {
+        if (fault_[lane] == PositionInside) {
+            StopLane(lane, Crashed);
+        } else if (fault_[lane] == MassBelowMinimum) {
+            StopLane(lane, OutOfFuel);
+        } else if (lane_mask_[lane]) {
+            // the sensed acceleration excludes the thrust
+            const Vector3D &external_acceleration = {perturbations_acceleration_[lane] + gravity_acceleration_[lane],
+                                                     perturbations_acceleration_[n + lane] + gravity_acceleration_[n + lane],
+                                                     perturbations_acceleration_[2 * n + lane] + gravity_acceleration_[2 * n + lane]};
+            const Vector3D &angular_velocity = {angular_velocity_[lane], angular_velocity_[n + lane], angular_velocity_[2 * n + lane]};
+            const Vector3D &angular_acceleration = {angular_acceleration_[lane], angular_acceleration_[n + lane], angular_acceleration_[2 * n + lane]};
+            const Vector3D &position = {state_[lane], state_[n + lane], state_[2 * n + lane]};
+            const Vector3D &velocity = {state_[3 * n + lane], state_[4 * n + lane], state_[5 * n + lane]};
+            const Vector3D acceleration = VectorRotatingFrameAcceleration(external_acceleration, angular_velocity, angular_acceleration, position, velocity);
+            for (unsigned int i = 0; i < 3; ++i) {
+                acceleration_[i * n + lane] = acceleration[i];
+            }
+
+            if (end_time_[lane] - time_[lane] > epsilon) {
+                ++num_integrating;
+            } else {
+                lane_mask_[lane] = 0;
+            }
+        }
+    }
+
+    std::vector<char> integrating(lane_mask_);
+    while (num_integrating > 0) {
+        for (unsigned int lane = 0; lane < n; ++lane) {
+            lane_mask_[lane] = integrating[lane];
+            if (integrating[lane] && (time_[lane] + dt_[lane]) - end_time_[lane] > epsilon) {
+                dt_[lane] = end_time_[lane] - time_[lane];
+            }
+        }
+
+        // stages, x_tmp = x + dt * a_0 * dxdt + dt * a_1 * k_1 + ...
+        for (unsigned int s = 1; s < kNumStages; ++s) {
+            const double *a = kStageA[s - 1];
+            for (unsigned int d = 0; d < kStateDimension; ++d) {
+                const double *x = &state_[d * n];
+                const double *dxdt = &dxdt_[d * n];
+                double *x_tmp = &stage_state_[d * n];
+                for (unsigned int lane = 0; lane < n; ++lane) {
+                    x_tmp[lane] = x[lane] + (a[0] * dt_[lane]) * dxdt[lane];
+                }
+                for (unsigned int j = 1; j < s; ++j) {
+                    const double *stage = &stages_[j - 1][d * n];
+                    for (unsigned int lane = 0; lane < n; ++lane) {
+                        x_tmp[lane] += (a[j] * dt_[lane]) * stage[lane];
+                    }
+                }
+            }
+            for (unsigned int lane = 0; lane < n; ++lane) {
+                stage_time_[lane] = time_[lane] + kStageC[s] * dt_[lane];
+            }
+
+            EvaluateDerivatives(stage_state_, stage_time_, stages_[s - 1]);
+
+            for (unsigned int lane = 0; lane < n; ++lane) {
+                if (fault_[lane] == MassBelowMinimum) {
+                    StopLane(lane, OutOfFuel);
+                    integrating[lane] = 0;
+                    --num_integrating;
+                } else if (fault_[lane] == PositionInside) {
+                    if (dt_[lane] > kMaximumCollisionTimeStep) {
+                        // we hit the asteroid but maybe we are already inside the asteroid. -> decrease dt
+                        dt_[lane] *= 0.5;
+                        if (++trials_[lane] >= kMaximumTrials) {
+                            StopLane(lane, StepSizeAdjustmentFailed);
+                            integrating[lane] = 0;
+                            --num_integrating;
+                        }
+                    } else {
+                        StopLane(lane, Crashed);
+                        integrating[lane] = 0;
+                        --num_integrating;
+                    }
+                }
+            }
+        }
+
+        // x_new = x + dt * b_0 * dxdt + dt * b_1 * k_1 + ..., x_err = dt * db_0 * dxdt + dt * db_1 * k_1 + ...
+        for (unsigned int d = 0; d < kStateDimension; ++d) {
+            const double *x = &state_[d * n];
+            const double *dxdt = &dxdt_[d * n];
+            double *x_new = &state_new_[d * n];
+            double *x_err = &state_error_[d * n];
+            for (unsigned int lane = 0; lane < n; ++lane) {
+                x_new[lane] = x[lane] + (kStageB[0] * dt_[lane]) * dxdt[lane];
+                x_err[lane] = (kStageErrorB[0] * dt_[lane]) * dxdt[lane];
+            }
+            for (unsigned int j = 1; j < kNumStages; ++j) {
+                const double *stage = &stages_[j - 1][d * n];
+                for (unsigned int lane = 0; lane < n; ++lane) {
+                    x_new[lane] += (kStageB[j] * dt_[lane]) * stage[lane];
+                    x_err[lane] += (kStageErrorB[j] * dt_[lane]) * stage[lane];
+                }
+            }
+        }
+
+        // error control per lane
+        bool accepted_any = false;
+        for (unsigned int lane = 0; lane < n; ++lane) {
+            if (!lane_mask_[lane]) {
+                continue;
+            }
+
+            const double dt = dt_[lane];
+            double max_relative_error = 0.0;
+            for (unsigned int d = 0; d < kStateDimension; ++d) {
+                const unsigned int k = d * n + lane;
+                const double relative_error = std::abs(state_error_[k]) / (kAbsoluteTolerance + kRelativeTolerance * (std::abs(state_[k]) + std::abs(dt) * std::abs(dxdt_[k])));
+                max_relative_error = std::max(max_relative_error, relative_error);
+            }
+
+            if (max_relative_error > 1.0) {
+                // error too large - decrease dt ,limit scaling factor to 0.2 and reset state
+                dt_[lane] *= std::max(0.9 * pow(max_relative_error, -1.0 / (kErrorOrder - 1)), 0.2);
+                if (++trials_[lane] >= kMaximumTrials) {
+                    StopLane(lane, StepSizeAdjustmentFailed);
+                    integrating[lane] = 0;
+                    --num_integrating;
+                }
+                lane_mask_[lane] = 0;
+                continue;
+            }
+
+            for (unsigned int d = 0; d < kStateDimension; ++d) {
+                state_[d * n + lane] = state_new_[d * n + lane];
+            }
+            time_[lane] += dt;
+            if (max_relative_error < 0.5) {
+                //error too small - increase dt and keep the evolution and limit scaling factor to 5.0
+                max_relative_error = std::max(pow(5.0, -static_cast<double>(kStepperOrder)), max_relative_error);
+                dt_[lane] *= 0.9 * pow(max_relative_error, -1.0 / kStepperOrder);
+            }
+            trials_[lane] = 0;
+            accepted_any = true;
+
+            if (end_time_[lane] - time_[lane] <= epsilon) {
+                integrating[lane] = 0;
+                lane_mask_[lane] = 0;
+                --num_integrating;
+            }
+        }
+
+        // d/dt state at the new step start of the accepted lanes
+        if (accepted_any) {
+            EvaluateDerivatives(state_, time_, dxdt_);
+            for (unsigned int lane = 0; lane < n; ++lane) {
+                if (fault_[lane] == NoFault) {
+                    continue;
+                }
+                StopLane(lane, fault_[lane] == PositionInside ? Crashed : OutOfFuel);
+                integrating[lane] = 0;
+                --num_integrating;
+            }
+        }
+    }
+
+    unsigned int num_running = 0;
+    for (unsigned int lane = 0; lane < n; ++lane) {
+        lane_mask_[lane] = 0;
+        if (status_[lane] == Running) {
+            ++num_running;
+        }
+    }
+    return num_running;
+}
@@ -0,0 +1,133 @@
+#ifndef ENSEMBLEINTEGRATOR_H
+#define ENSEMBLEINTEGRATOR_H
+
+#include "vector.h"
+#include "systemstate.h"
+#include "asteroid.h"
+
+#include <vector>
+
+class EnsembleIntegrator {
+    /*
+    * This class integrates many independent spacecraft (lanes) together. The lane states are stored as structure of arrays,
+    * i.e. one contiguous array of all lanes per state dimension, so that the right hand side and the Runge-Kutta stage
+    * combinations run as single loops over all lanes.
+    *
+    * Every lane has its own time and adaptive step size. The step control replicates integrate_adaptive with
+    * odeint::modified_controlled_runge_kutta<runge_kutta_cash_karp54> (same coefficients, error checker and step size
+    * adjustment, including the collision step halving), rejected lanes are masked out of the state update. Hence a lane
+    * follows the same trajectory as LSPISimulator::NextState does for the same inputs. LSPISimulator::NextStates advances
+    * the simulations of a policy evaluation with it.
+    *
+    * Instead of exceptions, a lane that crashes into the asteroid or runs out of fuel is stopped with the corresponding status.
+    */
+public:
+    // The status a lane can have
+    enum LaneStatus {
+        Running,
+        Crashed,
+        OutOfFuel,
+        StepSizeAdjustmentFailed
+    };
+
+    EnsembleIntegrator(const unsigned int &num_lanes, const double &minimum_step_size=0.1);
+
+    // Places a spacecraft with state "state" at time "time" next to asteroid "asteroid" on lane "lane" and sets it running.
+    // The asteroid has to outlive the integrator.
+    void SetLane(const unsigned int &lane, const Asteroid &asteroid, const SystemState &state, const double &time, const double &spacecraft_specific_impulse, const double &spacecraft_minimum_mass, const bool &fuel_usage_enabled=true);
+
+    // Sets the perturbations acceleration, thrust and engine noise which are held constant on lane "lane" during the next integrations
+    void SetLaneControl(const unsigned int &lane, const Vector3D &perturbations_acceleration, const Vector3D &thrust, const double &engine_noise);
+
+    // Integrates all running lanes for "duration" seconds, starting from each lane's own time. Returns the number of lanes still running.
+    unsigned int Integrate(const double &duration);
+
+    // Returns the number of lanes
+    unsigned int NumLanes() const;
+
+    // Returns the state of lane "lane"
+    SystemState LaneState(const unsigned int &lane) const;
+
+    // Returns the time lane "lane" reached. For stopped lanes this is the time of the last accepted step.
+    double LaneTime(const unsigned int &lane) const;
+
+    // Returns the acceleration (without thrust) at the lane's state at the beginning of the last integration, as LSPISimulator::NextState reports it
+    Vector3D LaneAcceleration(const unsigned int &lane) const;
+
+    // Returns the status of lane "lane"
+    LaneStatus StatusOfLane(const unsigned int &lane) const;
+
+private:
+    // The faults a right hand side evaluation can have for a lane
+    enum LaneFault {
+        NoFault,
+        PositionInside,
+        MassBelowMinimum
+    };
+
+    // Evaluates d/dt of the states "states" at the times "times" for all lanes with lane_mask_ set.
+    // Lanes with a fault get their fault set and their lane_mask_ cleared.
+    void EvaluateDerivatives(const std::vector<double> &states, const std::vector<double> &times, std::vector<double> &derivatives);
+
+    // Stops lane "lane" with status "status"
+    void StopLane(const unsigned int &lane, const LaneStatus &status);
+
+    // The number of lanes
+    unsigned int num_lanes_;
+
+    // The initial step size of the adaptive integration
+    double minimum_step_size_;
+
+    // The asteroid of each lane
+    std::vector<const Asteroid*> asteroids_;
+
+    // The lane states, state_[d * num_lanes_ + lane]
+    std::vector<double> state_;
+
+    // The lane times
+    std::vector<double> time_;
+
+    // The lane step sizes
+    std::vector<double> dt_;
+
+    // The time each lane integrates to
+    std::vector<double> end_time_;
+
+    // The number of consecutive rejected step attempts per lane
+    std::vector<unsigned int> trials_;
+
+    // The lane status
+    std::vector<LaneStatus> status_;
+
+    // Is the lane integrating in the current step attempt
+    std::vector<char> lane_mask_;
+
+    // The fault of the last right hand side evaluation per lane
+    std::vector<LaneFault> fault_;
+
+    // Lane spacecraft and control parameters, stored per dimension for the thrust and perturbations
+    std::vector<double> spacecraft_minimum_mass_;
+    std::vector<double> mass_flow_;
+    std::vector<double> spacecraft_specific_impulse_;
+    std::vector<char> fuel_usage_enabled_;
+    std::vector<double> thrust_;
+    std::vector<double> perturbations_acceleration_;
+
+    // Acceleration reported by LaneAcceleration
+    std::vector<double> acceleration_;
+
+    // Right hand side scratch, gravity, w and w' per dimension
+    std::vector<double> gravity_acceleration_;
+    std::vector<double> angular_velocity_;
+    std::vector<double> angular_acceleration_;
+
+    // Runge-Kutta scratch: d/dt state at the step start, stages, stage state and times, new state and its error
+    std::vector<double> dxdt_;
+    std::vector<std::vector<double> > stages_;
+    std::vector<double> stage_state_;
+    std::vector<double> stage_time_;
+    std::vector<double> state_new_;
+    std::vector<double> state_error_;
+};
+
+#endif // ENSEMBLEINTEGRATOR_H
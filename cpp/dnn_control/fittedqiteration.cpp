@@ -0,0 +1,91 @@
+#include "fittedqiteration.h"
+
+#include <vector>
+#include <algorithm>
+
+// The number of samples or states which are handled by one task
+static const unsigned int kBlockSize = 1024;
+
+FittedQIteration::FittedQIteration(ThreadPool &thread_pool, const LSPISampleSet &samples, const Eigen::MatrixXd &action_features, QRegressor &regressor, const double &gamma, const unsigned int &num_candidate_actions, const double &error_bound)
+    : thread_pool_(thread_pool), samples_(samples), regressor_(regressor), gamma_(gamma), policy_(thread_pool, samples, action_features, regressor, num_candidate_actions, error_bound),
+      num_iterations_(0), fitted_(false) {
+
+    if (gamma_ < 0.0 || gamma_ >= 1.0) {
+        throw InvalidParameterException();
+    }
+
+    const unsigned int num_samples = samples_.Size();
+    const unsigned int state_dimension = policy_.StateDimension();
+    rewards_.resize(num_samples);
+    for (unsigned int i = 0; i < num_samples; ++i) {
+        rewards_(i) = samples_.Reward(i);
+    }
+
+    const unsigned int num_blocks = (num_samples + kBlockSize - 1) / kBlockSize;
+    std::vector<float> scaled_next_states(static_cast<std::size_t>(num_samples) * state_dimension);
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        const unsigned int end = std::min(num_samples, (block + 1) * kBlockSize);
+        for (unsigned int i = block * kBlockSize; i < end; ++i) {
+            policy_.Standardize(samples_.NextState(i), scaled_next_states.data() + static_cast<std::size_t>(i) * state_dimension);
+        }
+    });
+
+    QRegressor::InputMatrix inputs;
+    policy_.SampleInputs(inputs);
+    QRegressor::InputMatrix queries;
+    std::vector<unsigned int> candidate_actions;
+    policy_.CandidateInputs(scaled_next_states.data(), num_samples, queries, candidate_actions);
+    std::vector<float>().swap(scaled_next_states);
+    regressor_.SetInputs(inputs, queries);
+
+    q_values_ = Eigen::VectorXd::Zero(num_samples);
+}
+
+double FittedQIteration::Iterate() {
+    const unsigned int num_samples = samples_.Size();
+
+    // Q is 0 before the first iteration
+    Eigen::VectorXd next_q_values = Eigen::VectorXd::Zero(num_samples);
+    if (num_iterations_ > 0) {
+        if (!fitted_) {
+            regressor_.Fit(q_values_);
+            fitted_ = true;
+        }
+        Eigen::VectorXd query_q_values;
+        regressor_.PredictQueries(query_q_values);
+
+        const unsigned int num_candidate_actions = policy_.NumCandidateActions();
+        const unsigned int num_blocks = (num_samples + kBlockSize - 1) / kBlockSize;
+        thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+            const unsigned int end = std::min(num_samples, (block + 1) * kBlockSize);
+            for (unsigned int i = block * kBlockSize; i < end; ++i) {
+                next_q_values(i) = query_q_values.segment(static_cast<std::size_t>(i) * num_candidate_actions, num_candidate_actions).maxCoeff();
+            }
+        });
+    }
+
+    const Eigen::VectorXd q_values = rewards_ + gamma_ * next_q_values;
+    const double change = (q_values - q_values_).cwiseAbs().maxCoeff();
+    q_values_ = q_values;
+    fitted_ = false;
+    num_iterations_++;
+
+    return change;
+}
+
+unsigned int FittedQIteration::NumIterations() const {
+    return num_iterations_;
+}
+
+const Eigen::VectorXd& FittedQIteration::QValues() const {
+    return q_values_;
+}
+
+const FittedQPolicy& FittedQIteration::Policy() {
+    if (!fitted_) {
+        regressor_.Fit(q_values_);
+        fitted_ = true;
+    }
+
+    return policy_;
+}
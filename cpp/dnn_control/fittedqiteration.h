@@ -0,0 +1,66 @@
+#ifndef FITTEDQITERATION_H
+#define FITTEDQITERATION_H
+
+#include "fittedqpolicy.h"
+#include "lspisampleset.h"
+#include "qregressor.h"
+#include "threadpool.h"
+
+#include <eigen3/Eigen/Dense>
+
+class FittedQIteration {
+    /*
+    * This class runs fitted Q iteration on a fixed set of samples with any QRegressor, as an alternative to LSPI for
+    * states whose Q functions no linear basis fits.
+    *
+    * Every iteration fits the regressor to the current Q values of the samples (s, a) and sets them to
+    * r + gamma max_a' Q(s', a'), the regressor's inputs being the ones of a FittedQPolicy of the samples.
+    *
+    * With many actions, e.g. thousands of thrusts, maximizing over all of them for every next state is too expensive and
+    * a nonparametric regressor is not supported by data for most of them. The maximum is therefore taken over the
+    * candidate actions of the policy, the actions of the samples whose states are nearest to the next state. The
+    * candidates of the next states are searched once on construction, as one batch on the thread pool, so the
+    * regressor's queries are the same in every iteration.
+    */
+public:
+    FittedQIteration(ThreadPool &thread_pool, const LSPISampleSet &samples, const Eigen::MatrixXd &action_features, QRegressor &regressor, const double &gamma, const unsigned int &num_candidate_actions, const double &error_bound=0.0);
+
+    // Runs one iteration and returns the largest change of the Q values of the samples
+    double Iterate();
+
+    // The number of iterations run
+    unsigned int NumIterations() const;
+
+    // The Q values of the samples, r after the first iteration
+    const Eigen::VectorXd& QValues() const;
+
+    // Fits the regressor to the Q values of the samples and returns their greedy policy, which is valid until the next iteration
+    const FittedQPolicy& Policy();
+
+    // FittedQIteration can throw the following exceptions
+    class Exception {};
+    class InvalidParameterException : public Exception {};
+
+private:
+    ThreadPool &thread_pool_;
+
+    const LSPISampleSet &samples_;
+
+    QRegressor &regressor_;
+
+    double gamma_;
+
+    // The standardization and the candidate actions of the samples
+    FittedQPolicy policy_;
+
+    Eigen::VectorXd rewards_;
+
+    Eigen::VectorXd q_values_;
+
+    unsigned int num_iterations_;
+
+    // Set if the regressor is fitted to q_values_
+    bool fitted_;
+};
+
+#endif // FITTEDQITERATION_H
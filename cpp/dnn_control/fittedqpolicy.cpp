@@ -0,0 +1,264 @@
+#include "fittedqpolicy.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+// The number of samples or states which are handled by one task
+static const unsigned int kBlockSize = 1024;
+
+const char FittedQPolicy::kMagic[8] = {'L', 'S', 'P', 'I', 'F', 'Q', 'P', '\0'};
+const boost::uint32_t FittedQPolicy::kVersion;
+
+FittedQPolicy::FittedQPolicy(ThreadPool &thread_pool, const LSPISampleSet &samples, const Eigen::MatrixXd &action_features, QRegressor &regressor, const unsigned int &num_candidate_actions, const double &error_bound)
+    : thread_pool_(thread_pool), regressor_(regressor), state_dimension_(samples.StateDimension()), state_type_(samples.StateType()), action_set_hash_(samples.ActionSetHash()),
+      num_candidate_actions_(num_candidate_actions), error_bound_(error_bound) {
+
+    const unsigned int num_samples = samples.Size();
+    const unsigned int num_actions = action_features.rows();
+    const unsigned int num_action_features = action_features.cols();
+    if (num_samples == 0 || num_actions == 0 || num_candidate_actions_ == 0 || error_bound_ < 0.0) {
+        throw InvalidParameterException();
+    }
+    num_candidate_actions_ = std::min(num_candidate_actions_, num_samples);
+
+    // the means and deviations of the states and of the features of the actions taken
+    std::vector<double> sums(state_dimension_ + num_action_features, 0.0);
+    std::vector<double> squared_sums(sums.size(), 0.0);
+    actions_.resize(num_samples);
+    for (unsigned int i = 0; i < num_samples; ++i) {
+        const unsigned int action = samples.Action(i);
+        if (action >= num_actions) {
+            throw InvalidParameterException();
+        }
+        const float *state = samples.State(i);
+        for (unsigned int k = 0; k < state_dimension_; ++k) {
+            sums[k] += state[k];
+            squared_sums[k] += static_cast<double>(state[k]) * state[k];
+        }
+        for (unsigned int k = 0; k < num_action_features; ++k) {
+            sums[state_dimension_ + k] += action_features(action, k);
+            squared_sums[state_dimension_ + k] += action_features(action, k) * action_features(action, k);
+        }
+        actions_[i] = action;
+    }
+    std::vector<double> means(sums.size());
+    std::vector<double> scales(sums.size());
+    for (unsigned int k = 0; k < sums.size(); ++k) {
+        means[k] = sums[k] / num_samples;
+        const double variance = squared_sums[k] / num_samples - means[k] * means[k];
+        scales[k] = (variance > 0.0 ? 1.0 / std::sqrt(variance) : 1.0);
+    }
+    state_means_.assign(means.begin(), means.begin() + state_dimension_);
+    state_scales_.assign(scales.begin(), scales.begin() + state_dimension_);
+    scaled_action_features_.resize(num_actions, num_action_features);
+    for (unsigned int a = 0; a < num_actions; ++a) {
+        for (unsigned int k = 0; k < num_action_features; ++k) {
+            scaled_action_features_(a, k) = (action_features(a, k) - means[state_dimension_ + k]) * scales[state_dimension_ + k];
+        }
+    }
+
+    const unsigned int num_blocks = (num_samples + kBlockSize - 1) / kBlockSize;
+    scaled_states_.resize(static_cast<std::size_t>(num_samples) * state_dimension_);
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        const unsigned int end = std::min(num_samples, (block + 1) * kBlockSize);
+        for (unsigned int i = block * kBlockSize; i < end; ++i) {
+            Standardize(samples.State(i), scaled_states_.data() + static_cast<std::size_t>(i) * state_dimension_);
+        }
+    });
+    state_tree_.reset(new KDTree(thread_pool_, scaled_states_.data(), num_samples, state_dimension_));
+}
+
+FittedQPolicy::FittedQPolicy(ThreadPool &thread_pool, QRegressor &regressor)
+    : thread_pool_(thread_pool), regressor_(regressor), state_dimension_(0), state_type_(0), action_set_hash_(0), num_candidate_actions_(0), error_bound_(0.0) {
+
+}
+
+boost::shared_ptr<FittedQPolicy> FittedQPolicy::FromFile(ThreadPool &thread_pool, const std::string &path_to_file, QRegressor &regressor) {
+    std::ifstream file(path_to_file.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw FileNotReadableException();
+    }
+
+    char magic[8];
+    boost::uint32_t header[8];
+    boost::uint64_t action_set_hash = 0;
+    double error_bound = 0.0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&action_set_hash), sizeof(action_set_hash));
+    file.read(reinterpret_cast<char*>(&error_bound), sizeof(error_bound));
+    if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || header[0] != kVersion) {
+        throw InvalidFileFormatException();
+    }
+
+    const unsigned int state_dimension = header[1];
+    const unsigned int num_action_features = header[2];
+    const unsigned int num_actions = header[3];
+    const unsigned int num_samples = header[4];
+    const unsigned int num_candidate_actions = header[5];
+    if (state_dimension == 0 || num_actions == 0 || num_samples == 0 || num_candidate_actions == 0 || num_candidate_actions > num_samples || error_bound < 0.0) {
+        throw InvalidFileFormatException();
+    }
+
+    boost::shared_ptr<FittedQPolicy> policy(new FittedQPolicy(thread_pool, regressor));
+    policy->state_dimension_ = state_dimension;
+    policy->state_type_ = header[7];
+    policy->action_set_hash_ = action_set_hash;
+    policy->num_candidate_actions_ = num_candidate_actions;
+    policy->error_bound_ = error_bound;
+    policy->state_means_.resize(state_dimension);
+    policy->state_scales_.resize(state_dimension);
+    Eigen::VectorXd parameters(header[6]);
+    policy->scaled_action_features_.resize(num_actions, num_action_features);
+    policy->scaled_states_.resize(static_cast<std::size_t>(num_samples) * state_dimension);
+    policy->actions_.resize(num_samples);
+    file.read(reinterpret_cast<char*>(policy->state_means_.data()), state_dimension * sizeof(double));
+    file.read(reinterpret_cast<char*>(policy->state_scales_.data()), state_dimension * sizeof(double));
+    file.read(reinterpret_cast<char*>(parameters.data()), parameters.size() * sizeof(double));
+    file.read(reinterpret_cast<char*>(policy->scaled_action_features_.data()), policy->scaled_action_features_.size() * sizeof(float));
+    file.read(reinterpret_cast<char*>(policy->scaled_states_.data()), policy->scaled_states_.size() * sizeof(float));
+    file.read(reinterpret_cast<char*>(policy->actions_.data()), policy->actions_.size() * sizeof(boost::uint16_t));
+    if (!file || file.peek() != std::ifstream::traits_type::eof()) {
+        throw InvalidFileFormatException();
+    }
+    for (unsigned int i = 0; i < num_samples; ++i) {
+        if (policy->actions_[i] >= num_actions) {
+            throw InvalidFileFormatException();
+        }
+    }
+
+    policy->state_tree_.reset(new KDTree(thread_pool, policy->scaled_states_.data(), num_samples, state_dimension));
+    QRegressor::InputMatrix inputs;
+    policy->SampleInputs(inputs);
+    regressor.SetParameters(inputs, parameters);
+
+    return policy;
+}
+
+void FittedQPolicy::WriteToFile(const std::string &path_to_file) const {
+    std::ofstream file(path_to_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw FileNotWritableException();
+    }
+
+    const Eigen::VectorXd parameters = regressor_.Parameters();
+    const boost::uint32_t header[8] = {kVersion, state_dimension_, static_cast<boost::uint32_t>(scaled_action_features_.cols()), static_cast<boost::uint32_t>(scaled_action_features_.rows()),
+                                       static_cast<boost::uint32_t>(actions_.size()), num_candidate_actions_, static_cast<boost::uint32_t>(parameters.size()), state_type_};
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&action_set_hash_), sizeof(action_set_hash_));
+    file.write(reinterpret_cast<const char*>(&error_bound_), sizeof(error_bound_));
+    file.write(reinterpret_cast<const char*>(state_means_.data()), state_means_.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(state_scales_.data()), state_scales_.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(parameters.data()), parameters.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(scaled_action_features_.data()), scaled_action_features_.size() * sizeof(float));
+    file.write(reinterpret_cast<const char*>(scaled_states_.data()), scaled_states_.size() * sizeof(float));
+    file.write(reinterpret_cast<const char*>(actions_.data()), actions_.size() * sizeof(boost::uint16_t));
+    file.close();
+    if (!file) {
+        throw FileNotWritableException();
+    }
+}
+
+void FittedQPolicy::Standardize(const float *state, float *standardized_state) const {
+    for (unsigned int k = 0; k < state_dimension_; ++k) {
+        standardized_state[k] = (state[k] - state_means_[k]) * state_scales_[k];
+    }
+}
+
+void FittedQPolicy::SampleInputs(QRegressor::InputMatrix &inputs) const {
+    const unsigned int num_samples = actions_.size();
+    const unsigned int num_action_features = scaled_action_features_.cols();
+
+    inputs.resize(num_samples, state_dimension_ + num_action_features);
+    const unsigned int num_blocks = (num_samples + kBlockSize - 1) / kBlockSize;
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        const unsigned int end = std::min(num_samples, (block + 1) * kBlockSize);
+        for (unsigned int i = block * kBlockSize; i < end; ++i) {
+            for (unsigned int k = 0; k < state_dimension_; ++k) {
+                inputs(i, k) = scaled_states_[static_cast<std::size_t>(i) * state_dimension_ + k];
+            }
+            inputs.row(i).tail(num_action_features) = scaled_action_features_.row(actions_[i]);
+        }
+    });
+}
+
+void FittedQPolicy::CandidateInputs(const float *scaled_states, const unsigned int &num_states, QRegressor::InputMatrix &inputs, std::vector<unsigned int> &candidate_actions) const {
+    // the nearest samples' indices are replaced by their actions
+    std::vector<float> squared_distances(static_cast<std::size_t>(num_states) * num_candidate_actions_);
+    candidate_actions.resize(squared_distances.size());
+    state_tree_->Search(thread_pool_, scaled_states, num_states, num_candidate_actions_, candidate_actions.data(), squared_distances.data(), error_bound_);
+
+    inputs.resize(candidate_actions.size(), state_dimension_ + scaled_action_features_.cols());
+    const unsigned int num_blocks = (num_states + kBlockSize - 1) / kBlockSize;
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        const unsigned int end = std::min(num_states, (block + 1) * kBlockSize);
+        for (unsigned int i = block * kBlockSize; i < end; ++i) {
+            for (unsigned int c = 0; c < num_candidate_actions_; ++c) {
+                CandidateInput(scaled_states + static_cast<std::size_t>(i) * state_dimension_, static_cast<std::size_t>(i) * num_candidate_actions_ + c, inputs, candidate_actions);
+            }
+        }
+    });
+}
+
+unsigned int FittedQPolicy::StateDimension() const {
+    return state_dimension_;
+}
+
+boost::uint32_t FittedQPolicy::StateType() const {
+    return state_type_;
+}
+
+boost::uint64_t FittedQPolicy::ActionSetHash() const {
+    return action_set_hash_;
+}
+
+unsigned int FittedQPolicy::NumCandidateActions() const {
+    return num_candidate_actions_;
+}
+
+void FittedQPolicy::Pi(const std::vector<SampleFactory*> &sample_factories, const StateMatrix &states, std::vector<unsigned int> &actions) const {
+    if (states.cols() != state_dimension_) {
+        throw InvalidStatesException();
+    }
+
+    const unsigned int num_states = states.rows();
+    QRegressor::InputMatrix inputs(static_cast<std::size_t>(num_states) * num_candidate_actions_, state_dimension_ + scaled_action_features_.cols());
+    std::vector<unsigned int> candidate_actions(inputs.rows());
+    std::vector<float> squared_distances(num_candidate_actions_);
+    std::vector<float> scaled_state(state_dimension_);
+    for (unsigned int i = 0; i < num_states; ++i) {
+        for (unsigned int k = 0; k < state_dimension_; ++k) {
+            scaled_state[k] = (states(i, k) - state_means_[k]) * state_scales_[k];
+        }
+        const std::size_t offset = static_cast<std::size_t>(i) * num_candidate_actions_;
+        state_tree_->Search(scaled_state.data(), num_candidate_actions_, candidate_actions.data() + offset, squared_distances.data(), error_bound_);
+        for (unsigned int c = 0; c < num_candidate_actions_; ++c) {
+            CandidateInput(scaled_state.data(), offset + c, inputs, candidate_actions);
+        }
+    }
+    Eigen::VectorXd q_values;
+    regressor_.Predict(inputs, q_values);
+
+    actions.resize(num_states);
+    for (unsigned int i = 0; i < num_states; ++i) {
+        const unsigned int offset = i * num_candidate_actions_;
+        unsigned int best = offset;
+        for (unsigned int c = offset + 1; c < offset + num_candidate_actions_; ++c) {
+            if (q_values(c) > q_values(best) || (q_values(c) == q_values(best) && candidate_actions[c] < candidate_actions[best])) {
+                best = c;
+            }
+        }
+        actions[i] = candidate_actions[best];
+    }
+}
+
+void FittedQPolicy::CandidateInput(const float *scaled_state, const std::size_t &row, QRegressor::InputMatrix &inputs, std::vector<unsigned int> &candidate_actions) const {
+    candidate_actions[row] = actions_[candidate_actions[row]];
+    for (unsigned int k = 0; k < state_dimension_; ++k) {
+        inputs(row, k) = scaled_state[k];
+    }
+    inputs.row(row).tail(scaled_action_features_.cols()) = scaled_action_features_.row(candidate_actions[row]);
+}
@@ -0,0 +1,126 @@
+#ifndef FITTEDQPOLICY_H
+#define FITTEDQPOLICY_H
+
+#include "kdtree.h"
+#include "lspisampleset.h"
+#include "qregressor.h"
+#include "samplefactory.h"
+#include "threadpool.h"
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <eigen3/Eigen/Dense>
+
+class FittedQPolicy {
+    /*
+    * This class represents the greedy policy of a Q function which a QRegressor fitted to a set of samples, e.g. by
+    * FittedQIteration.
+    *
+    * The regressor's input is a state followed by the features of an action, every column standardized by its mean and
+    * deviation over the samples. The greedy action of a state is the one with the highest Q value among its candidate
+    * actions, the actions of the samples whose states are its nearest neighbors in a KDTree of the standardized states,
+    * searched within the error bound of the tree. Ties are broken by the lowest action index.
+    *
+    * The policy keeps the standardized states and the actions of the samples, 4 D + 2 bytes per sample, so it can be
+    * written to a file together with the parameters of the fitted regressor and restored without the samples. Pi runs
+    * on the calling thread and neither changes the policy nor the regressor, so concurrent simulations share one
+    * policy. Like the samples, the policy keeps their state type and action set hash. All values are stored in native
+    * byte order:
+    *
+    *   char magic[8] = "LSPIFQP", uint32 version, uint32 state dimension D, uint32 number of action features F,
+    *   uint32 number of actions A, uint32 number of samples N, uint32 number of candidate actions C,
+    *   uint32 number of regressor parameters P, uint32 state type, uint64 action set hash, double error bound
+    *   double state_means[D], double state_scales[D], double regressor_parameters[P]
+    *   float scaled_action_features[A][F], float scaled_states[N][D], uint16 actions[N]
+    */
+public:
+    // A batch of states, one state per row
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> StateMatrix;
+
+    // The magic bytes at the beginning of every policy file
+    const static char kMagic[8];
+
+    // The current format version
+    const static boost::uint32_t kVersion = 1;
+
+    // Standardizes the states of "samples" and the features "action_features" of the actions, one row per action, for
+    // the Q values of "regressor"
+    FittedQPolicy(ThreadPool &thread_pool, const LSPISampleSet &samples, const Eigen::MatrixXd &action_features, QRegressor &regressor, const unsigned int &num_candidate_actions, const double &error_bound=0.0);
+
+    // Reads the policy file "path_to_file" and restores "regressor", which has to be of the type and configuration the policy was written with
+    static boost::shared_ptr<FittedQPolicy> FromFile(ThreadPool &thread_pool, const std::string &path_to_file, QRegressor &regressor);
+
+    // Writes the policy and the parameters of its fitted regressor to file "path_to_file"
+    void WriteToFile(const std::string &path_to_file) const;
+
+    // Sets "standardized_state" to the standardized values of the StateDimension() values of "state"
+    void Standardize(const float *state, float *standardized_state) const;
+
+    // Sets "inputs" to the regressor inputs of the samples, row i for the state and the action of sample i
+    void SampleInputs(QRegressor::InputMatrix &inputs) const;
+
+    // Sets "inputs" to the regressor inputs of the "num_states" standardized states "scaled_states" (one state after the
+    // other) with each of their candidate actions "candidate_actions", row i * NumCandidateActions() + c for candidate c
+    // of state i. The candidates are searched as one batch on the thread pool.
+    void CandidateInputs(const float *scaled_states, const unsigned int &num_states, QRegressor::InputMatrix &inputs, std::vector<unsigned int> &candidate_actions) const;
+
+    unsigned int StateDimension() const;
+
+    boost::uint32_t StateType() const;
+
+    boost::uint64_t ActionSetHash() const;
+
+    unsigned int NumCandidateActions() const;
+
+    // Computes the index of the candidate action with the highest Q value of every state of "states" into "actions",
+    // ties are broken by the lowest index, so "sample_factories" are not drawn from
+    void Pi(const std::vector<SampleFactory*> &sample_factories, const StateMatrix &states, std::vector<unsigned int> &actions) const;
+
+    // FittedQPolicy can throw the following exceptions
+    class Exception {};
+    class InvalidParameterException : public Exception {};
+    class InvalidStatesException : public Exception {};
+    class FileNotWritableException : public Exception {};
+    class FileNotReadableException : public Exception {};
+    class InvalidFileFormatException : public Exception {};
+
+private:
+    FittedQPolicy(ThreadPool &thread_pool, QRegressor &regressor);
+
+    // Sets the candidate input "row" of "inputs" to the standardized state "scaled_state" and the action of the sample
+    // "candidate_actions[row]", which is replaced by the action
+    void CandidateInput(const float *scaled_state, const std::size_t &row, QRegressor::InputMatrix &inputs, std::vector<unsigned int> &candidate_actions) const;
+
+    ThreadPool &thread_pool_;
+
+    QRegressor &regressor_;
+
+    unsigned int state_dimension_;
+
+    boost::uint32_t state_type_;
+
+    boost::uint64_t action_set_hash_;
+
+    unsigned int num_candidate_actions_;
+
+    // The relative error bound of the search of the candidate actions
+    double error_bound_;
+
+    // The standardized state value k is (value - state_means_[k]) * state_scales_[k]
+    std::vector<double> state_means_;
+    std::vector<double> state_scales_;
+
+    // The standardized features of the actions, one row per action
+    QRegressor::InputMatrix scaled_action_features_;
+
+    // The standardized states of the samples, one after the other, and their actions
+    std::vector<float> scaled_states_;
+    std::vector<boost::uint16_t> actions_;
+
+    // The tree of scaled_states_
+    boost::shared_ptr<KDTree> state_tree_;
+};
+
+#endif // FITTEDQPOLICY_H
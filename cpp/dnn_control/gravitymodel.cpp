@@ -0,0 +1,5 @@
+#include "gravitymodel.h"
+
+GravityModel::~GravityModel() {
+
+}
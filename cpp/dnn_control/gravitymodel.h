@@ -0,0 +1,20 @@
+#ifndef GRAVITYMODEL_H
+#define GRAVITYMODEL_H
+
+#include "vector.h"
+
+class GravityModel {
+    /*
+    * This abstract class represents the gravity field of an asteroid in its body fixed RF.
+    *
+    * Implementations throw Asteroid::PositionInsideException for positions inside the body, which the simulations handle
+    * as a crash.
+    */
+public:
+    virtual ~GravityModel();
+
+    // Computes the gravity acceleration at an outside point "position"
+    virtual Vector3D GravityAccelerationAtPosition(const Vector3D &position) const = 0;
+};
+
+#endif // GRAVITYMODEL_H
@@ -0,0 +1,169 @@
+#include "kdtree.h"
+
+#include <limits>
+#include <algorithm>
+
+const unsigned int KDTree::kQueryBlockSize;
+
+KDTree::KDTree(ThreadPool &thread_pool, const float *points, const unsigned int &num_points, const unsigned int &dimension, const unsigned int &leaf_size)
+    : num_points_(num_points), dimension_(dimension), num_levels_(0) {
+
+    if (num_points_ == 0 || dimension_ == 0 || leaf_size == 0) {
+        throw InvalidParameterException();
+    }
+
+    // halving the points on every level, the leaves of num_levels_ levels hold at most leaf_size points
+    while (((num_points_ - 1) >> num_levels_) + 1 > leaf_size) {
+        num_levels_++;
+    }
+    split_dimensions_.resize((1u << num_levels_) - 1);
+    split_values_.resize((1u << num_levels_) - 1);
+
+    std::vector<unsigned int> order(num_points_);
+    for (unsigned int i = 0; i < num_points_; ++i) {
+        order[i] = i;
+    }
+
+    // node j of a level covers the positions [begins[j], begins[j + 1]) of order
+    std::vector<unsigned int> begins = {0, num_points_};
+    for (unsigned int level = 0; level < num_levels_; ++level) {
+        const unsigned int num_nodes = 1u << level;
+        thread_pool.ParallelFor(num_nodes, [&](const unsigned int &j, const unsigned int &) {
+            const unsigned int begin = begins[j];
+            const unsigned int end = begins[j + 1];
+
+            unsigned int split_dimension = 0;
+            float largest_spread = -1.0f;
+            for (unsigned int k = 0; k < dimension_; ++k) {
+                float minimum = std::numeric_limits<float>::max();
+                float maximum = -std::numeric_limits<float>::max();
+                for (unsigned int i = begin; i < end; ++i) {
+                    const float value = points[static_cast<std::size_t>(order[i]) * dimension_ + k];
+                    minimum = std::min(minimum, value);
+                    maximum = std::max(maximum, value);
+                }
+                if (maximum - minimum > largest_spread) {
+                    largest_spread = maximum - minimum;
+                    split_dimension = k;
+                }
+            }
+
+            // equal values are ordered by index, so the tree does not depend on the order of the threads
+            const unsigned int middle = begin + (end - begin) / 2;
+            std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](const unsigned int &a, const unsigned int &b) {
+                const float value_a = points[static_cast<std::size_t>(a) * dimension_ + split_dimension];
+                const float value_b = points[static_cast<std::size_t>(b) * dimension_ + split_dimension];
+                return value_a < value_b || (value_a == value_b && a < b);
+            });
+
+            const unsigned int node = num_nodes - 1 + j;
+            split_dimensions_[node] = split_dimension;
+            split_values_[node] = points[static_cast<std::size_t>(order[middle]) * dimension_ + split_dimension];
+        });
+
+        std::vector<unsigned int> next_begins(2 * num_nodes + 1);
+        for (unsigned int j = 0; j < num_nodes; ++j) {
+            next_begins[2 * j] = begins[j];
+            next_begins[2 * j + 1] = begins[j] + (begins[j + 1] - begins[j]) / 2;
+        }
+        next_begins[2 * num_nodes] = num_points_;
+        begins.swap(next_begins);
+    }
+    leaf_begins_.swap(begins);
+
+    points_.resize(static_cast<std::size_t>(num_points_) * dimension_);
+    indices_.swap(order);
+    const unsigned int num_leaves = 1u << num_levels_;
+    thread_pool.ParallelFor(num_leaves, [&](const unsigned int &leaf, const unsigned int &) {
+        for (unsigned int i = leaf_begins_[leaf]; i < leaf_begins_[leaf + 1]; ++i) {
+            std::copy(points + static_cast<std::size_t>(indices_[i]) * dimension_, points + static_cast<std::size_t>(indices_[i] + 1) * dimension_, points_.begin() + static_cast<std::size_t>(i) * dimension_);
+        }
+    });
+}
+
+unsigned int KDTree::Size() const {
+    return num_points_;
+}
+
+unsigned int KDTree::Dimension() const {
+    return dimension_;
+}
+
+void KDTree::Search(const float *query, const unsigned int &k, unsigned int *indices, float *squared_distances, const double &error_bound) const {
+    if (k == 0 || k > num_points_ || error_bound < 0.0) {
+        throw InvalidParameterException();
+    }
+
+    std::vector<float> offsets(dimension_, 0.0f);
+    SearchNearest(query, k, 1.0 / ((1.0 + error_bound) * (1.0 + error_bound)), offsets.data(), indices, squared_distances);
+}
+
+void KDTree::Search(ThreadPool &thread_pool, const float *queries, const unsigned int &num_queries, const unsigned int &k, unsigned int *indices, float *squared_distances, const double &error_bound) const {
+    if (k == 0 || k > num_points_ || error_bound < 0.0) {
+        throw InvalidParameterException();
+    }
+
+    const float prune_factor = 1.0 / ((1.0 + error_bound) * (1.0 + error_bound));
+    const unsigned int num_blocks = (num_queries + kQueryBlockSize - 1) / kQueryBlockSize;
+    thread_pool.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        std::vector<float> offsets(dimension_, 0.0f);
+        const unsigned int end = std::min(num_queries, (block + 1) * kQueryBlockSize);
+        for (unsigned int i = block * kQueryBlockSize; i < end; ++i) {
+            const std::size_t offset = static_cast<std::size_t>(i) * k;
+            SearchNearest(queries + static_cast<std::size_t>(i) * dimension_, k, prune_factor, offsets.data(), indices + offset, squared_distances + offset);
+        }
+    });
+}
+
+void KDTree::SearchNearest(const float *query, const unsigned int &k, const float &prune_factor, float *offsets, unsigned int *indices, float *squared_distances) const {
+    unsigned int num_found = 0;
+    Visit(0, query, k, prune_factor, 0.0f, offsets, indices, squared_distances, num_found);
+    for (unsigned int i = 0; i < k; ++i) {
+        indices[i] = indices_[indices[i]];
+    }
+}
+
+void KDTree::Visit(const unsigned int &node, const float *query, const unsigned int &k, const float &prune_factor, const float &cell_distance, float *offsets, unsigned int *positions, float *squared_distances, unsigned int &num_found) const {
+    const unsigned int num_inner_nodes = split_values_.size();
+    if (node >= num_inner_nodes) {
+        const unsigned int leaf = node - num_inner_nodes;
+        for (unsigned int i = leaf_begins_[leaf]; i < leaf_begins_[leaf + 1]; ++i) {
+            const float *point = points_.data() + static_cast<std::size_t>(i) * dimension_;
+            float squared_distance = 0.0f;
+            for (unsigned int j = 0; j < dimension_; ++j) {
+                const float difference = point[j] - query[j];
+                squared_distance += difference * difference;
+            }
+            if (num_found == k && squared_distance >= squared_distances[k - 1]) {
+                continue;
+            }
+
+            // insertion into the sorted nearest points, dropping the k-th if all are found
+            unsigned int slot = (num_found < k ? num_found++ : k - 1);
+            while (slot > 0 && squared_distances[slot - 1] > squared_distance) {
+                positions[slot] = positions[slot - 1];
+                squared_distances[slot] = squared_distances[slot - 1];
+                slot--;
+            }
+            positions[slot] = i;
+            squared_distances[slot] = squared_distance;
+        }
+        return;
+    }
+
+    // the points of the left child are at most, the ones of the right child at least the split value, the far child's
+    // cell is "difference" away in the split dimension instead of the cell's current offset
+    const unsigned int split_dimension = split_dimensions_[node];
+    const float difference = query[split_dimension] - split_values_[node];
+    const unsigned int near_child = 2 * node + (difference < 0.0f ? 1 : 2);
+    const unsigned int far_child = 2 * node + (difference < 0.0f ? 2 : 1);
+    Visit(near_child, query, k, prune_factor, cell_distance, offsets, positions, squared_distances, num_found);
+
+    const float offset = offsets[split_dimension];
+    const float far_cell_distance = cell_distance - offset * offset + difference * difference;
+    if (num_found < k || far_cell_distance < squared_distances[k - 1] * prune_factor) {
+        offsets[split_dimension] = difference;
+        Visit(far_child, query, k, prune_factor, far_cell_distance, offsets, positions, squared_distances, num_found);
+        offsets[split_dimension] = offset;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include "threadpool.h"
+
+#include <vector>
+
+class KDTree {
+    /*
+    * This class represents a balanced k-d tree over a fixed set of points, e.g. LSPI states, for k nearest neighbor
+    * queries.
+    *
+    * Every node splits its points at their median along the dimension of the largest spread, the nodes are stored as an
+    * implicit binary heap and the leaves hold at most leaf_size points. The tree is built level by level, the nodes of a
+    * level are split on a thread pool. The points are copied in the order of the leaves, so a leaf's points are
+    * contiguous, and the indices of the original points are kept.
+    *
+    * A query descends to the leaf of its point first and then visits the other children whose cell is closer than the
+    * k-th nearest point found so far, the distance to a cell being updated incrementally from the offsets of the query
+    * per dimension. With an error bound e > 0 a cell is only visited if it is closer than that distance divided by
+    * 1 + e, so the search is approximate: the distance of the i-th point found is at most 1 + e times the one of the
+    * true i-th nearest point. In many dimensions this visits far fewer cells. A batch of queries is split into blocks
+    * which run on a thread pool.
+    */
+public:
+    // The number of queries of a batch which are answered by one task
+    const static unsigned int kQueryBlockSize = 256;
+
+    // Builds the tree over "num_points" points of "dimension" values, stored one point after the other in "points"
+    KDTree(ThreadPool &thread_pool, const float *points, const unsigned int &num_points, const unsigned int &dimension, const unsigned int &leaf_size=16);
+
+    unsigned int Size() const;
+
+    unsigned int Dimension() const;
+
+    // Sets "indices" and "squared_distances" to the "k" nearest points to "query" up to the error bound "error_bound", nearest first
+    void Search(const float *query, const unsigned int &k, unsigned int *indices, float *squared_distances, const double &error_bound=0.0) const;
+
+    // Searches the "k" nearest points of each of the "num_queries" queries "queries" (one query after the other), the
+    // results of query i are at [i * k, (i + 1) * k) of "indices" and "squared_distances"
+    void Search(ThreadPool &thread_pool, const float *queries, const unsigned int &num_queries, const unsigned int &k, unsigned int *indices, float *squared_distances, const double &error_bound=0.0) const;
+
+    // KDTree can throw the following exceptions
+    class Exception {};
+    class InvalidParameterException : public Exception {};
+
+private:
+    // Searches the "k" nearest points with "prune_factor" 1 / (1 + e)^2 and the scratch buffer "offsets" of Dimension() values
+    void SearchNearest(const float *query, const unsigned int &k, const float &prune_factor, float *offsets, unsigned int *indices, float *squared_distances) const;
+
+    // Searches the cell of node "node", at squared distance "cell_distance" and offsets "offsets" per dimension from
+    // "query", for points nearer than the "k" nearest points found so far, of which there are "num_found", at the
+    // positions "positions" in points_ and with "squared_distances", nearest first
+    void Visit(const unsigned int &node, const float *query, const unsigned int &k, const float &prune_factor, const float &cell_distance, float *offsets, unsigned int *positions, float *squared_distances, unsigned int &num_found) const;
+
+    unsigned int num_points_;
+
+    unsigned int dimension_;
+
+    // The number of levels of inner nodes, 2^num_levels_ - 1 inner nodes and 2^num_levels_ leaves
+    unsigned int num_levels_;
+
+    // The splitting dimension and value of every inner node
+    std::vector<unsigned int> split_dimensions_;
+    std::vector<float> split_values_;
+
+    // The points of leaf n are at the positions [leaf_begins_[n], leaf_begins_[n + 1]) of points_
+    std::vector<unsigned int> leaf_begins_;
+
+    // The points in the order of the leaves and the index of each among the points given on construction
+    std::vector<float> points_;
+    std::vector<unsigned int> indices_;
+};
+
+#endif // KDTREE_H
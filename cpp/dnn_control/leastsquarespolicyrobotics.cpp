@@ -2,6 +2,19 @@
 #include "constants.h"
 #include "vector.h"
 #include "lspisimulator.h"
+#include "lspigreedypolicy.h"
+#include "threadpool.h"
+#include "lspisampleset.h"
+#include "lspicheckpoint.h"
+#include "lstdqstatistics.h"
+#include "sparselstdq.h"
+#include "actionblockpolicy.h"
+#include "radialbasisgrid.h"
+#include "tilecoding.h"
+#include "fittedqiteration.h"
+#include "fittedqpolicy.h"
+#include "nearestneighborregressor.h"
+#include "neuralnetworkregressor.h"
 #include "filewriter.h"
 #include "configuration.h"
 
@@ -9,11 +22,13 @@
 #include <eigen3/Eigen/Sparse>
 #include <map>
 #include <boost/tuple/tuple.hpp>
+#include <boost/shared_ptr.hpp>
 #include <iomanip>
 #include <fstream>
+#include <chrono>
 #include <limits>
+#include <algorithm>
 
-#include <thread>
 
 enum MDPState {
     RelativeLocalisation,
@@ -32,15 +47,26 @@ static const double kTransientResponseTime = LSPR_TRANSIENT_RESPONSE_TIME;
 typedef boost::array<double, kSpacecraftStateDimension> LSPIState;
 
 
-static unsigned int kSpacecraftPhiSize = 0;
+// 1, s_i a_k, s_i s_j, a_i a_j
+static const unsigned int kSpacecraftPhiSize = 1 + kSpacecraftStateDimension * 3 + kSpacecraftStateDimension * kSpacecraftStateDimension + 3 * 3;
 
-// (x, a, r, x_prime)
-typedef boost::tuple<LSPIState, unsigned int, double, LSPIState> Sample;
+// Features of a state action pair, fixed size so that no evaluation allocates
+typedef Eigen::Matrix<double, kSpacecraftPhiSize, 1> PhiVector;
+
+// The state only features s_i s_j of one state
+typedef Eigen::Matrix<double, kSpacecraftStateDimension * kSpacecraftStateDimension, 1> StateFeatures;
 
 static std::vector<Vector3D> kSpacecraftActions;
 
+// The thrust levels per axis, the actions are all their combinations
+static std::vector<double> kSpacecraftActionLevels;
+
+// The action only features a_i a_j, one row per action
+static Eigen::Matrix<double, Eigen::Dynamic, 9> kSpacecraftActionFeatures;
+
 static void Init() {
     const std::vector<double> t = {-21.0, -15.0, -8.0, -3.0, -1.0, -0.5, -0.1, 0.0, 0.1, 0.5, 1.0, 3.0, 8.0, 15.0, 21.0};
+    kSpacecraftActionLevels = t;
     for (unsigned int i = 0; i < t.size(); ++i) {
         for (unsigned int j = 0; j < t.size(); ++j) {
             for (unsigned int k = 0; k < t.size(); ++k) {
@@ -49,11 +75,31 @@ static void Init() {
             }
         }
     }
-    kSpacecraftPhiSize = 64;
+
+    kSpacecraftActionFeatures.resize(kSpacecraftActions.size(), 9);
+    for (unsigned int a = 0; a < kSpacecraftActions.size(); ++a) {
+        const Vector3D &action = kSpacecraftActions[a];
+        for (unsigned int i = 0; i < 3; ++i) {
+            for (unsigned int j = 0; j < 3; ++j) {
+                kSpacecraftActionFeatures(a, 3 * i + j) = action[i] * action[j];
+            }
+        }
+    }
+}
+
+static StateFeatures StateOnlyFeatures(const LSPIState &state) {
+    StateFeatures result;
+    for (unsigned int i = 0; i < state.size(); ++i) {
+        for (unsigned int j = 0; j < state.size(); ++j) {
+            result(i * state.size() + j) = state[i] * state[j];
+        }
+    }
+    return result;
 }
 
-static Eigen::VectorXd Phi(const LSPIState &state, const unsigned int &action_index) {
-    Eigen::VectorXd result(kSpacecraftPhiSize);
+// Phi of state "state" whose state only features "state_features" are already known
+static PhiVector Phi(const LSPIState &state, const StateFeatures &state_features, const unsigned int &action_index) {
+    PhiVector result;
 
     unsigned int base = 0;
 
@@ -65,130 +111,409 @@ static Eigen::VectorXd Phi(const LSPIState &state, const unsigned int &action_in
             result(base++) = state[i] * action[k];
         }
     }
-    for (unsigned int i = 0; i < state.size(); ++i) {
-        for (unsigned int j = 0; j < state.size(); ++j) {
-            result(base++) = state[i] * state[j];
-        }
-    }
-    for (unsigned int i = 0; i < 3; ++i) {
-        for (unsigned int j = 0; j < 3; ++j) {
-            result(base++) = action[i] * action[j];
-        }
-    }
+    result.segment<kSpacecraftStateDimension * kSpacecraftStateDimension>(base) = state_features;
+    base += kSpacecraftStateDimension * kSpacecraftStateDimension;
+    result.tail<9>() = kSpacecraftActionFeatures.row(action_index).transpose();
     return result;
 }
 
-static unsigned int Pi(SampleFactory &sample_factory, const LSPIState &state, const Eigen::VectorXd &weights) {
-    std::vector<unsigned int> best_a;
-    double best_q = -std::numeric_limits<double>::max();
-    for (unsigned int a = 0; a < kSpacecraftActions.size(); ++a) {
-        Eigen::VectorXd val_phi = Phi(state, a);
-        Eigen::VectorXd val_phi_t = val_phi.transpose();
+static PhiVector Phi(const LSPIState &state, const unsigned int &action_index) {
+    return Phi(state, StateOnlyFeatures(state), action_index);
+}
 
-        const double q = val_phi_t.dot(weights);
-        if (q > best_q) {
-            best_q = q;
-            best_a.clear();
-            best_a.push_back(a);
-        } else if (q == best_q) {
-            best_a.push_back(a);
-        }
+// Returns the hash of the thrusts of the action set, samples collected with other actions do not fit
+static boost::uint64_t ActionSetHash() {
+    std::vector<double> thrusts;
+    for (unsigned int i = 0; i < kSpacecraftActions.size(); ++i) {
+        thrusts.insert(thrusts.end(), kSpacecraftActions[i].begin(), kSpacecraftActions[i].end());
     }
-    return best_a.at(sample_factory.SampleRandomNatural() % best_a.size());
+    return LSPISampleSet::Hash(thrusts.data(), thrusts.size());
 }
 
-static Eigen::VectorXd LSTDQ(SampleFactory &sample_factory, const std::vector<Sample> &samples, const double &gamma, const Eigen::VectorXd &weights) {
-    Eigen::MatrixXd matrix_A(kSpacecraftPhiSize, kSpacecraftPhiSize);
-    Eigen::VectorXd vector_b(kSpacecraftPhiSize);
+// Converts the stored values "values" of a state of a sample set
+static LSPIState ToLSPIState(const float *values) {
+    LSPIState state;
+    for (unsigned int i = 0; i < kSpacecraftStateDimension; ++i) {
+        state[i] = values[i];
+    }
+    return state;
+}
 
-    for (unsigned int i = 0; i < samples.size(); ++i) {
-        const Sample &sample = samples.at(i);
-        const LSPIState &s = boost::get<0>(sample);
-        const LSPIState &s_prime = boost::get<3>(sample);
-        const unsigned int &a = boost::get<1>(sample);
-        const double &r = boost::get<2>(sample);
+// Number of samples whose part of A and b is accumulated as one matrix product
+static const unsigned int kLSTDQBlockSize = 1024;
+
+// Rows of features of a block of samples
+typedef Eigen::Matrix<double, Eigen::Dynamic, kSpacecraftPhiSize, Eigen::RowMajor> PhiBlock;
+
+// Marks samples without a greedy next action yet
+static const unsigned int kNoAction = std::numeric_limits<unsigned int>::max();
+
+// Sums the partial sums "matrices" and "vectors" pairwise in a fixed order into their first elements, "vectors" may be empty
+static void TreeReduce(ThreadPool &thread_pool, std::vector<Eigen::MatrixXd> &matrices, std::vector<Eigen::VectorXd> &vectors) {
+    const unsigned int num_partials = matrices.size();
+    for (unsigned int stride = 1; stride < num_partials; stride *= 2) {
+        const unsigned int num_pairs = (num_partials + 2 * stride - 1) / (2 * stride);
+        thread_pool.ParallelFor(num_pairs, [&](const unsigned int &pair, const unsigned int &) {
+            const unsigned int first = 2 * stride * pair;
+            const unsigned int second = first + stride;
+            if (second < num_partials) {
+                matrices[first] += matrices[second];
+                if (!vectors.empty()) {
+                    vectors[first] += vectors[second];
+                }
+            }
+        });
+    }
+}
 
-        const Eigen::VectorXd phi_sa = Phi(s, a);
-        const unsigned int a_prime = Pi(sample_factory, s_prime, weights);
-        const Eigen::VectorXd phi_sa_prime = Phi(s_prime, a_prime);
+class IncrementalLSTDQ {
+    /*
+    * This class solves LSTDQ repeatedly on a fixed set of samples. In A = sum phi(s, a) phi(s, a)^T - gamma sum phi(s, a)
+    * phi(s', a')^T and b = sum r phi(s, a) only the second sum depends on the weights, through the greedy next actions
+    * a'. The first sum and b are accumulated once, the second sum is updated by phi(s, a) (phi(s', a'_new) -
+    * phi(s', a'_old))^T for the samples whose a' changed since the previous call. If no a' changed, the previous
+    * solution is returned without a new factorization.
+    *
+    * The samples are processed in blocks on a thread pool, first choosing the greedy next actions and then accumulating
+    * the changes. Block i breaks ties with Philox stream i of a seed drawn per call and the partial sums are reduced in a
+    * fixed order, so the result does not depend on the number of threads.
+    */
+public:
+    IncrementalLSTDQ(ThreadPool &thread_pool, const LSPISampleSet &samples, const double &gamma);
 
-        matrix_A = matrix_A + phi_sa * (phi_sa - gamma * phi_sa_prime).transpose();
-        vector_b = vector_b + r * phi_sa;
-    }
+    // Returns the weights of the Q function of the greedy policy of weights "weights"
+    Eigen::VectorXd Solve(SampleFactory &sample_factory, const Eigen::VectorXd &weights);
 
-    return matrix_A.colPivHouseholderQr().solve(vector_b);
-}
+    // The statistics of the last call of Solve
+    const LSTDQStatistics& Statistics() const;
 
-static void PLSTDQThreadFun(const unsigned int &seed, const std::vector<Sample> &samples, const unsigned int &start_index, const unsigned int &end_index, const double &gamma, const Eigen::VectorXd &weights, Eigen::MatrixXd *matrix_A, Eigen::VectorXd *vector_b) {
-    SampleFactory sample_factory(seed);
+private:
+    ThreadPool &thread_pool_;
 
-    matrix_A->setZero();
-    vector_b->setZero();
+    const LSPISampleSet &samples_;
 
-    for (unsigned int i = start_index; i < end_index; ++i) {
-        const Sample &sample = samples.at(i);
-        const LSPIState &s = boost::get<0>(sample);
-        const LSPIState &s_prime = boost::get<3>(sample);
-        const unsigned int &a = boost::get<1>(sample);
-        const double &r = boost::get<2>(sample);
+    double gamma_;
 
-        const Eigen::VectorXd phi_sa = Phi(s, a);
-        const unsigned int a_prime = Pi(sample_factory, s_prime, weights);
-        const Eigen::VectorXd phi_sa_prime = Phi(s_prime, a_prime);
+    unsigned int num_blocks_;
 
-        *matrix_A = *matrix_A + phi_sa * (phi_sa - gamma * phi_sa_prime).transpose();
-        *vector_b = *vector_b + r * phi_sa;
-    }
+    // sum phi(s, a) phi(s, a)^T, b and sum phi(s, a) phi(s', a')^T of the current next actions
+    Eigen::MatrixXd matrix_phi_phi_;
+    Eigen::VectorXd vector_b_;
+    Eigen::MatrixXd matrix_phi_phi_prime_;
+
+    // The greedy next action of every sample, and the one of the current call of Solve
+    std::vector<unsigned int> next_actions_;
+    std::vector<unsigned int> greedy_actions_;
+
+    LSTDQStatistics statistics_;
+
+    Eigen::MatrixXd matrix_A_;
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> decomposition_;
+    Eigen::VectorXd solution_;
+
+    // Scratch buffers per thread
+    std::vector<LSPIGreedyPolicy> policies_;
+    std::vector<PhiBlock> phis_;
+    std::vector<PhiBlock> phi_prime_differences_;
+
+    // Partial sums per block
+    std::vector<Eigen::MatrixXd> partial_matrices_;
+    std::vector<Eigen::VectorXd> partial_vectors_;
+    std::vector<unsigned int> partial_num_changed_actions_;
+};
+
+IncrementalLSTDQ::IncrementalLSTDQ(ThreadPool &thread_pool, const LSPISampleSet &samples, const double &gamma)
+    : thread_pool_(thread_pool), samples_(samples), gamma_(gamma), statistics_(), decomposition_(kSpacecraftPhiSize, kSpacecraftPhiSize) {
+
+    num_blocks_ = std::max(1u, static_cast<unsigned int>((samples_.Size() + kLSTDQBlockSize - 1) / kLSTDQBlockSize));
+    next_actions_ = std::vector<unsigned int>(samples_.Size(), kNoAction);
+    greedy_actions_ = std::vector<unsigned int>(samples_.Size(), kNoAction);
+
+    const unsigned int num_threads = thread_pool_.NumThreads();
+    policies_ = std::vector<LSPIGreedyPolicy>(num_threads, LSPIGreedyPolicy(kSpacecraftActionLevels, kSpacecraftStateDimension));
+    phis_ = std::vector<PhiBlock>(num_threads, PhiBlock(kLSTDQBlockSize, kSpacecraftPhiSize));
+    phi_prime_differences_ = std::vector<PhiBlock>(num_threads, PhiBlock(kLSTDQBlockSize, kSpacecraftPhiSize));
+
+    partial_matrices_ = std::vector<Eigen::MatrixXd>(num_blocks_, Eigen::MatrixXd::Zero(kSpacecraftPhiSize, kSpacecraftPhiSize));
+    partial_vectors_ = std::vector<Eigen::VectorXd>(num_blocks_, Eigen::VectorXd::Zero(kSpacecraftPhiSize));
+    partial_num_changed_actions_ = std::vector<unsigned int>(num_blocks_, 0);
+
+    thread_pool_.ParallelFor(num_blocks_, [&](const unsigned int &block, const unsigned int &thread_index) {
+        const unsigned int start_index = block * kLSTDQBlockSize;
+        const unsigned int end_index = std::min(static_cast<unsigned int>(samples_.Size()), start_index + kLSTDQBlockSize);
+        const unsigned int num_rows = end_index - start_index;
+        PhiBlock &phi = phis_[thread_index];
+        Eigen::VectorXd rewards(num_rows);
+        for (unsigned int i = start_index; i < end_index; ++i) {
+            phi.row(i - start_index) = Phi(ToLSPIState(samples_.State(i)), samples_.Action(i)).transpose();
+            rewards(i - start_index) = samples_.Reward(i);
+        }
+
+        partial_matrices_[block].noalias() = phi.topRows(num_rows).transpose() * phi.topRows(num_rows);
+        partial_vectors_[block].noalias() = phi.topRows(num_rows).transpose() * rewards;
+    });
+
+    TreeReduce(thread_pool_, partial_matrices_, partial_vectors_);
+    matrix_phi_phi_ = partial_matrices_[0];
+    vector_b_ = partial_vectors_[0];
+    matrix_phi_phi_prime_ = Eigen::MatrixXd::Zero(kSpacecraftPhiSize, kSpacecraftPhiSize);
 }
 
-static Eigen::VectorXd PLSTDQ(SampleFactory &sample_factory, const std::vector<Sample> &samples, const double &gamma, const Eigen::VectorXd &weights) {
-    const unsigned int seed1 = sample_factory.SampleRandomNatural();
-    const unsigned int seed2 = sample_factory.SampleRandomNatural();
+Eigen::VectorXd IncrementalLSTDQ::Solve(SampleFactory &sample_factory, const Eigen::VectorXd &weights) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    statistics_ = LSTDQStatistics();
+    const unsigned int seed = sample_factory.SampleRandomNatural();
+    for (unsigned int t = 0; t < policies_.size(); ++t) {
+        policies_[t].SetWeights(weights);
+    }
 
-    Eigen::MatrixXd matrix1(kSpacecraftPhiSize, kSpacecraftPhiSize);
-    Eigen::MatrixXd matrix2(kSpacecraftPhiSize, kSpacecraftPhiSize);
+    thread_pool_.ParallelFor(num_blocks_, [&](const unsigned int &block, const unsigned int &thread_index) {
+        SampleFactory block_sample_factory(seed, block);
+        LSPIGreedyPolicy &policy = policies_[thread_index];
+
+        const unsigned int start_index = block * kLSTDQBlockSize;
+        const unsigned int end_index = std::min(static_cast<unsigned int>(samples_.Size()), start_index + kLSTDQBlockSize);
+        unsigned int num_changed_actions = 0;
+        for (unsigned int i = start_index; i < end_index; ++i) {
+            const LSPIState s_prime = ToLSPIState(samples_.NextState(i));
+            greedy_actions_[i] = policy.Pi(block_sample_factory, s_prime.data());
+            num_changed_actions += (greedy_actions_[i] != next_actions_[i]);
+        }
+        partial_num_changed_actions_[block] = num_changed_actions;
+    });
 
-    Eigen::VectorXd vector1(kSpacecraftPhiSize);
-    Eigen::VectorXd vector2(kSpacecraftPhiSize);
+    for (unsigned int block = 0; block < num_blocks_; ++block) {
+        statistics_.num_changed_actions += partial_num_changed_actions_[block];
+    }
+    const std::chrono::steady_clock::time_point policy_end = std::chrono::steady_clock::now();
+    statistics_.policy_time = std::chrono::duration<double>(policy_end - start).count();
 
-    Eigen::MatrixXd matrix_A(kSpacecraftPhiSize, kSpacecraftPhiSize);
-    Eigen::VectorXd vector_b(kSpacecraftPhiSize);
+    if (statistics_.num_changed_actions == 0 && solution_.size() > 0) {
+        return solution_;
+    }
 
-    const unsigned half = samples.size()/2;
+    thread_pool_.ParallelFor(num_blocks_, [&](const unsigned int &block, const unsigned int &thread_index) {
+        partial_matrices_[block].setZero();
+        if (partial_num_changed_actions_[block] == 0) {
+            return;
+        }
 
-    std::thread thread1(PLSTDQThreadFun, seed1, samples, 0, half, gamma, weights, &matrix1, &vector1);
-    std::thread thread2(PLSTDQThreadFun, seed2, samples, half, samples.size(), gamma, weights, &matrix2, &vector2);
+        PhiBlock &phi = phis_[thread_index];
+        PhiBlock &phi_prime_difference = phi_prime_differences_[thread_index];
+        const unsigned int start_index = block * kLSTDQBlockSize;
+        const unsigned int end_index = std::min(static_cast<unsigned int>(samples_.Size()), start_index + kLSTDQBlockSize);
+        unsigned int num_rows = 0;
+        for (unsigned int i = start_index; i < end_index; ++i) {
+            const unsigned int a_prime = greedy_actions_[i];
+            const unsigned int previous_a_prime = next_actions_[i];
+            if (a_prime == previous_a_prime) {
+                continue;
+            }
 
-    thread1.join();
-    thread2.join();
+            const LSPIState s_prime = ToLSPIState(samples_.NextState(i));
+            const StateFeatures state_features = StateOnlyFeatures(s_prime);
+            phi.row(num_rows) = Phi(ToLSPIState(samples_.State(i)), samples_.Action(i)).transpose();
+            phi_prime_difference.row(num_rows) = Phi(s_prime, state_features, a_prime).transpose();
+            if (previous_a_prime != kNoAction) {
+                phi_prime_difference.row(num_rows) -= Phi(s_prime, state_features, previous_a_prime).transpose();
+            }
+            next_actions_[i] = a_prime;
+            num_rows++;
+        }
+
+        partial_matrices_[block].noalias() = phi.topRows(num_rows).transpose() * phi_prime_difference.topRows(num_rows);
+    });
+
+    std::vector<Eigen::VectorXd> no_vectors;
+    TreeReduce(thread_pool_, partial_matrices_, no_vectors);
+    matrix_phi_phi_prime_ += partial_matrices_[0];
+    matrix_A_ = matrix_phi_phi_ - gamma_ * matrix_phi_phi_prime_;
+    const std::chrono::steady_clock::time_point accumulation_end = std::chrono::steady_clock::now();
+    statistics_.accumulation_time = std::chrono::duration<double>(accumulation_end - policy_end).count();
+
+    decomposition_.compute(matrix_A_);
+    solution_ = decomposition_.solve(vector_b_);
 
-    matrix_A = matrix1 + matrix2;
-    vector_b = vector1 + vector2;
+    const double norm_b = vector_b_.norm();
+    statistics_.num_non_zeros = matrix_A_.size();
+    statistics_.residual = (matrix_A_ * solution_ - vector_b_).norm() / (norm_b > 0.0 ? norm_b : 1.0);
+    statistics_.solve_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - accumulation_end).count();
 
-    return matrix_A.colPivHouseholderQr().solve(vector_b);
+    return solution_;
 }
 
-static Eigen::VectorXd LSPI(SampleFactory &sample_factory, const std::vector<Sample> &samples, const double &gamma, const double &epsilon, const Eigen::VectorXd &initial_weights) {
+const LSTDQStatistics& IncrementalLSTDQ::Statistics() const {
+    return statistics_;
+}
+
+// Runs LSPI with "lstdq", an IncrementalLSTDQ or a SparseLSTDQ on the samples "samples", from weights "initial_weights"
+// at iteration "first_iteration" until the weights change by at most "epsilon". The metrics of every iteration are
+// written to PATH_TO_LSPI_METRICS_FILE, continuing the file of a resumed run, and if LSPR_CHECKPOINT_EVERY_ITERATION
+// every solution is checkpointed as weights of basis LSPR_BASIS on "samples" to PATH_TO_LSPI_CHECKPOINT_FILE.
+template <typename LSTDQSolver>
+static Eigen::VectorXd IterateLSPI(LSTDQSolver &lstdq, SampleFactory &sample_factory, const LSPISampleSet &samples, const double &epsilon, const Eigen::VectorXd &initial_weights, const unsigned int &first_iteration) {
     Eigen::VectorXd w_prime(initial_weights);
     Eigen::VectorXd w;
 
+    std::ofstream metrics_file(PATH_TO_LSPI_METRICS_FILE, (first_iteration > 0 ? std::ios::app : std::ios::trunc));
+    metrics_file << std::setprecision(10);
+    if (first_iteration == 0) {
+        metrics_file << "# iteration, policy time, accumulation time, solve time, samples per second, changed next actions, nonzeros of A, solver iterations, solver error, residual, norm" << std::endl;
+    }
+
+    // the checkpoints name the samples they were computed on, the hash is only needed if there are checkpoints
+    const unsigned int num_samples = samples.Size();
+    const boost::uint64_t samples_hash = (LSPR_CHECKPOINT_EVERY_ITERATION ? samples.SamplesHash() : 0);
+
     double val_norm = -1.0;
-    unsigned int iteration = 0;
+    unsigned int iteration = first_iteration;
     do {
         time_t rawtime;
         struct tm *timeinfo;
         time(&rawtime);
         timeinfo = localtime(&rawtime);
-        std::cout << std::endl << asctime(timeinfo) << "iteration " << iteration++ << ". Norm : " << val_norm << std::endl;
+        std::cout << std::endl << asctime(timeinfo) << "iteration " << iteration << ". Norm : " << val_norm << std::endl;
 
         w = w_prime;
-        w_prime = PLSTDQ(sample_factory, samples, gamma, w);
+        w_prime = lstdq.Solve(sample_factory, w);
         val_norm = (w - w_prime).norm();
+
+        const LSTDQStatistics &statistics = lstdq.Statistics();
+        const double iteration_time = statistics.policy_time + statistics.accumulation_time + statistics.solve_time;
+        const double samples_per_second = (iteration_time > 0.0 ? num_samples / iteration_time : 0.0);
+        std::cout << "changed next actions : " << statistics.num_changed_actions << ", nonzeros of A : " << statistics.num_non_zeros << ", solver iterations : " << statistics.solver_iterations << ", solver error : " << statistics.solver_error << ", residual : " << statistics.residual << std::endl;
+        std::cout << "policy : " << statistics.policy_time << " s, accumulation : " << statistics.accumulation_time << " s, solve : " << statistics.solve_time << " s, " << samples_per_second << " samples/s" << std::endl;
+        metrics_file << iteration << ",\t" << statistics.policy_time << ",\t" << statistics.accumulation_time << ",\t" << statistics.solve_time << ",\t" << samples_per_second << ",\t" << statistics.num_changed_actions << ",\t" << statistics.num_non_zeros << ",\t" << statistics.solver_iterations << ",\t" << statistics.solver_error << ",\t" << statistics.residual << ",\t" << val_norm << std::endl;
+
+        iteration++;
+        if (LSPR_CHECKPOINT_EVERY_ITERATION) {
+            try {
+                LSPICheckpoint(LSPR_BASIS, iteration, num_samples, samples.StateType(), samples.ActionSetHash(), samples_hash, w_prime).WriteToFile(PATH_TO_LSPI_CHECKPOINT_FILE);
+            } catch (const LSPICheckpoint::Exception &exception) {
+                std::cout << "could not write checkpoint file." << std::endl;
+            }
+        }
     } while (val_norm > epsilon);
 
     return w;
 }
 
+// Sets "weights" and "iteration" to the ones of the checkpoint PATH_TO_LSPI_CHECKPOINT_FILE if LSPR_RESUME_FROM_CHECKPOINT and it fits
+// the basis and the samples "samples"
+static void ResumeFromCheckpoint(const LSPISampleSet &samples, Eigen::VectorXd &weights, unsigned int &iteration) {
+    if (!LSPR_RESUME_FROM_CHECKPOINT) {
+        return;
+    }
+
+    try {
+        const LSPICheckpoint checkpoint = LSPICheckpoint::FromFile(PATH_TO_LSPI_CHECKPOINT_FILE);
+        if (checkpoint.Basis() != LSPR_BASIS || checkpoint.Weights().size() != weights.size()) {
+            std::cout << "checkpoint file does not fit the basis." << std::endl;
+            return;
+        }
+        if (checkpoint.NumSamples() != samples.Size() || checkpoint.StateType() != samples.StateType() || checkpoint.ActionSetHash() != samples.ActionSetHash() || checkpoint.SamplesHash() != samples.SamplesHash()) {
+            std::cout << "checkpoint file does not fit the samples." << std::endl;
+            return;
+        }
+        weights = checkpoint.Weights();
+        iteration = checkpoint.Iteration();
+        std::cout << "resuming from iteration " << iteration << "." << std::endl;
+    } catch (const LSPICheckpoint::Exception &exception) {
+        std::cout << "could not load checkpoint file." << std::endl;
+    }
+}
+
+static Eigen::VectorXd LSPI(ThreadPool &thread_pool, SampleFactory &sample_factory, const LSPISampleSet &samples, const double &gamma, const double &epsilon, const Eigen::VectorXd &initial_weights, const unsigned int &first_iteration) {
+    IncrementalLSTDQ lstdq(thread_pool, samples, gamma);
+    return IterateLSPI(lstdq, sample_factory, samples, epsilon, initial_weights, first_iteration);
+}
+
+// Creates the state basis LSPR_BASIS over the bounding box of the states of "samples"
+static boost::shared_ptr<const LSPIStateBasis> CreateStateBasis(const LSPISampleSet &samples) {
+    std::vector<double> lower(kSpacecraftStateDimension, std::numeric_limits<double>::max());
+    std::vector<double> upper(kSpacecraftStateDimension, -std::numeric_limits<double>::max());
+    for (unsigned int i = 0; i < samples.Size(); ++i) {
+        const float *state = samples.State(i);
+        const float *next_state = samples.NextState(i);
+        for (unsigned int k = 0; k < kSpacecraftStateDimension; ++k) {
+            lower[k] = std::min(lower[k], static_cast<double>(std::min(state[k], next_state[k])));
+            upper[k] = std::max(upper[k], static_cast<double>(std::max(state[k], next_state[k])));
+        }
+    }
+    for (unsigned int k = 0; k < kSpacecraftStateDimension; ++k) {
+        if (!(upper[k] > lower[k])) {
+            lower[k] = -1.0;
+            upper[k] = 1.0;
+        }
+    }
+
+    if (LSPR_BASIS == LSPR_BASIS_RADIAL_BASIS_GRID) {
+        return boost::shared_ptr<const LSPIStateBasis>(new RadialBasisGrid(lower, upper, LSPR_BASIS_GRID_SIZE));
+    } else {
+        return boost::shared_ptr<const LSPIStateBasis>(new TileCoding(lower, upper, LSPR_BASIS_NUM_TILINGS, LSPR_BASIS_GRID_SIZE, LSPR_BASIS_MEMORY_SIZE));
+    }
+}
+
+static Eigen::VectorXd SparseLSPI(ThreadPool &thread_pool, SampleFactory &sample_factory, const ActionBlockBasis &basis, const LSPISampleSet &samples, const double &gamma, const double &epsilon, const Eigen::VectorXd &initial_weights, const unsigned int &first_iteration) {
+    SparseLSTDQ lstdq(thread_pool, basis, samples, gamma, LSPR_BASIS_RIDGE);
+    return IterateLSPI(lstdq, sample_factory, samples, epsilon, initial_weights, first_iteration);
+}
+
+// Returns the regressor LSPR_FQI_REGRESSOR of fitted Q iteration, "seed" initializes a neural network
+static boost::shared_ptr<QRegressor> CreateQRegressor(ThreadPool &thread_pool, const unsigned int &seed) {
+    boost::shared_ptr<QRegressor> regressor;
+    if (LSPR_FQI_REGRESSOR == LSPR_FQI_REGRESSOR_NEURAL_NETWORK) {
+        regressor.reset(new NeuralNetworkRegressor(thread_pool, LSPR_FQI_HIDDEN_UNITS, LSPR_FQI_EPOCHS, LSPR_FQI_BATCH_SIZE, LSPR_FQI_LEARNING_RATE, seed));
+    } else {
+        regressor.reset(new NearestNeighborRegressor(thread_pool, LSPR_FQI_NUM_NEIGHBORS, LSPR_FQI_BANDWIDTH, LSPR_FQI_ERROR_BOUND));
+    }
+    return regressor;
+}
+
+// Runs fitted Q iteration with the regressor LSPR_FQI_REGRESSOR on "samples" until the Q values of the samples change by
+// at most "epsilon" or for LSPR_FQI_MAX_ITERATIONS iterations and writes their greedy policy to
+// PATH_TO_LSPI_FQI_POLICY_FILE. The metrics of every iteration are written to PATH_TO_LSPI_FQI_METRICS_FILE.
+static void FittedQ(ThreadPool &thread_pool, const LSPISampleSet &samples, const double &gamma, const double &epsilon, const unsigned int &seed) {
+    const boost::shared_ptr<QRegressor> regressor = CreateQRegressor(thread_pool, seed);
+
+    // the features of an action are its thrust
+    Eigen::MatrixXd action_features(kSpacecraftActions.size(), 3);
+    for (unsigned int a = 0; a < kSpacecraftActions.size(); ++a) {
+        for (unsigned int k = 0; k < 3; ++k) {
+            action_features(a, k) = kSpacecraftActions[a][k];
+        }
+    }
+
+    std::cout << "preparing fitted Q iteration ... ";
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    FittedQIteration fitted_q_iteration(thread_pool, samples, action_features, *regressor, gamma, LSPR_FQI_NUM_CANDIDATE_ACTIONS, LSPR_FQI_ERROR_BOUND);
+    std::cout << "done in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s." << std::endl;
+
+    std::ofstream metrics_file(PATH_TO_LSPI_FQI_METRICS_FILE);
+    metrics_file << std::setprecision(10);
+    metrics_file << "# iteration, time, samples per second, change of Q values" << std::endl;
+
+    double change = -1.0;
+    do {
+        time_t rawtime;
+        struct tm *timeinfo;
+        time(&rawtime);
+        timeinfo = localtime(&rawtime);
+        std::cout << std::endl << asctime(timeinfo) << "iteration " << fitted_q_iteration.NumIterations() << ". Change : " << change << std::endl;
+
+        const std::chrono::steady_clock::time_point iteration_start = std::chrono::steady_clock::now();
+        change = fitted_q_iteration.Iterate();
+        const double iteration_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - iteration_start).count();
+        const double samples_per_second = (iteration_time > 0.0 ? samples.Size() / iteration_time : 0.0);
+        std::cout << "iteration : " << iteration_time << " s, " << samples_per_second << " samples/s" << std::endl;
+        metrics_file << fitted_q_iteration.NumIterations() - 1 << ",\t" << iteration_time << ",\t" << samples_per_second << ",\t" << change << std::endl;
+    } while (change > epsilon && fitted_q_iteration.NumIterations() < LSPR_FQI_MAX_ITERATIONS);
+
+    std::cout << "creating fitted Q iteration policy file ... ";
+    fitted_q_iteration.Policy().WriteToFile(PATH_TO_LSPI_FQI_POLICY_FILE);
+    std::cout << "done." << std::endl;
+}
+
 static LSPIState SystemStateToLSPIState(SampleFactory &sample_factory, const Asteroid &asteroid, const double &time, const Vector3D &perturbations_acceleration, const SystemState &state, const Vector3D &target_position) {
     LSPIState lspi_state;
 
@@ -243,19 +568,12 @@ static LSPIState SystemStateToLSPIState(SampleFactory &sample_factory, const Ast
             const boost::tuple<Vector3D, Vector3D> result_angular = asteroid.AngularVelocityAndAccelerationAtTime(time);
             const Vector3D &angular_velocity = boost::get<0>(result_angular);
             const Vector3D &angular_acceleration = boost::get<1>(result_angular);
-            const Vector3D euler_acceleration = VectorCrossProduct(angular_acceleration, position);
-            const Vector3D centrifugal_acceleration = VectorCrossProduct(angular_velocity, VectorCrossProduct(angular_velocity, position));
-            const Vector3D coriolis_acceleration = VectorCrossProduct(VectorMul(2.0, angular_velocity), velocity);
-
-            Vector3D acceleration;
+            const Vector3D &external_acceleration = {perturbations_acceleration[0] + gravity_acceleration[0],
+                                                     perturbations_acceleration[1] + gravity_acceleration[1],
+                                                     perturbations_acceleration[2] + gravity_acceleration[2]};
+            Vector3D acceleration = VectorRotatingFrameAcceleration(external_acceleration, angular_velocity, angular_acceleration, position, velocity);
             for (unsigned int i = 0; i < 3; ++i) {
-                double value = perturbations_acceleration[i]
-                        + gravity_acceleration[i]
-                        - coriolis_acceleration[i]
-                        - euler_acceleration[i]
-                        - centrifugal_acceleration[i];
-
-                acceleration[i] = value + value * sample_factory.SampleNormal(0.0, 0.05);
+                acceleration[i] += acceleration[i] * sample_factory.SampleNormal(0.0, 0.05);
             }
 
             const double coef_norm_height = 1.0 / norm_height;
@@ -286,31 +604,39 @@ SystemState InitializeState(SampleFactory &sample_factory, const Vector3D &targe
     return system_state;
 }
 
-static std::vector<Sample> PrepareSamples(SampleFactory &sample_factory, const unsigned int &num_samples, const unsigned int &num_steps) {
-    std::vector<Sample> samples;
+static boost::shared_ptr<LSPISampleSet> PrepareSamples(ThreadPool &thread_pool, SampleFactory &sample_factory, const unsigned int &num_episodes, const unsigned int &num_steps, const std::string &path_to_file="") {
+    boost::shared_ptr<LSPISampleSet> samples(new LSPISampleSet(num_episodes * num_steps, kSpacecraftStateDimension, kMDPState, ActionSetHash(), path_to_file));
 
-    for (unsigned int i = 0; i < num_samples; ++i) {
-        LSPISimulator simulator(sample_factory.SampleRandomNatural());
-        const boost::tuple<Vector3D, double, double, double> sampled_point = sample_factory.SamplePointOutSideEllipsoid(simulator.AsteroidOfSystem().SemiAxis(), 1.1, 4.0);
+    // the seeds are drawn up front, so the samples do not depend on the number of threads
+    std::vector<unsigned int> random_seeds(num_episodes);
+    for (unsigned int i = 0; i < num_episodes; ++i) {
+        random_seeds[i] = sample_factory.SampleRandomNatural();
+    }
+
+    // episode i writes its samples into [i * num_steps, i * num_steps + episode_sizes[i])
+    std::vector<unsigned int> episode_sizes(num_episodes, 0);
+    thread_pool.ParallelFor(num_episodes, [&](const unsigned int &i, const unsigned int &) {
+        LSPISimulator simulator(random_seeds[i]);
+        SampleFactory episode_sample_factory(random_seeds[i], 1);
+        const boost::tuple<Vector3D, double, double, double> sampled_point = episode_sample_factory.SamplePointOutSideEllipsoid(simulator.AsteroidOfSystem().SemiAxis(), 1.1, 4.0);
         const Vector3D &target_position = boost::get<0>(sampled_point);
         const double dt = 1.0 / simulator.ControlFrequency();
 
-        Asteroid &asteroid = simulator.AsteroidOfSystem();
-        SystemState state = InitializeState(sample_factory, target_position, simulator.SpacecraftMaximumMass(), sample_factory.SampleBoolean() * 10.0, sample_factory.SampleBoolean() * 1.0);
-        double time = sample_factory.SampleUniformReal(0.0, 12.0 * 60.0 * 60.0);
+        const Asteroid &asteroid = simulator.AsteroidOfSystem();
+        SystemState state = InitializeState(episode_sample_factory, target_position, simulator.SpacecraftMaximumMass(), episode_sample_factory.SampleBoolean() * 10.0, episode_sample_factory.SampleBoolean() * 1.0);
+        double time = episode_sample_factory.SampleUniformReal(0.0, 12.0 * 60.0 * 60.0);
         Vector3D perturbations_acceleration = simulator.RefreshPerturbationsAcceleration();
-        LSPIState lspi_state = SystemStateToLSPIState(sample_factory, asteroid, time, perturbations_acceleration, state, target_position);
+        LSPIState lspi_state = SystemStateToLSPIState(episode_sample_factory, asteroid, time, perturbations_acceleration, state, target_position);
 
         for (unsigned int j = 0; j < num_steps; ++j) {
             const Vector3D &position = {state[0], state[1], state[2]};
             const Vector3D &velocity = {state[3], state[4], state[5]};
 
-            const unsigned int a = sample_factory.SampleUniformNatural(0, kSpacecraftActions.size() - 1);
+            const unsigned int a = episode_sample_factory.SampleUniformNatural(0, kSpacecraftActions.size() - 1);
             const Vector3D &thrust = kSpacecraftActions[a];
             const boost::tuple<SystemState, Vector3D, double, bool> result = simulator.NextState(state, time, thrust);
             const bool exception = boost::get<3>(result);
             if (exception) {
-                std::cout << "sample sequence stopped." << std::endl;
                 break;
             }
             const SystemState &next_state = boost::get<0>(result);
@@ -320,7 +646,7 @@ static std::vector<Sample> PrepareSamples(SampleFactory &sample_factory, const u
             const Vector3D &next_velocity = {next_state[3], next_state[4], next_state[5]};
 
             perturbations_acceleration = simulator.RefreshPerturbationsAcceleration();
-            const LSPIState next_lspi_state = SystemStateToLSPIState(sample_factory, asteroid, time, perturbations_acceleration, next_state, target_position);
+            const LSPIState next_lspi_state = SystemStateToLSPIState(episode_sample_factory, asteroid, time, perturbations_acceleration, next_state, target_position);
 
             const double delta_p1 = VectorNorm(VectorSub(target_position, position));
             const double delta_p2 = VectorNorm(VectorSub(target_position, next_position));
@@ -329,105 +655,202 @@ static std::vector<Sample> PrepareSamples(SampleFactory &sample_factory, const u
 
             const double r = delta_p1 - delta_p2 + delta_v1 - delta_v2;
 
-            samples.push_back(boost::make_tuple(lspi_state, a, r, next_lspi_state));
+            samples->SetSample(i * num_steps + j, lspi_state.data(), a, r, next_lspi_state.data());
+            episode_sizes[i]++;
 
             state = next_state;
             lspi_state = next_lspi_state;
         }
+    });
+
+    unsigned int num_stopped_episodes = 0;
+    for (unsigned int i = 0; i < num_episodes; ++i) {
+        num_stopped_episodes += (episode_sizes[i] < num_steps);
+    }
+    if (num_stopped_episodes > 0) {
+        std::cout << num_stopped_episodes << " sample sequences stopped." << std::endl;
     }
+
+    samples->Compact(episode_sizes, num_steps);
+
     return samples;
 }
 
 
-static boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D> > EvaluatePolicy(SampleFactory &sample_factory, const Eigen::VectorXd &weights, LSPISimulator &simulator, const Vector3D &target_position, const unsigned int &num_steps, const bool &initial_offset_non_zero, const bool &initial_velocity_non_zero) {
-    std::vector<double> evaluated_times(num_steps + 1);
-    std::vector<double> evaluated_masses(num_steps + 1);
-    std::vector<Vector3D> evaluated_positions(num_steps + 1);
-    std::vector<Vector3D> evaluated_heights(num_steps + 1);
-    std::vector<Vector3D> evaluated_velocities(num_steps + 1);
-    std::vector<Vector3D> evaluated_thrusts(num_steps + 1);
-    std::vector<Vector3D> evaluated_accelerations(num_steps + 1);
-
-    Asteroid &asteroid = simulator.AsteroidOfSystem();
-    const double dt = 1.0 / simulator.ControlFrequency();
+// (times, masses, positions, heights, velocities, thrusts, accelerations) of a simulation of a policy
+typedef boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D> > PolicyEvaluation;
+
+// Simulates the greedy policy "policy", an LSPIGreedyPolicy, an ActionBlockPolicy or a FittedQPolicy, for "num_steps"
+// steps with every simulator of "simulators" and the target position of the same index. The simulations run in
+// lockstep, so the actions of all running simulations are chosen as one batch and their ticks are integrated together by
+// LSPISimulator::NextStates, every simulation draws from its simulator's SampleFactory in the same order as when
+// simulated alone.
+template <typename Policy>
+static std::vector<PolicyEvaluation> EvaluatePolicy(Policy &policy, const std::vector<LSPISimulator*> &simulators, const std::vector<Vector3D> &target_positions, const unsigned int &num_steps, const bool &initial_offset_non_zero, const bool &initial_velocity_non_zero) {
+    const unsigned int num_simulations = simulators.size();
+
+    std::vector<PolicyEvaluation> evaluations(num_simulations);
+    std::vector<SystemState> states(num_simulations);
+    std::vector<double> times(num_simulations, 0.0);
+    std::vector<double> observed_times(num_simulations, 0.0);
+    std::vector<Vector3D> thrusts(num_simulations);
+    std::vector<Vector3D> perturbations_accelerations(num_simulations);
+    std::vector<Vector3D> heights(num_simulations);
+    std::vector<unsigned int> stopped_iterations(num_simulations, num_steps);
+
+    for (unsigned int i = 0; i < num_simulations; ++i) {
+        LSPISimulator &simulator = *simulators[i];
+        SampleFactory &sample_factory = simulator.SampleFactoryOfSystem();
+        PolicyEvaluation &evaluation = evaluations[i];
+        boost::get<0>(evaluation).resize(num_steps + 1);
+        boost::get<1>(evaluation).resize(num_steps + 1);
+        boost::get<2>(evaluation).resize(num_steps + 1);
+        boost::get<3>(evaluation).resize(num_steps + 1);
+        boost::get<4>(evaluation).resize(num_steps + 1);
+        boost::get<5>(evaluation).resize(num_steps + 1);
+        boost::get<6>(evaluation).resize(num_steps + 1);
+
+        if (initial_velocity_non_zero) {
+            states[i] = InitializeState(sample_factory, target_positions[i], simulator.SpacecraftMaximumMass(), initial_offset_non_zero * 3.0, 0.3);
+        } else {
+            states[i] = InitializeState(sample_factory, target_positions[i], simulator.SpacecraftMaximumMass(),  initial_offset_non_zero * 3.0, 0.0);
+        }
+        thrusts[i] = {0.0, 0.0, 0.0};
+        perturbations_accelerations[i] = simulator.RefreshPerturbationsAcceleration();
+    }
 
-    SystemState state;
-    if (initial_velocity_non_zero) {
-        state = InitializeState(sample_factory, target_position, simulator.SpacecraftMaximumMass(), initial_offset_non_zero * 3.0, 0.3);
-    } else {
-        state = InitializeState(sample_factory, target_position, simulator.SpacecraftMaximumMass(),  initial_offset_non_zero * 3.0, 0.0);
+    // the indices of the simulations which did not crash or run out of fuel, and their states and sample factories as a batch
+    std::vector<unsigned int> running(num_simulations);
+    for (unsigned int i = 0; i < num_simulations; ++i) {
+        running[i] = i;
     }
+    LSPIGreedyPolicy::StateMatrix batch_states;
+    std::vector<SampleFactory*> batch_sample_factories;
+    std::vector<unsigned int> batch_actions;
+    std::vector<LSPISimulator*> batch_simulators;
+    std::vector<SystemState> batch_system_states;
+    std::vector<double> batch_times;
+    std::vector<Vector3D> batch_thrusts;
+
+    for (unsigned int iteration = 0; iteration < num_steps && !running.empty(); ++iteration) {
+        batch_states.resize(running.size(), kSpacecraftStateDimension);
+        batch_sample_factories.resize(running.size());
+        for (unsigned int k = 0; k < running.size(); ++k) {
+            const unsigned int i = running[k];
+            LSPISimulator &simulator = *simulators[i];
+            const Asteroid &asteroid = simulator.AsteroidOfSystem();
+            const SystemState &state = states[i];
+            const Vector3D &position = {state[0], state[1], state[2]};
 
-    double time = 0.0;
+            const Vector3D surface_point = boost::get<0>(asteroid.NearestPointOnSurfaceToPosition(position));
+            heights[i] = {position[0] - surface_point[0], position[1] - surface_point[1], position[2] - surface_point[2]};
 
-    Vector3D thrust = {0.0, 0.0, 0.0};
+            const LSPIState lspi_state = SystemStateToLSPIState(simulator.SampleFactoryOfSystem(), asteroid, times[i], perturbations_accelerations[i], state, target_positions[i]);
+            for (unsigned int j = 0; j < kSpacecraftStateDimension; ++j) {
+                batch_states(k, j) = lspi_state[j];
+            }
+            batch_sample_factories[k] = &simulator.SampleFactoryOfSystem();
+        }
+
+        policy.Pi(batch_sample_factories, batch_states, batch_actions);
+
+        batch_simulators.resize(running.size());
+        batch_system_states.resize(running.size());
+        batch_times.resize(running.size());
+        batch_thrusts.resize(running.size());
+        for (unsigned int k = 0; k < running.size(); ++k) {
+            const unsigned int i = running[k];
+            thrusts[i] = kSpacecraftActions[batch_actions[k]];
+            batch_simulators[k] = simulators[i];
+            batch_system_states[k] = states[i];
+            batch_times[k] = times[i];
+            batch_thrusts[k] = thrusts[i];
+        }
+        const std::vector<boost::tuple<SystemState, Vector3D, double, bool> > results = LSPISimulator::NextStates(batch_simulators, batch_system_states, batch_times, batch_thrusts);
+
+        unsigned int num_running = 0;
+        for (unsigned int k = 0; k < running.size(); ++k) {
+            const unsigned int i = running[k];
+            LSPISimulator &simulator = *simulators[i];
+            PolicyEvaluation &evaluation = evaluations[i];
+            const SystemState &state = states[i];
+            const Vector3D &position = {state[0], state[1], state[2]};
+            const Vector3D &velocity = {state[3], state[4], state[5]};
+            const double &mass = state[6];
+
+            const boost::tuple<SystemState, Vector3D, double, bool> &result = results[k];
+            const Vector3D &acceleration = boost::get<1>(result);
+            observed_times[i] = boost::get<2>(result);
+            const bool exception_thrown = boost::get<3>(result);
+
+            boost::get<0>(evaluation).at(iteration) = times[i];
+            boost::get<1>(evaluation).at(iteration) = mass;
+            boost::get<2>(evaluation).at(iteration) = position;
+            boost::get<3>(evaluation).at(iteration) = heights[i];
+            boost::get<4>(evaluation).at(iteration) = velocity;
+            boost::get<5>(evaluation).at(iteration) = thrusts[i];
+            boost::get<6>(evaluation).at(iteration) = acceleration;
+
+            states[i] = boost::get<0>(result);
+            times[i] += 1.0 / simulator.ControlFrequency();
+            perturbations_accelerations[i] = simulator.RefreshPerturbationsAcceleration();
+            if (exception_thrown) {
+                stopped_iterations[i] = iteration;
+            } else {
+                running[num_running++] = i;
+            }
+        }
+        running.resize(num_running);
+    }
+
+    for (unsigned int i = 0; i < num_simulations; ++i) {
+        PolicyEvaluation &evaluation = evaluations[i];
+        if (stopped_iterations[i] < num_steps) {
+            const unsigned int new_size = stopped_iterations[i] + 2;
+            boost::get<0>(evaluation).resize(new_size);
+            boost::get<1>(evaluation).resize(new_size);
+            boost::get<2>(evaluation).resize(new_size);
+            boost::get<4>(evaluation).resize(new_size);
+            boost::get<3>(evaluation).resize(new_size);
+            boost::get<5>(evaluation).resize(new_size);
+        }
 
-    unsigned int iteration;
-    bool exception_thrown = false;
-    double time_observer = 0.0;
-    Vector3D perturbations_acceleration = simulator.RefreshPerturbationsAcceleration();
-    for (iteration = 0; iteration < num_steps; ++iteration) {
+        const SystemState &state = states[i];
         const Vector3D &position = {state[0], state[1], state[2]};
         const Vector3D &velocity = {state[3], state[4], state[5]};
         const double &mass = state[6];
 
-        const Vector3D surface_point = boost::get<0>(asteroid.NearestPointOnSurfaceToPosition(position));
-        const Vector3D &height = {position[0] - surface_point[0], position[1] - surface_point[1], position[2] - surface_point[2]};
+        const Vector3D surf_pos = boost::get<0>(simulators[i]->AsteroidOfSystem().NearestPointOnSurfaceToPosition(position));
+        const Vector3D &height = {position[0] - surf_pos[0], position[1] - surf_pos[1], position[2] - surf_pos[2]};
 
-        const LSPIState lspi_state = SystemStateToLSPIState(sample_factory, asteroid, time, perturbations_acceleration, state, target_position);
-
-        thrust = kSpacecraftActions[Pi(sample_factory, lspi_state, weights)];
-
-        const boost::tuple<SystemState, Vector3D, double, bool> result  = simulator.NextState(state, time, thrust);
-        const SystemState next_state = boost::get<0>(result);
-        const Vector3D &acceleration = boost::get<1>(result);
-        time_observer = boost::get<2>(result);
-        exception_thrown = boost::get<3>(result);
-
-        evaluated_times.at(iteration) = time;
-        evaluated_masses.at(iteration) = mass;
-        evaluated_positions.at(iteration) = position;
-        evaluated_heights.at(iteration) = height;
-        evaluated_velocities.at(iteration) = velocity;
-        evaluated_thrusts.at(iteration) = thrust;
-        evaluated_accelerations.at(iteration) = acceleration;
-
-        state = next_state;
-        time += dt;
-        perturbations_acceleration = simulator.RefreshPerturbationsAcceleration();
-        if (exception_thrown) {
-            std::cout << "spacecraft crash or out of fuel." << std::endl;
-            break;
-        }
-    }
-    if(exception_thrown) {
-        const unsigned int new_size = iteration + 2;
-        evaluated_times.resize(new_size);
-        evaluated_masses.resize(new_size);
-        evaluated_positions.resize(new_size);
-        evaluated_velocities.resize(new_size);
-        evaluated_heights.resize(new_size);
-        evaluated_thrusts.resize(new_size);
+        boost::get<0>(evaluation).back() = observed_times[i];
+        boost::get<1>(evaluation).back() = mass;
+        boost::get<2>(evaluation).back() = position;
+        boost::get<4>(evaluation).back() = velocity;
+        boost::get<3>(evaluation).back() = height;
+        boost::get<5>(evaluation).back() = thrusts[i];
     }
 
-    const Vector3D &position = {state[0], state[1], state[2]};
-    const Vector3D &velocity = {state[3], state[4], state[5]};
-    const double &mass = state[6];
-
-    const Vector3D surf_pos = boost::get<0>(asteroid.NearestPointOnSurfaceToPosition(position));
-    const Vector3D &height = {position[0] - surf_pos[0], position[1] - surf_pos[1], position[2] - surf_pos[2]};
+    return evaluations;
+}
 
-    evaluated_times.back() = time_observer;
-    evaluated_masses.back() = mass;
-    evaluated_positions.back() = position;
-    evaluated_velocities.back() = velocity;
-    evaluated_heights.back() = height;
-    evaluated_thrusts.back() = thrust;
+// Simulates the greedy policy of the LSPI weights "weights", every call has its own policy since its Q values are a scratch buffer
+static std::vector<PolicyEvaluation> EvaluatePolicy(const Eigen::VectorXd &weights, const std::vector<LSPISimulator*> &simulators, const std::vector<Vector3D> &target_positions, const unsigned int &num_steps, const bool &initial_offset_non_zero, const bool &initial_velocity_non_zero) {
+    LSPIGreedyPolicy policy(kSpacecraftActionLevels, kSpacecraftStateDimension);
+    policy.SetWeights(weights);
+    return EvaluatePolicy(policy, simulators, target_positions, num_steps, initial_offset_non_zero, initial_velocity_non_zero);
+}
 
-    return boost::make_tuple(evaluated_times, evaluated_masses, evaluated_positions, evaluated_heights, evaluated_velocities, evaluated_thrusts, evaluated_accelerations);
+// Returns true if the simulation of "evaluation" of "num_steps" steps ended by a crash or running out of fuel
+static bool EvaluationStopped(const PolicyEvaluation &evaluation, const unsigned int &num_steps) {
+    return boost::get<0>(evaluation).size() < num_steps + 1;
 }
 
-static boost::tuple<std::vector<unsigned int>, std::vector<double>, std::vector<std::pair<double, double> >, std::vector<std::pair<double, double> > > PostEvaluateLSPIController(const Eigen::VectorXd &controller_weights, const unsigned int &start_seed, const bool &non_zero_initial_offset, const bool &non_zero_initial_velocity, const double &transient_response_time, const std::vector<unsigned int> &random_seeds=std::vector<unsigned int>()) {
+// Simulates the controller "controller", the weights of LSPI, an ActionBlockPolicy or a FittedQPolicy, on 10000 tests
+// from "start_seed" or on the tests "random_seeds" and returns the seeds, the mean errors, the minimal and maximal
+// errors and the fuel consumptions
+template <typename Controller>
+static boost::tuple<std::vector<unsigned int>, std::vector<double>, std::vector<std::pair<double, double> >, std::vector<std::pair<double, double> > > PostEvaluateLSPIController(ThreadPool &thread_pool, const Controller &controller, const unsigned int &start_seed, const bool &non_zero_initial_offset, const bool &non_zero_initial_velocity, const double &transient_response_time, const std::vector<unsigned int> &random_seeds=std::vector<unsigned int>()) {
     unsigned int num_tests = random_seeds.size();
     std::vector<unsigned int> used_random_seeds;
     if (num_tests == 0) {
@@ -443,78 +866,104 @@ static boost::tuple<std::vector<unsigned int>, std::vector<double>, std::vector<
     std::vector<double> mean_errors(num_tests, 0.0);
     std::vector<std::pair<double, double> > min_max_errors(num_tests);
     std::vector<std::pair<double, double> > fuel_consumptions(num_tests);
+    std::vector<unsigned int> stopped_tests(num_tests, 0);
 
     const double test_time = 3600.0;
 
-    for (unsigned int i = 0; i < num_tests; ++i) {
-        std::cout << "test " << (i+1) << ":" << std::endl;
-        const unsigned int current_seed = used_random_seeds.at(i);
-        LSPISimulator simulator(current_seed);
-        SampleFactory &sample_factory = simulator.SampleFactoryOfSystem();
-        const boost::tuple<Vector3D, double, double, double> sampled_point = sample_factory.SamplePointOutSideEllipsoid(simulator.AsteroidOfSystem().SemiAxis(), 1.1, 4.0);
-        const Vector3D &target_position = boost::get<0>(sampled_point);
-
-        const boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D> > result = EvaluatePolicy(sample_factory, controller_weights, simulator, target_position, test_time * simulator.ControlFrequency(), non_zero_initial_offset, non_zero_initial_velocity);
-        const std::vector<double> &evaluated_times = boost::get<0>(result);
-        const std::vector<double> &evaluated_masses = boost::get<1>(result);
-        const std::vector<Vector3D> &evaluated_positions = boost::get<2>(result);
-        const std::vector<Vector3D> &evaluated_accelerations = boost::get<6>(result);
-
-        const unsigned int num_samples = evaluated_times.size();
-
-        double predicted_fuel = 0.0;
-        const double dt = 1.0 / simulator.ControlFrequency();
-        const double coef = 1.0 / (simulator.SpacecraftSpecificImpulse() * kEarthAcceleration);
-        int index = -1;
-        for (unsigned int i = 0; i < num_samples; ++i) {
-            if (evaluated_times.at(i) >= transient_response_time) {
-                if (index == -1) {
-                    index = i;
-                }
-                predicted_fuel += dt * VectorNorm(evaluated_accelerations.at(i)) * evaluated_masses.at(i) * coef;
-            }
+    // lane l simulates the tests [l * LSPR_EVALUATION_LANE_SIZE, (l + 1) * LSPR_EVALUATION_LANE_SIZE) in lockstep
+    const unsigned int num_lanes = (num_tests + LSPR_EVALUATION_LANE_SIZE - 1) / LSPR_EVALUATION_LANE_SIZE;
+    thread_pool.ParallelFor(num_lanes, [&](const unsigned int &lane, const unsigned int &) {
+        const unsigned int begin_test = lane * LSPR_EVALUATION_LANE_SIZE;
+        const unsigned int end_test = std::min(num_tests, begin_test + LSPR_EVALUATION_LANE_SIZE);
+
+        std::vector<boost::shared_ptr<LSPISimulator> > lane_simulators;
+        std::vector<LSPISimulator*> simulators;
+        std::vector<Vector3D> target_positions;
+        for (unsigned int i = begin_test; i < end_test; ++i) {
+            lane_simulators.push_back(boost::shared_ptr<LSPISimulator>(new LSPISimulator(used_random_seeds.at(i))));
+            LSPISimulator &simulator = *lane_simulators.back();
+            const boost::tuple<Vector3D, double, double, double> sampled_point = simulator.SampleFactoryOfSystem().SamplePointOutSideEllipsoid(simulator.AsteroidOfSystem().SemiAxis(), 1.1, 4.0);
+            simulators.push_back(&simulator);
+            target_positions.push_back(boost::get<0>(sampled_point));
         }
-        double used_fuel = evaluated_masses.at(index) - evaluated_masses.at(num_samples - 1);
 
-        double mean_error = 0.0;
-        double min_error = std::numeric_limits<double>::max();
-        double max_error = -std::numeric_limits<double>::max();
-
-        unsigned int considered_samples = 0;
-        for (unsigned int i = 0; i < num_samples; ++i) {
-            if (evaluated_times.at(i) >= transient_response_time) {
-                const double error = VectorNorm(VectorSub(target_position, evaluated_positions.at(i)));
-                if (error > max_error) {
-                    max_error = error;
-                    if (min_error == std::numeric_limits<double>::max()) {
-                        min_error = max_error;
+        const unsigned int num_steps = test_time * simulators.front()->ControlFrequency();
+        const std::vector<PolicyEvaluation> evaluations = EvaluatePolicy(controller, simulators, target_positions, num_steps, non_zero_initial_offset, non_zero_initial_velocity);
+
+        for (unsigned int test = begin_test; test < end_test; ++test) {
+            const PolicyEvaluation &result = evaluations.at(test - begin_test);
+            const LSPISimulator &simulator = *simulators.at(test - begin_test);
+            const Vector3D &target_position = target_positions.at(test - begin_test);
+            const std::vector<double> &evaluated_times = boost::get<0>(result);
+            const std::vector<double> &evaluated_masses = boost::get<1>(result);
+            const std::vector<Vector3D> &evaluated_positions = boost::get<2>(result);
+            const std::vector<Vector3D> &evaluated_accelerations = boost::get<6>(result);
+
+            stopped_tests.at(test) = EvaluationStopped(result, num_steps);
+
+            const unsigned int num_samples = evaluated_times.size();
+
+            double predicted_fuel = 0.0;
+            const double dt = 1.0 / simulator.ControlFrequency();
+            const double coef = 1.0 / (simulator.SpacecraftSpecificImpulse() * kEarthAcceleration);
+            int index = -1;
+            for (unsigned int i = 0; i < num_samples; ++i) {
+                if (evaluated_times.at(i) >= transient_response_time) {
+                    if (index == -1) {
+                        index = i;
                     }
-                } else if(error < min_error) {
-                    min_error = error;
-                    if (max_error == -std::numeric_limits<double>::max()){
-                        max_error = min_error;
+                    predicted_fuel += dt * VectorNorm(evaluated_accelerations.at(i)) * evaluated_masses.at(i) * coef;
+                }
+            }
+            double used_fuel = evaluated_masses.at(index) - evaluated_masses.at(num_samples - 1);
+
+            double mean_error = 0.0;
+            double min_error = std::numeric_limits<double>::max();
+            double max_error = -std::numeric_limits<double>::max();
+
+            unsigned int considered_samples = 0;
+            for (unsigned int i = 0; i < num_samples; ++i) {
+                if (evaluated_times.at(i) >= transient_response_time) {
+                    const double error = VectorNorm(VectorSub(target_position, evaluated_positions.at(i)));
+                    if (error > max_error) {
+                        max_error = error;
+                        if (min_error == std::numeric_limits<double>::max()) {
+                            min_error = max_error;
+                        }
+                    } else if(error < min_error) {
+                        min_error = error;
+                        if (max_error == -std::numeric_limits<double>::max()){
+                            max_error = min_error;
+                        }
                     }
+                    mean_error += error;
+                    considered_samples++;
                 }
-                mean_error += error;
-                considered_samples++;
             }
+            mean_error /= considered_samples;
+            mean_errors.at(test) = mean_error;
+            min_max_errors.at(test).first = min_error;
+            min_max_errors.at(test).second = max_error;
+            fuel_consumptions.at(test).first = predicted_fuel;
+            fuel_consumptions.at(test).second = used_fuel;
         }
-        mean_error /= considered_samples;
-        mean_errors.at(i) = mean_error;
-        min_max_errors.at(i).first = min_error;
-        min_max_errors.at(i).second = max_error;
-        fuel_consumptions.at(i).first = predicted_fuel;
-        fuel_consumptions.at(i).second = used_fuel;
+    });
+
+    unsigned int num_stopped_tests = 0;
+    for (unsigned int i = 0; i < num_tests; ++i) {
+        num_stopped_tests += stopped_tests[i];
+    }
+    if (num_stopped_tests > 0) {
+        std::cout << num_stopped_tests << " tests stopped by a spacecraft crash or running out of fuel." << std::endl;
     }
 
     return boost::make_tuple(used_random_seeds, mean_errors, min_max_errors, fuel_consumptions);
 }
 
-void TestLeastSquaresPolicyController(const unsigned int &random_seed) {
-    ConfigurationLSPI();
-
-    Init();
-
+// Simulates the controller "controller", the weights of LSPI, an ActionBlockPolicy or a FittedQPolicy, from the worst
+// case seed and writes the trajectory and the evaluation, then post evaluates it on "thread_pool" with tests from "random_seed"
+template <typename Controller>
+static void TestController(const Controller &controller, ThreadPool &thread_pool, const unsigned int &random_seed) {
     const unsigned int worst_case_seed = 457110846;
 
     const double test_time = 2.0 * 24.0 * 60.0 * 60.0;
@@ -524,18 +973,12 @@ void TestLeastSquaresPolicyController(const unsigned int &random_seed) {
     const boost::tuple<Vector3D, double, double, double> sampled_point = sample_factory.SamplePointOutSideEllipsoid(simulator.AsteroidOfSystem().SemiAxis(), 1.1, 4.0);
     const Vector3D &target_position = boost::get<0>(sampled_point);
 
-    Eigen::VectorXd weights(kSpacecraftPhiSize);
-
-    std::ifstream weight_file(PATH_TO_LSPI_WEIGHT_VECTOR_FILE);
-    double weight = 0;
-    unsigned int i = 0;
-    while (weight_file >> weight) {
-        weights[i++] = weight;
-    }
-    weight_file.close();
-
     std::cout << "Simulating LSPI controller ... ";
-    const boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D> > result = EvaluatePolicy(sample_factory, weights, simulator, target_position, test_time * simulator.ControlFrequency(), kNonZeroInitialOffset, kNonZeroInitialVelocity);
+    const unsigned int num_steps = test_time * simulator.ControlFrequency();
+    const PolicyEvaluation result = EvaluatePolicy(controller, std::vector<LSPISimulator*>(1, &simulator), std::vector<Vector3D>(1, target_position), num_steps, kNonZeroInitialOffset, kNonZeroInitialVelocity).front();
+    if (EvaluationStopped(result, num_steps)) {
+        std::cout << "spacecraft crash or out of fuel." << std::endl;
+    }
     const std::vector<double> &times = boost::get<0>(result);
     const std::vector<Vector3D> &positions = boost::get<2>(result);
     const std::vector<Vector3D> &heights = boost::get<3>(result);
@@ -553,9 +996,8 @@ void TestLeastSquaresPolicyController(const unsigned int &random_seed) {
     writer_evaluation.CreateEvaluationFile(random_seed, target_position, simulator.AsteroidOfSystem(), times, positions, velocities, thrusts);
     std::cout << "done." << std::endl;
 
-
-    std::cout << "Performing post evaluation ... ";
-    const boost::tuple<std::vector<unsigned int>, std::vector<double>, std::vector<std::pair<double, double> >, std::vector<std::pair<double, double> > > post_evaluation = PostEvaluateLSPIController(weights, random_seed, kNonZeroInitialOffset, kNonZeroInitialVelocity, kTransientResponseTime);
+    std::cout << "Performing post evaluation on " << thread_pool.NumThreads() << " threads ... ";
+    const boost::tuple<std::vector<unsigned int>, std::vector<double>, std::vector<std::pair<double, double> >, std::vector<std::pair<double, double> > > post_evaluation = PostEvaluateLSPIController(thread_pool, controller, random_seed, kNonZeroInitialOffset, kNonZeroInitialVelocity, kTransientResponseTime);
     const std::vector<unsigned int> &random_seeds = boost::get<0>(post_evaluation);
     const std::vector<double> &mean_errors = boost::get<1>(post_evaluation);
     const std::vector<std::pair<double, double > > &min_max_errors = boost::get<2>(post_evaluation);
@@ -567,6 +1009,62 @@ void TestLeastSquaresPolicyController(const unsigned int &random_seed) {
     std::cout << "done." << std::endl;
 }
 
+void TestLeastSquaresPolicyController(const unsigned int &random_seed) {
+    ConfigurationLSPI();
+
+    Init();
+
+    ThreadPool thread_pool(LSPR_NUM_THREADS);
+
+    if (LSPR_ENGINE == LSPR_ENGINE_FITTED_Q_ITERATION) {
+        const boost::shared_ptr<QRegressor> regressor = CreateQRegressor(thread_pool, random_seed);
+        boost::shared_ptr<FittedQPolicy> policy;
+        try {
+            policy = FittedQPolicy::FromFile(thread_pool, PATH_TO_LSPI_FQI_POLICY_FILE, *regressor);
+        } catch (const FittedQPolicy::Exception &exception) {
+            std::cout << "could not load fitted Q iteration policy file." << std::endl;
+            return;
+        } catch (const QRegressor::Exception &exception) {
+            std::cout << "fitted Q iteration policy file does not fit the regressor." << std::endl;
+            return;
+        }
+        if (policy->StateType() != kMDPState || policy->StateDimension() != kSpacecraftStateDimension || policy->ActionSetHash() != ActionSetHash()) {
+            std::cout << "fitted Q iteration policy file does not fit the MDP." << std::endl;
+            return;
+        }
+        TestController(*policy, thread_pool, random_seed);
+        return;
+    }
+
+    if (LSPR_BASIS != LSPR_BASIS_QUADRATIC) {
+        boost::shared_ptr<ActionBlockPolicy> policy;
+        try {
+            policy = ActionBlockPolicy::FromFile(PATH_TO_LSPI_BASIS_POLICY_FILE);
+        } catch (const ActionBlockPolicy::Exception &exception) {
+            std::cout << "could not load lspi basis policy file." << std::endl;
+            return;
+        }
+        if (policy->StateType() != kMDPState || policy->StateDimension() != kSpacecraftStateDimension || policy->ActionSetHash() != ActionSetHash()) {
+            std::cout << "lspi basis policy file does not fit the MDP." << std::endl;
+            return;
+        }
+        TestController(*policy, thread_pool, random_seed);
+        return;
+    }
+
+    Eigen::VectorXd weights(kSpacecraftPhiSize);
+
+    std::ifstream weight_file(PATH_TO_LSPI_WEIGHT_VECTOR_FILE);
+    double weight = 0;
+    unsigned int i = 0;
+    while (weight_file >> weight) {
+        weights[i++] = weight;
+    }
+    weight_file.close();
+
+    TestController(weights, thread_pool, random_seed);
+}
+
 void TrainLeastSquaresPolicyController() {
     ConfigurationLSPI();
 
@@ -581,15 +1079,54 @@ void TrainLeastSquaresPolicyController() {
 
     SampleFactory sample_factory(rand());
 
-    const std::vector<Sample> samples = PrepareSamples(sample_factory, num_samples, num_steps);
+    ThreadPool thread_pool(LSPR_NUM_THREADS);
+    std::cout << "running on " << thread_pool.NumThreads() << " threads." << std::endl;
+
+    boost::shared_ptr<LSPISampleSet> samples;
+    if (LSPR_REUSE_SAMPLES_FILE) {
+        try {
+            samples = LSPISampleSet::FromFile(PATH_TO_LSPI_SAMPLES_FILE);
+            if (samples->StateType() != kMDPState || samples->StateDimension() != kSpacecraftStateDimension || samples->ActionSetHash() != ActionSetHash()) {
+                std::cout << "samples file does not fit the MDP." << std::endl;
+                samples.reset();
+            }
+        } catch (const LSPISampleSet::Exception &exception) {
+            std::cout << "could not load samples file." << std::endl;
+        }
+    }
+    if (!samples) {
+        samples = PrepareSamples(thread_pool, sample_factory, num_samples, num_steps, (LSPR_WRITE_SAMPLES_TO_FILE ? PATH_TO_LSPI_SAMPLES_FILE : ""));
+    }
 
     std::cout << std::setprecision(10);
 
-    std::cout << "collected " << samples.size() << " samples." << std::endl;
+    std::cout << "collected " << samples->Size() << " samples." << std::endl;
+
+    if (LSPR_ENGINE == LSPR_ENGINE_FITTED_Q_ITERATION) {
+        FittedQ(thread_pool, *samples, gamma, epsilon, sample_factory.SampleRandomNatural());
+        return;
+    }
+
+    if (LSPR_BASIS != LSPR_BASIS_QUADRATIC) {
+        // the weights of other bases are written together with their state basis, which depends on the samples
+        const ActionBlockBasis basis(CreateStateBasis(*samples), kSpacecraftActions.size());
+        std::cout << "learning " << basis.NumFeatures() << " weights of sparse features." << std::endl;
+        Eigen::VectorXd initial_weights = Eigen::VectorXd::Zero(basis.NumFeatures());
+        unsigned int first_iteration = 0;
+        ResumeFromCheckpoint(*samples, initial_weights, first_iteration);
+        const Eigen::VectorXd weights = SparseLSPI(thread_pool, sample_factory, basis, *samples, gamma, epsilon, initial_weights, first_iteration);
+
+        std::cout << "creating lspi basis policy file ... ";
+        ActionBlockPolicy(basis, weights, samples->StateType(), samples->ActionSetHash()).WriteToFile(PATH_TO_LSPI_BASIS_POLICY_FILE);
+        std::cout << "done." << std::endl;
+        return;
+    }
 
     Eigen::VectorXd weights(kSpacecraftPhiSize);
     weights.setZero();
-    weights = LSPI(sample_factory, samples, gamma, epsilon, weights);
+    unsigned int first_iteration = 0;
+    ResumeFromCheckpoint(*samples, weights, first_iteration);
+    weights = LSPI(thread_pool, sample_factory, *samples, gamma, epsilon, weights, first_iteration);
 
     std::cout << "solution:" << std::endl;
     std::cout << weights[0];
@@ -0,0 +1,85 @@
+#include "lspicheckpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+const char LSPICheckpoint::kMagic[8] = {'L', 'S', 'P', 'I', 'C', 'K', 'P', '\0'};
+const boost::uint32_t LSPICheckpoint::kVersion;
+
+LSPICheckpoint::LSPICheckpoint(const boost::uint32_t &basis, const unsigned int &iteration, const unsigned int &num_samples, const boost::uint32_t &state_type, const boost::uint64_t &action_set_hash, const boost::uint64_t &samples_hash, const Eigen::VectorXd &weights)
+    : basis_(basis), iteration_(iteration), num_samples_(num_samples), state_type_(state_type), action_set_hash_(action_set_hash), samples_hash_(samples_hash), weights_(weights) {
+
+}
+
+LSPICheckpoint LSPICheckpoint::FromFile(const std::string &path_to_file) {
+    std::ifstream file(path_to_file.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw FileNotReadableException();
+    }
+
+    char magic[8];
+    boost::uint32_t header[6];
+    boost::uint64_t hashes[2];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(hashes), sizeof(hashes));
+    if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || header[0] != kVersion) {
+        throw InvalidFileFormatException();
+    }
+
+    Eigen::VectorXd weights(header[5]);
+    file.read(reinterpret_cast<char*>(weights.data()), weights.size() * sizeof(double));
+    if (!file || file.peek() != std::ifstream::traits_type::eof()) {
+        throw InvalidFileFormatException();
+    }
+
+    return LSPICheckpoint(header[1], header[2], header[3], header[4], hashes[0], hashes[1], weights);
+}
+
+void LSPICheckpoint::WriteToFile(const std::string &path_to_file) const {
+    const std::string path_to_temporary_file = path_to_file + ".tmp";
+    std::ofstream file(path_to_temporary_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw FileNotWritableException();
+    }
+
+    const boost::uint32_t header[6] = {kVersion, basis_, iteration_, num_samples_, state_type_, static_cast<boost::uint32_t>(weights_.size())};
+    const boost::uint64_t hashes[2] = {action_set_hash_, samples_hash_};
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(hashes), sizeof(hashes));
+    file.write(reinterpret_cast<const char*>(weights_.data()), weights_.size() * sizeof(double));
+    file.close();
+    if (!file || std::rename(path_to_temporary_file.c_str(), path_to_file.c_str()) != 0) {
+        throw FileNotWritableException();
+    }
+}
+
+boost::uint32_t LSPICheckpoint::Basis() const {
+    return basis_;
+}
+
+unsigned int LSPICheckpoint::Iteration() const {
+    return iteration_;
+}
+
+unsigned int LSPICheckpoint::NumSamples() const {
+    return num_samples_;
+}
+
+boost::uint32_t LSPICheckpoint::StateType() const {
+    return state_type_;
+}
+
+boost::uint64_t LSPICheckpoint::ActionSetHash() const {
+    return action_set_hash_;
+}
+
+boost::uint64_t LSPICheckpoint::SamplesHash() const {
+    return samples_hash_;
+}
+
+const Eigen::VectorXd& LSPICheckpoint::Weights() const {
+    return weights_;
+}
@@ -0,0 +1,77 @@
+#ifndef LSPICHECKPOINT_H
+#define LSPICHECKPOINT_H
+
+#include <string>
+#include <boost/cstdint.hpp>
+#include <eigen3/Eigen/Dense>
+
+class LSPICheckpoint {
+    /*
+    * This class represents the state of an LSPI run after an iteration: the basis the weights belong to, the number
+    * of the next iteration and the weights of the last solution. LSPI started from these weights on the same samples
+    * continues the run as if it had not been interrupted, except for the tie breaking draws of the greedy policy. To
+    * know whether the samples are the same, the checkpoint keeps the number of samples, the state type and the action
+    * set hash of the LSPISampleSet and the hash of its samples.
+    *
+    * A checkpoint is written into a temporary file next to the target file which then replaces the target file, so a
+    * run preempted while writing keeps the previous checkpoint. The weights are stored as raw doubles, other than the
+    * text of CreateLSPIWeightsFile they are restored exactly. All values are stored in native byte order:
+    *
+    *   char magic[8] = "LSPICKP", uint32 version, uint32 basis, uint32 iteration, uint32 number of samples,
+    *   uint32 state type, uint32 number of weights N, uint64 action set hash, uint64 samples hash
+    *   double weights[N]
+    */
+public:
+    // The magic bytes at the beginning of every checkpoint file
+    const static char kMagic[8];
+
+    // The current format version
+    const static boost::uint32_t kVersion = 2;
+
+    LSPICheckpoint(const boost::uint32_t &basis, const unsigned int &iteration, const unsigned int &num_samples, const boost::uint32_t &state_type, const boost::uint64_t &action_set_hash, const boost::uint64_t &samples_hash, const Eigen::VectorXd &weights);
+
+    // Reads the checkpoint file "path_to_file"
+    static LSPICheckpoint FromFile(const std::string &path_to_file);
+
+    // Writes the checkpoint to file "path_to_file", replacing it only once the checkpoint is complete
+    void WriteToFile(const std::string &path_to_file) const;
+
+    boost::uint32_t Basis() const;
+
+    // The number of the iteration to continue with
+    unsigned int Iteration() const;
+
+    // The number of samples, state type, action set hash and samples hash of the LSPISampleSet of the run
+    unsigned int NumSamples() const;
+
+    boost::uint32_t StateType() const;
+
+    boost::uint64_t ActionSetHash() const;
+
+    boost::uint64_t SamplesHash() const;
+
+    const Eigen::VectorXd& Weights() const;
+
+    // LSPICheckpoint can throw the following exceptions
+    class Exception {};
+    class FileNotWritableException : public Exception {};
+    class FileNotReadableException : public Exception {};
+    class InvalidFileFormatException : public Exception {};
+
+private:
+    boost::uint32_t basis_;
+
+    unsigned int iteration_;
+
+    unsigned int num_samples_;
+
+    boost::uint32_t state_type_;
+
+    boost::uint64_t action_set_hash_;
+
+    boost::uint64_t samples_hash_;
+
+    Eigen::VectorXd weights_;
+};
+
+#endif // LSPICHECKPOINT_H
@@ -0,0 +1,180 @@
+#include "lspigreedypolicy.h"
+
+#include <limits>
+
+LSPIGreedyPolicy::LSPIGreedyPolicy(const std::vector<double> &levels, const unsigned int &state_dimension, const TieBreaking &tie_breaking)
+    : levels_(levels), state_dimension_(state_dimension), tie_breaking_(tie_breaking), separable_(false) {
+    const unsigned int num_levels = levels_.size();
+    const unsigned int num_actions = num_levels * num_levels * num_levels;
+    action_matrix_.resize(num_actions, 3);
+    for (unsigned int i = 0; i < num_levels; ++i) {
+        for (unsigned int j = 0; j < num_levels; ++j) {
+            for (unsigned int k = 0; k < num_levels; ++k) {
+                const unsigned int action_index = (i * num_levels + j) * num_levels + k;
+                action_matrix_(action_index, 0) = levels_[i];
+                action_matrix_(action_index, 1) = levels_[j];
+                action_matrix_(action_index, 2) = levels_[k];
+            }
+        }
+    }
+
+    state_action_weights_ = Eigen::Matrix<double, Eigen::Dynamic, 3>::Zero(state_dimension_, 3);
+    action_values_ = Eigen::VectorXd::Zero(num_actions);
+    axis_values_ = Eigen::Matrix<double, Eigen::Dynamic, 3>::Zero(num_levels, 3);
+    q_values_.resize(num_actions);
+    axis_q_values_.resize(num_levels, 3);
+}
+
+void LSPIGreedyPolicy::SetWeights(const Eigen::VectorXd &weights) {
+    const unsigned int num_weights = 1 + 3 * state_dimension_ + state_dimension_ * state_dimension_ + 9;
+    if (weights.size() != num_weights) {
+        throw InvalidWeightsException();
+    }
+
+    for (unsigned int i = 0; i < state_dimension_; ++i) {
+        for (unsigned int k = 0; k < 3; ++k) {
+            state_action_weights_(i, k) = weights(1 + 3 * i + k);
+        }
+    }
+
+    // M(i, j) is the weight of feature a_i a_j, only M + M^T matters
+    const Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor> > action_action_weights(weights.data() + num_weights - 9);
+    separable_ = (action_action_weights(0, 1) + action_action_weights(1, 0) == 0.0
+                  && action_action_weights(0, 2) + action_action_weights(2, 0) == 0.0
+                  && action_action_weights(1, 2) + action_action_weights(2, 1) == 0.0);
+
+    if (separable_) {
+        for (unsigned int l = 0; l < levels_.size(); ++l) {
+            for (unsigned int k = 0; k < 3; ++k) {
+                axis_values_(l, k) = action_action_weights(k, k) * levels_[l] * levels_[l];
+            }
+        }
+    } else {
+        for (unsigned int a = 0; a < action_matrix_.rows(); ++a) {
+            const Eigen::Vector3d action = action_matrix_.row(a).transpose();
+            action_values_(a) = action.dot(action_action_weights * action);
+        }
+    }
+}
+
+unsigned int LSPIGreedyPolicy::Pi(SampleFactory &sample_factory, const double *state) {
+    const Eigen::Map<const Eigen::VectorXd> state_vector(state, state_dimension_);
+    const Eigen::Vector3d action_coefficients = state_action_weights_.transpose() * state_vector;
+    if (separable_) {
+        return PiSeparable(sample_factory, action_coefficients);
+    }
+    return PiDense(sample_factory, action_coefficients);
+}
+
+void LSPIGreedyPolicy::Pi(const std::vector<SampleFactory*> &sample_factories, const StateMatrix &states, std::vector<unsigned int> &actions) {
+    const unsigned int num_states = states.rows();
+    if (states.cols() != state_dimension_ || sample_factories.size() != num_states) {
+        throw InvalidStatesException();
+    }
+
+    actions.resize(num_states);
+    batch_action_coefficients_.noalias() = states * state_action_weights_;
+    if (separable_) {
+        for (unsigned int i = 0; i < num_states; ++i) {
+            actions[i] = PiSeparable(*sample_factories[i], batch_action_coefficients_.row(i).transpose());
+        }
+        return;
+    }
+
+    q_table_.noalias() = batch_action_coefficients_ * action_matrix_.transpose();
+    q_table_.rowwise() += action_values_.transpose();
+    for (unsigned int i = 0; i < num_states; ++i) {
+        actions[i] = Greedy(*sample_factories[i], q_table_.row(i).data());
+    }
+}
+
+unsigned int LSPIGreedyPolicy::PiSeparable(SampleFactory &sample_factory, const Eigen::Vector3d &action_coefficients) {
+    const unsigned int num_levels = levels_.size();
+
+    // the best levels per axis, the tied actions are the product of the tied levels
+    double best_q[3];
+    unsigned int num_best[3];
+    for (unsigned int k = 0; k < 3; ++k) {
+        best_q[k] = -std::numeric_limits<double>::max();
+        num_best[k] = 0;
+        for (unsigned int l = 0; l < num_levels; ++l) {
+            const double q = action_coefficients(k) * levels_[l] + axis_values_(l, k);
+            axis_q_values_(l, k) = q;
+            if (q > best_q[k]) {
+                best_q[k] = q;
+                num_best[k] = 1;
+            } else if (q == best_q[k]) {
+                ++num_best[k];
+            }
+        }
+    }
+
+    // the tie'th tied action in index order is the combination of the per axis ties
+    unsigned int tie = 0;
+    if (tie_breaking_ == RandomTieBreaking) {
+        tie = sample_factory.SampleRandomNatural() % (num_best[0] * num_best[1] * num_best[2]);
+    }
+    unsigned int axis_ties[3];
+    axis_ties[2] = tie % num_best[2];
+    axis_ties[1] = (tie / num_best[2]) % num_best[1];
+    axis_ties[0] = tie / (num_best[2] * num_best[1]);
+
+    unsigned int action_index = 0;
+    for (unsigned int k = 0; k < 3; ++k) {
+        unsigned int level = 0;
+        for (unsigned int l = 0; l < num_levels; ++l) {
+            if (axis_q_values_(l, k) == best_q[k] && axis_ties[k]-- == 0) {
+                level = l;
+                break;
+            }
+        }
+        action_index = action_index * num_levels + level;
+    }
+    return action_index;
+}
+
+unsigned int LSPIGreedyPolicy::PiDense(SampleFactory &sample_factory, const Eigen::Vector3d &action_coefficients) {
+    q_values_.noalias() = action_matrix_ * action_coefficients;
+    q_values_ += action_values_;
+    return Greedy(sample_factory, q_values_.data());
+}
+
+unsigned int LSPIGreedyPolicy::Greedy(SampleFactory &sample_factory, const double *q_values) const {
+    const unsigned int num_actions = action_matrix_.rows();
+    double best_q = -std::numeric_limits<double>::max();
+    unsigned int num_best = 0;
+    unsigned int first_best = 0;
+    for (unsigned int a = 0; a < num_actions; ++a) {
+        if (q_values[a] > best_q) {
+            best_q = q_values[a];
+            num_best = 1;
+            first_best = a;
+        } else if (q_values[a] == best_q) {
+            ++num_best;
+        }
+    }
+    if (tie_breaking_ == FirstTieBreaking) {
+        return first_best;
+    }
+
+    unsigned int tie = sample_factory.SampleRandomNatural() % num_best;
+    for (unsigned int a = first_best; a < num_actions; ++a) {
+        if (q_values[a] == best_q && tie-- == 0) {
+            return a;
+        }
+    }
+    return first_best;
+}
+
+Vector3D LSPIGreedyPolicy::Action(const unsigned int &action_index) const {
+    const Vector3D action = {action_matrix_(action_index, 0), action_matrix_(action_index, 1), action_matrix_(action_index, 2)};
+    return action;
+}
+
+unsigned int LSPIGreedyPolicy::NumActions() const {
+    return action_matrix_.rows();
+}
+
+bool LSPIGreedyPolicy::IsSeparable() const {
+    return separable_;
+}
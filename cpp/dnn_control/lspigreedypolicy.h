@@ -0,0 +1,97 @@
+#ifndef LSPIGREEDYPOLICY_H
+#define LSPIGREEDYPOLICY_H
+
+#include "vector.h"
+#include "samplefactory.h"
+
+#include <vector>
+#include <eigen3/Eigen/Dense>
+
+class LSPIGreedyPolicy {
+    /*
+    * This class represents the greedy policy of a quadratic LSPI Q function over a grid of thrusts.
+    *
+    * The actions are all thrusts (levels[i], levels[j], levels[k]) with action index (i * L + j) * L + k, L being the
+    * number of levels. The features of a state s of dimension n and an action a are 1, s_i a_k, s_i s_j and a_i a_j in
+    * this order, so Q(s, a) = c(s) + (W_sa^T s) . a + a^T M a where only the last two terms depend on the action.
+    *
+    * If M + M^T is diagonal the maximization separates into one maximization over the levels per axis. Otherwise the Q
+    * values of all actions are the product of the action matrix with W_sa^T s plus the precomputed a^T M a per action.
+    *
+    * A batch of states is evaluated with one matrix product for W_sa^T s of all states and, for non separable weights,
+    * one product with the action matrix for the Q table of the batch, one row of Q values of all actions per state.
+    *
+    * Ties are broken either by one draw from a SampleFactory, uniformly over all tied actions like the brute force
+    * search, or deterministically by the lowest action index. The Q values are a scratch buffer, every thread needs its
+    * own policy.
+    */
+public:
+    // How to choose between actions with equal Q values
+    enum TieBreaking {
+        RandomTieBreaking,
+        FirstTieBreaking
+    };
+
+    // A batch of states, one state per row
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> StateMatrix;
+
+    LSPIGreedyPolicy(const std::vector<double> &levels, const unsigned int &state_dimension, const TieBreaking &tie_breaking=RandomTieBreaking);
+
+    // Sets the weights of the features, 1 + 3 n + n^2 + 9 values
+    void SetWeights(const Eigen::VectorXd &weights);
+
+    // Returns the index of the action with the highest Q value in state "state" of n values, "sample_factory" breaks ties
+    unsigned int Pi(SampleFactory &sample_factory, const double *state);
+
+    // Computes the index of the action with the highest Q value of every state of "states" into "actions", "sample_factories[i]" breaks the ties of state i
+    void Pi(const std::vector<SampleFactory*> &sample_factories, const StateMatrix &states, std::vector<unsigned int> &actions);
+
+    // Returns the thrust of action "action_index"
+    Vector3D Action(const unsigned int &action_index) const;
+
+    unsigned int NumActions() const;
+
+    // Returns true if the current weights allow the per axis maximization
+    bool IsSeparable() const;
+
+    // LSPIGreedyPolicy can throw the following exceptions
+    class Exception {};
+    class InvalidWeightsException : public Exception {};
+    class InvalidStatesException : public Exception {};
+
+private:
+    // Returns the index of the action with the highest Q value given W_sa^T s "action_coefficients"
+    unsigned int PiSeparable(SampleFactory &sample_factory, const Eigen::Vector3d &action_coefficients);
+    unsigned int PiDense(SampleFactory &sample_factory, const Eigen::Vector3d &action_coefficients);
+
+    // Returns the index of the highest of the Q values "q_values" of all actions
+    unsigned int Greedy(SampleFactory &sample_factory, const double *q_values) const;
+
+    std::vector<double> levels_;
+
+    unsigned int state_dimension_;
+
+    TieBreaking tie_breaking_;
+
+    // The thrusts, one row per action
+    Eigen::Matrix<double, Eigen::Dynamic, 3> action_matrix_;
+
+    // W_sa(i, k) is the weight of feature s_i a_k
+    Eigen::Matrix<double, Eigen::Dynamic, 3> state_action_weights_;
+
+    // a^T M a per action, and M(k, k) levels[l]^2 per axis k and level l for separable weights
+    Eigen::VectorXd action_values_;
+    Eigen::Matrix<double, Eigen::Dynamic, 3> axis_values_;
+
+    bool separable_;
+
+    // Scratch buffers for the Q values of all actions and of the levels per axis
+    Eigen::VectorXd q_values_;
+    Eigen::Matrix<double, Eigen::Dynamic, 3> axis_q_values_;
+
+    // Scratch buffers for W_sa^T s and the Q values of all actions of a batch of states, one row per state
+    Eigen::Matrix<double, Eigen::Dynamic, 3> batch_action_coefficients_;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> q_table_;
+};
+
+#endif // LSPIGREEDYPOLICY_H
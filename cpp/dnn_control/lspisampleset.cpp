@@ -0,0 +1,202 @@
+#include "lspisampleset.h"
+
+#include <cstring>
+
+const char LSPISampleSet::kMagic[8] = {'L', 'S', 'P', 'I', 'S', 'E', 'T', '\0'};
+const boost::uint32_t LSPISampleSet::kVersion;
+const unsigned int LSPISampleSet::kFileHeaderSize;
+const unsigned int LSPISampleSet::kMaxAction;
+
+LSPISampleSet::LSPISampleSet()
+    : capacity_(0), size_(0), complete_(false), state_dimension_(0), state_type_(0), action_set_hash_(0), data_(NULL), states_(NULL), next_states_(NULL), rewards_(NULL), actions_(NULL) {
+
+}
+
+LSPISampleSet::LSPISampleSet(const unsigned int &capacity, const unsigned int &state_dimension, const boost::uint32_t &state_type, const boost::uint64_t &action_set_hash, const std::string &path_to_file)
+    : capacity_(capacity), size_(capacity), complete_(false), state_dimension_(state_dimension), state_type_(state_type), action_set_hash_(action_set_hash), data_(NULL), states_(NULL), next_states_(NULL), rewards_(NULL), actions_(NULL) {
+
+    const boost::uint64_t num_bytes = NumBytes(capacity_);
+    if (path_to_file.empty()) {
+        buffer_ = std::vector<char>(num_bytes, 0);
+        MapArrays(&buffer_[0]);
+    } else {
+        boost::iostreams::mapped_file_params params(path_to_file);
+        params.flags = boost::iostreams::mapped_file::readwrite;
+        params.new_file_size = num_bytes;
+        try {
+            file_.open(params);
+        } catch (const std::exception &exception) {
+            throw FileNotWritableException();
+        }
+        MapArrays(file_.data());
+    }
+    WriteHeader();
+}
+
+LSPISampleSet::~LSPISampleSet() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+}
+
+boost::shared_ptr<LSPISampleSet> LSPISampleSet::FromFile(const std::string &path_to_file) {
+    boost::shared_ptr<LSPISampleSet> sample_set(new LSPISampleSet());
+
+    boost::iostreams::mapped_file_params params(path_to_file);
+    params.flags = boost::iostreams::mapped_file::priv;
+    try {
+        sample_set->file_.open(params);
+    } catch (const std::exception &exception) {
+        throw FileNotReadableException();
+    }
+
+    char *data = sample_set->file_.data();
+    const boost::uint64_t size = sample_set->file_.size();
+    if (size < kFileHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        throw InvalidFileFormatException();
+    }
+
+    boost::uint32_t header[6];
+    std::memcpy(header, data + sizeof(kMagic), sizeof(header));
+    if (header[0] != kVersion) {
+        throw InvalidFileFormatException();
+    }
+    sample_set->state_type_ = header[1];
+    sample_set->state_dimension_ = header[2];
+    sample_set->capacity_ = header[3];
+    sample_set->size_ = header[4];
+    sample_set->complete_ = (header[5] == 1);
+    std::memcpy(&sample_set->action_set_hash_, data + sizeof(kMagic) + sizeof(header), sizeof(boost::uint64_t));
+
+    if (!sample_set->complete_ || sample_set->size_ > sample_set->capacity_ || sample_set->NumBytes(sample_set->capacity_) > size) {
+        throw InvalidFileFormatException();
+    }
+
+    // mappings are page aligned, hence the arrays behind the 64 byte header are aligned for floats
+    sample_set->MapArrays(data);
+
+    return sample_set;
+}
+
+// Continues the FNV-1a hash "hash" with the "num_bytes" bytes at "data"
+static boost::uint64_t HashBytes(const void *data, const boost::uint64_t &num_bytes, boost::uint64_t hash) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data);
+    for (boost::uint64_t i = 0; i < num_bytes; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+boost::uint64_t LSPISampleSet::Hash(const double *values, const unsigned int &num_values) {
+    return HashBytes(values, static_cast<boost::uint64_t>(num_values) * sizeof(double), 14695981039346656037ULL);
+}
+
+boost::uint64_t LSPISampleSet::SamplesHash() const {
+    const boost::uint64_t row_bytes = state_dimension_ * sizeof(float);
+    boost::uint64_t hash = 14695981039346656037ULL;
+    hash = HashBytes(states_, size_ * row_bytes, hash);
+    hash = HashBytes(next_states_, size_ * row_bytes, hash);
+    hash = HashBytes(rewards_, static_cast<boost::uint64_t>(size_) * sizeof(float), hash);
+    return HashBytes(actions_, static_cast<boost::uint64_t>(size_) * sizeof(boost::uint16_t), hash);
+}
+
+void LSPISampleSet::SetSample(const unsigned int &index, const double *state, const unsigned int &action, const double &reward, const double *next_state) {
+    if (action > kMaxAction) {
+        throw InvalidActionException();
+    }
+
+    float *row = states_ + static_cast<boost::uint64_t>(index) * state_dimension_;
+    float *next_row = next_states_ + static_cast<boost::uint64_t>(index) * state_dimension_;
+    for (unsigned int i = 0; i < state_dimension_; ++i) {
+        row[i] = state[i];
+        next_row[i] = next_state[i];
+    }
+    rewards_[index] = reward;
+    actions_[index] = action;
+}
+
+void LSPISampleSet::Compact(const std::vector<unsigned int> &sizes, const unsigned int &stride) {
+    if (static_cast<boost::uint64_t>(sizes.size()) * stride > capacity_) {
+        throw InvalidSizesException();
+    }
+
+    // ranges only move to the front, hence copying them in order never overwrites samples still to be moved
+    unsigned int size = 0;
+    for (unsigned int i = 0; i < sizes.size(); ++i) {
+        const unsigned int begin = i * stride;
+        const unsigned int num_samples = sizes[i];
+        if (num_samples > stride) {
+            throw InvalidSizesException();
+        }
+        if (begin != size && num_samples > 0) {
+            const boost::uint64_t row_bytes = state_dimension_ * sizeof(float);
+            std::memmove(states_ + static_cast<boost::uint64_t>(size) * state_dimension_, states_ + static_cast<boost::uint64_t>(begin) * state_dimension_, num_samples * row_bytes);
+            std::memmove(next_states_ + static_cast<boost::uint64_t>(size) * state_dimension_, next_states_ + static_cast<boost::uint64_t>(begin) * state_dimension_, num_samples * row_bytes);
+            std::memmove(rewards_ + size, rewards_ + begin, num_samples * sizeof(float));
+            std::memmove(actions_ + size, actions_ + begin, num_samples * sizeof(boost::uint16_t));
+        }
+        size += num_samples;
+    }
+    // the header is written after the samples, so a file marked complete holds all of them
+    size_ = size;
+    complete_ = true;
+    WriteHeader();
+}
+
+unsigned int LSPISampleSet::Size() const {
+    return size_;
+}
+
+unsigned int LSPISampleSet::Capacity() const {
+    return capacity_;
+}
+
+unsigned int LSPISampleSet::StateDimension() const {
+    return state_dimension_;
+}
+
+boost::uint32_t LSPISampleSet::StateType() const {
+    return state_type_;
+}
+
+boost::uint64_t LSPISampleSet::ActionSetHash() const {
+    return action_set_hash_;
+}
+
+const float* LSPISampleSet::State(const unsigned int &index) const {
+    return states_ + static_cast<boost::uint64_t>(index) * state_dimension_;
+}
+
+const float* LSPISampleSet::NextState(const unsigned int &index) const {
+    return next_states_ + static_cast<boost::uint64_t>(index) * state_dimension_;
+}
+
+unsigned int LSPISampleSet::Action(const unsigned int &index) const {
+    return actions_[index];
+}
+
+double LSPISampleSet::Reward(const unsigned int &index) const {
+    return rewards_[index];
+}
+
+void LSPISampleSet::MapArrays(char *data) {
+    const boost::uint64_t num_state_values = static_cast<boost::uint64_t>(capacity_) * state_dimension_;
+    data_ = data;
+    states_ = reinterpret_cast<float*>(data + kFileHeaderSize);
+    next_states_ = states_ + num_state_values;
+    rewards_ = next_states_ + num_state_values;
+    actions_ = reinterpret_cast<boost::uint16_t*>(rewards_ + capacity_);
+}
+
+void LSPISampleSet::WriteHeader() {
+    std::memset(data_, 0, kFileHeaderSize);
+    std::memcpy(data_, kMagic, sizeof(kMagic));
+    const boost::uint32_t header[6] = {kVersion, state_type_, state_dimension_, capacity_, (complete_ ? size_ : 0u), (complete_ ? 1u : 0u)};
+    std::memcpy(data_ + sizeof(kMagic), header, sizeof(header));
+    std::memcpy(data_ + sizeof(kMagic) + sizeof(header), &action_set_hash_, sizeof(action_set_hash_));
+}
+
+boost::uint64_t LSPISampleSet::NumBytes(const unsigned int &capacity) const {
+    return kFileHeaderSize + static_cast<boost::uint64_t>(capacity) * ((2 * state_dimension_ + 1) * sizeof(float) + sizeof(boost::uint16_t));
+}
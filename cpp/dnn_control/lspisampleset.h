@@ -0,0 +1,140 @@
+#ifndef LSPISAMPLESET_H
+#define LSPISAMPLESET_H
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+class LSPISampleSet {
+    /*
+    * This class stores LSPI transitions (s, a, r, s') as structure of arrays: the states and next states as rows of
+    * StateDimension() floats, the rewards as floats and the action indices as uint16.
+    *
+    * The set has a fixed capacity. Samples are set into slots by any thread (one thread per slot), so episodes collected
+    * in parallel can write into disjoint ranges, and Compact closes the gaps left by episodes which stopped early.
+    *
+    * The arrays are either held in memory or, if a file is given, in a memory mapped file which the OS pages in and out
+    * as needed, so sample sets larger than the memory can be collected. The file stays valid after the set is destroyed
+    * and FromFile maps it again, so LSPI can be run repeatedly with other discount factors, features or epsilons on the
+    * same transitions without collecting them again. All values are stored in native byte order, the layout is:
+    *
+    *   header (64 bytes):    char magic[8] = "LSPISET", uint32 version, uint32 state type, uint32 state dimension D,
+    *                         uint32 capacity C, uint32 size, uint32 complete, uint64 action set hash, 24 bytes 0
+    *   float states[C][D]
+    *   float next_states[C][D]
+    *   float rewards[C]
+    *   uint16 actions[C]
+    *
+    * The state type and the action set hash are chosen by the collector, a reader compares them with its own to know
+    * whether the samples fit its MDP.
+    *
+    * A new file is marked incomplete with size 0 and only Compact, after the samples are written, sets the size and marks
+    * it complete, so FromFile rejects the file of a collection which stopped before it finished.
+    */
+public:
+    // The magic bytes at the beginning of every sample set file
+    const static char kMagic[8];
+
+    // The current format version
+    const static boost::uint32_t kVersion = 2;
+
+    // The size of the file header in bytes
+    const static unsigned int kFileHeaderSize = 64;
+
+    // The largest action index a sample can store
+    const static unsigned int kMaxAction = 65535;
+
+    // Allocates "capacity" samples of states with "state_dimension" values, in file "path_to_file" if not empty
+    LSPISampleSet(const unsigned int &capacity, const unsigned int &state_dimension, const boost::uint32_t &state_type=0, const boost::uint64_t &action_set_hash=0, const std::string &path_to_file="");
+
+    ~LSPISampleSet();
+
+    // Maps the sample set file "path_to_file", changes to the samples are not written back to the file
+    static boost::shared_ptr<LSPISampleSet> FromFile(const std::string &path_to_file);
+
+    // Returns the FNV-1a hash of the bytes of "num_values" values "values", e.g. of the thrusts of an action set
+    static boost::uint64_t Hash(const double *values, const unsigned int &num_values);
+
+    // Returns the FNV-1a hash of the states, next states, rewards and actions of the Size() samples
+    boost::uint64_t SamplesHash() const;
+
+    // Sets sample "index" to the transition from state "state" by action "action" with reward "reward" into state "next_state"
+    void SetSample(const unsigned int &index, const double *state, const unsigned int &action, const double &reward, const double *next_state);
+
+    // Keeps the first "sizes[i]" samples of every range [i * stride, (i + 1) * stride), moves them to the front in order
+    // and marks the set complete
+    void Compact(const std::vector<unsigned int> &sizes, const unsigned int &stride);
+
+    // The number of samples, the capacity until Compact was called
+    unsigned int Size() const;
+
+    unsigned int Capacity() const;
+
+    unsigned int StateDimension() const;
+
+    boost::uint32_t StateType() const;
+
+    boost::uint64_t ActionSetHash() const;
+
+    // The StateDimension() values of the state and the next state of sample "index"
+    const float* State(const unsigned int &index) const;
+    const float* NextState(const unsigned int &index) const;
+
+    unsigned int Action(const unsigned int &index) const;
+
+    double Reward(const unsigned int &index) const;
+
+    // LSPISampleSet can throw the following exceptions
+    class Exception {};
+    class FileNotWritableException : public Exception {};
+    class FileNotReadableException : public Exception {};
+    class InvalidFileFormatException : public Exception {};
+    class InvalidActionException : public Exception {};
+    class InvalidSizesException : public Exception {};
+
+private:
+    LSPISampleSet();
+    LSPISampleSet(const LSPISampleSet &other);
+    LSPISampleSet& operator=(const LSPISampleSet &other);
+
+    // Points the arrays into "data", the beginning of the header
+    void MapArrays(char *data);
+
+    // Writes the header to data_, with size 0 until the set is complete
+    void WriteHeader();
+
+    // The number of bytes of the header and the arrays of "capacity" samples
+    boost::uint64_t NumBytes(const unsigned int &capacity) const;
+
+    unsigned int capacity_;
+
+    unsigned int size_;
+
+    // Whether Compact has set the final samples
+    bool complete_;
+
+    unsigned int state_dimension_;
+
+    boost::uint32_t state_type_;
+
+    boost::uint64_t action_set_hash_;
+
+    // The file, if any
+    boost::iostreams::mapped_file file_;
+
+    // The memory of the header and the arrays if there is no file
+    std::vector<char> buffer_;
+
+    // The header, pointing into file_ or buffer_
+    char *data_;
+
+    // The arrays, following the header
+    float *states_;
+    float *next_states_;
+    float *rewards_;
+    boost::uint16_t *actions_;
+};
+
+#endif // LSPISAMPLESET_H
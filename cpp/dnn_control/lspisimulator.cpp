@@ -1,28 +1,26 @@
 #include "lspisimulator.h"
 #include "samplefactory.h"
+#include "asteroidcache.h"
 #include "odesystem.h"
 #include "odeint.h"
 #include "modifiedcontrolledrungekutta.h"
+#include "ensembleintegrator.h"
 #include "constants.h"
 
 LSPISimulator::LSPISimulator(const unsigned int &random_seed, const bool &fuel_usage_enabled)
-    : random_seed_(random_seed), sample_factory_(random_seed), fuel_usage_enabled_(fuel_usage_enabled) {
+    : random_seed_(random_seed), asteroid_(AsteroidCache::AsteroidForSeed(random_seed)), sample_factory_(random_seed), fuel_usage_enabled_(fuel_usage_enabled) {
+    Init();
+}
+
+LSPISimulator::LSPISimulator(const unsigned int &random_seed, const boost::shared_ptr<const Asteroid> &asteroid, const bool &fuel_usage_enabled)
+    : random_seed_(random_seed), asteroid_(asteroid), sample_factory_(random_seed), fuel_usage_enabled_(fuel_usage_enabled) {
+    Init();
+}
 
+void LSPISimulator::Init() {
     minimum_step_size_ = 0.1;
     control_frequency_ = 1.0;
 
-    SampleFactory asteroid_sf(random_seed);
-
-    const double c_semi_axis = asteroid_sf.SampleUniformReal(100.0, 8000.0);
-    const double b_semi_axis_n = asteroid_sf.SampleUniformReal(1.1, 2.0);
-    const double a_semi_axis_n = asteroid_sf.SampleUniformReal(1.1 * b_semi_axis_n, 4.0);
-    const Vector3D &semi_axis = {a_semi_axis_n * c_semi_axis, b_semi_axis_n * c_semi_axis, c_semi_axis};
-    const double density = asteroid_sf.SampleUniformReal(1500.0, 3000.0);
-    const double magn_angular_velocity = 0.85 * sqrt((kGravitationalConstant * 4.0/3.0 * kPi * semi_axis[0] * semi_axis[1] * semi_axis[2] * density) / (semi_axis[0] * semi_axis[0] * semi_axis[0]));
-    const Vector2D &angular_velocity_xz = {asteroid_sf.SampleSign() * asteroid_sf.SampleUniformReal(magn_angular_velocity * 0.5, magn_angular_velocity), asteroid_sf.SampleSign() * asteroid_sf.SampleUniformReal(magn_angular_velocity * 0.5, magn_angular_velocity)};
-    const double time_bias = asteroid_sf.SampleUniformReal(0.0, 12.0 * 60 * 60);
-    asteroid_ = Asteroid(semi_axis, density, angular_velocity_xz, time_bias);
-
     spacecraft_maximum_mass_ = sample_factory_.SampleUniformReal(450.0, 500.0);
     spacecraft_minimum_mass_ = spacecraft_maximum_mass_ * 0.5;
     spacecraft_maximum_thrust_ = 21.0;
@@ -43,30 +41,9 @@ boost::tuple<SystemState, Vector3D, double, bool> LSPISimulator::NextState(const
 
     const double engine_noise = sample_factory_.SampleNormal(0.0, spacecraft_engine_noise_);
 
-    const Vector3D &position = {state[0], state[1], state[2]};
-    const Vector3D &velocity = {state[3], state[4], state[5]};
-
-    const Vector3D gravity_acceleration = asteroid_.GravityAccelerationAtPosition(position);
-
-    const boost::tuple<Vector3D, Vector3D> result_angular = asteroid_.AngularVelocityAndAccelerationAtTime(time);
-    const Vector3D &angular_velocity = boost::get<0>(result_angular);
-    const Vector3D &angular_acceleration = boost::get<1>(result_angular);
-
-    const Vector3D euler_acceleration = VectorCrossProduct(angular_acceleration, position);
-    const Vector3D centrifugal_acceleration = VectorCrossProduct(angular_velocity, VectorCrossProduct(angular_velocity, position));
-
-    const Vector3D coriolis_acceleration = VectorCrossProduct(VectorMul(2.0, angular_velocity), velocity);
-
-    Vector3D acceleration;
-    for (unsigned int i = 0; i < 3; ++i) {
-        acceleration[i] = perturbations_acceleration_[i]
-                + gravity_acceleration[i]
-                - coriolis_acceleration[i]
-                - euler_acceleration[i]
-                - centrifugal_acceleration[i];
-    }
+    const Vector3D acceleration = AccelerationAtState(state, time);
 
-    ODESystem ode_system(asteroid_, perturbations_acceleration_, thrust, spacecraft_specific_impulse_, spacecraft_minimum_mass_, engine_noise, fuel_usage_enabled_);
+    ODESystem ode_system(*asteroid_, perturbations_acceleration_, thrust, spacecraft_specific_impulse_, spacecraft_minimum_mass_, engine_noise, fuel_usage_enabled_);
 
     ControlledStepper controlled_stepper;
     double current_time_observer = 0.0;
@@ -86,7 +63,83 @@ boost::tuple<SystemState, Vector3D, double, bool> LSPISimulator::NextState(const
     return boost::make_tuple(state_copy, acceleration, current_time_observer, exception_thrown);
 }
 
-Asteroid &LSPISimulator::AsteroidOfSystem() {
+std::vector<boost::tuple<SystemState, Vector3D, double, bool> > LSPISimulator::NextStates(const std::vector<LSPISimulator*> &simulators, const std::vector<SystemState> &states, const std::vector<double> &times, const std::vector<Vector3D> &thrusts) {
+    const unsigned int num_simulators = simulators.size();
+    std::vector<boost::tuple<SystemState, Vector3D, double, bool> > results(num_simulators);
+    if (num_simulators == 0) {
+        return results;
+    }
+
+    // the lanes integrate for the same duration from the same initial step size, other simulators fall back to NextState
+    const double dt = 1.0 / simulators[0]->control_frequency_;
+    const double minimum_step_size = simulators[0]->minimum_step_size_;
+    std::vector<unsigned int> lanes;
+    for (unsigned int i = 0; i < num_simulators; ++i) {
+        const LSPISimulator &simulator = *simulators[i];
+        if (simulator.control_frequency_ == simulators[0]->control_frequency_ && simulator.minimum_step_size_ == minimum_step_size) {
+            lanes.push_back(i);
+        }
+    }
+
+    EnsembleIntegrator ensemble_integrator(lanes.size(), minimum_step_size);
+    for (unsigned int lane = 0, k = 0; k < num_simulators; ++k) {
+        LSPISimulator &simulator = *simulators[k];
+        if (lane < lanes.size() && lanes[lane] == k) {
+            const double engine_noise = simulator.sample_factory_.SampleNormal(0.0, simulator.spacecraft_engine_noise_);
+            ensemble_integrator.SetLane(lane, *simulator.asteroid_, states[k], times[k], simulator.spacecraft_specific_impulse_, simulator.spacecraft_minimum_mass_, simulator.fuel_usage_enabled_);
+            ensemble_integrator.SetLaneControl(lane, simulator.perturbations_acceleration_, thrusts[k], engine_noise);
+            ++lane;
+        } else {
+            results[k] = simulator.NextState(states[k], times[k], thrusts[k]);
+        }
+    }
+
+    if (!lanes.empty()) {
+        ensemble_integrator.Integrate(dt);
+    }
+
+    for (unsigned int lane = 0; lane < lanes.size(); ++lane) {
+        const EnsembleIntegrator::LaneStatus status = ensemble_integrator.StatusOfLane(lane);
+        if (status == EnsembleIntegrator::StepSizeAdjustmentFailed) {
+            // integrate_adaptive gives up the same way
+            throw odeint::step_adjustment_error("Max number of iterations exceeded (500). A new step size was not found.");
+        }
+
+        // a lane stopped before its first step may not have evaluated its acceleration
+        const unsigned int k = lanes[lane];
+        Vector3D acceleration;
+        if (status != EnsembleIntegrator::Running && ensemble_integrator.LaneTime(lane) == times[k]) {
+            acceleration = simulators[k]->AccelerationAtState(states[k], times[k]);
+        } else {
+            acceleration = ensemble_integrator.LaneAcceleration(lane);
+        }
+        results[k] = boost::make_tuple(ensemble_integrator.LaneState(lane), acceleration, ensemble_integrator.LaneTime(lane), status != EnsembleIntegrator::Running);
+    }
+
+    return results;
+}
+
+Vector3D LSPISimulator::AccelerationAtState(const SystemState &state, const double &time) const {
+    const Vector3D &position = {state[0], state[1], state[2]};
+    const Vector3D &velocity = {state[3], state[4], state[5]};
+
+    const Vector3D gravity_acceleration = asteroid_->GravityAccelerationAtPosition(position);
+
+    const boost::tuple<Vector3D, Vector3D> result_angular = asteroid_->AngularVelocityAndAccelerationAtTime(time);
+    const Vector3D &angular_velocity = boost::get<0>(result_angular);
+    const Vector3D &angular_acceleration = boost::get<1>(result_angular);
+
+    const Vector3D &external_acceleration = {perturbations_acceleration_[0] + gravity_acceleration[0],
+                                             perturbations_acceleration_[1] + gravity_acceleration[1],
+                                             perturbations_acceleration_[2] + gravity_acceleration[2]};
+    return VectorRotatingFrameAcceleration(external_acceleration, angular_velocity, angular_acceleration, position, velocity);
+}
+
+const Asteroid &LSPISimulator::AsteroidOfSystem() const {
+    return *asteroid_;
+}
+
+boost::shared_ptr<const Asteroid> LSPISimulator::SharedAsteroidOfSystem() const {
     return asteroid_;
 }
 
@@ -7,16 +7,29 @@
 #include "asteroid.h"
 #include "samplefactory.h"
 
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
 class LSPISimulator {
 public:
     LSPISimulator(const unsigned int &random_seed, const bool &fuel_usage_enabled=true);
 
+    // The spacecraft is sampled from "random_seed", the asteroid is given and can be shared with other simulators
+    LSPISimulator(const unsigned int &random_seed, const boost::shared_ptr<const Asteroid> &asteroid, const bool &fuel_usage_enabled=true);
+
 
     // (s', t', end_of_sim) = NextState(s, t, a)
     boost::tuple<SystemState, Vector3D, double, bool> NextState(const SystemState &state, const double &time, const Vector3D &thrust);
 
+    // NextState of every simulator of "simulators" for the state, time and thrust of the same index, integrated together by an
+    // EnsembleIntegrator. Every simulator draws its engine noise in the same order and gets the same result as from NextState.
+    static std::vector<boost::tuple<SystemState, Vector3D, double, bool> > NextStates(const std::vector<LSPISimulator*> &simulators, const std::vector<SystemState> &states, const std::vector<double> &times, const std::vector<Vector3D> &thrusts);
+
     // Returns the asteroid the simulator works with
-    Asteroid &AsteroidOfSystem();
+    const Asteroid &AsteroidOfSystem() const;
+
+    // Returns the shared asteroid the simulator works with
+    boost::shared_ptr<const Asteroid> SharedAsteroidOfSystem() const;
 
     // Returns the SampleFactory the simulator works with
     SampleFactory &SampleFactoryOfSystem();
@@ -34,6 +47,12 @@ public:
     Vector3D RefreshPerturbationsAcceleration();
 
 private:
+    // Configures the spacecraft based on the sample factory
+    void Init();
+
+    // The acceleration without thrust at state "state" and time "time", as NextState reports it
+    Vector3D AccelerationAtState(const SystemState &state, const double &time) const;
+
     // This class is used to observe the actual simulated time in case of an exception (out of fuel, crash)
     class Observer {
     public:
@@ -76,7 +95,7 @@ private:
     double perturbation_noise_;
 
     // The asteroid the simulator works with
-    Asteroid asteroid_;
+    boost::shared_ptr<const Asteroid> asteroid_;
 
     // The SampleFactory the simulator works with
     SampleFactory sample_factory_;
@@ -0,0 +1,49 @@
+#include "lspistatebasis.h"
+#include "radialbasisgrid.h"
+#include "tilecoding.h"
+
+#include <boost/cstdint.hpp>
+
+LSPIStateBasis::~LSPIStateBasis() {
+
+}
+
+boost::shared_ptr<const LSPIStateBasis> LSPIStateBasis::ReadFrom(std::istream &stream) {
+    boost::uint32_t header[2];
+    stream.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!stream || header[1] == 0) {
+        throw InvalidFormatException();
+    }
+    const unsigned int dimension = header[1];
+
+    // the parameters of the type, then the box [lower, upper]
+    boost::uint32_t sizes[3] = {0, 0, 0};
+    double shape[2] = {0.0, 0.0};
+    if (header[0] == RadialBasisGridType) {
+        stream.read(reinterpret_cast<char*>(sizes), sizeof(boost::uint32_t));
+        stream.read(reinterpret_cast<char*>(shape), sizeof(shape));
+    } else if (header[0] == TileCodingType) {
+        stream.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+    } else {
+        throw InvalidFormatException();
+    }
+    std::vector<double> lower(dimension);
+    std::vector<double> upper(dimension);
+    stream.read(reinterpret_cast<char*>(lower.data()), dimension * sizeof(double));
+    stream.read(reinterpret_cast<char*>(upper.data()), dimension * sizeof(double));
+    if (!stream) {
+        throw InvalidFormatException();
+    }
+
+    try {
+        if (header[0] == RadialBasisGridType) {
+            return boost::shared_ptr<const LSPIStateBasis>(new RadialBasisGrid(lower, upper, sizes[0], shape[0], shape[1]));
+        } else {
+            return boost::shared_ptr<const LSPIStateBasis>(new TileCoding(lower, upper, sizes[0], sizes[1], sizes[2]));
+        }
+    } catch (const RadialBasisGrid::Exception &exception) {
+        throw InvalidFormatException();
+    } catch (const TileCoding::Exception &exception) {
+        throw InvalidFormatException();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef LSPISTATEBASIS_H
+#define LSPISTATEBASIS_H
+
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+class LSPIStateBasis {
+    /*
+    * This abstract class represents a set of basis functions of the LSPI state.
+    *
+    * A state activates only a few of the NumFeatures() functions, Features returns the indices and values of those, so
+    * the features stay sparse however many functions the basis has.
+    *
+    * WriteTo stores the type and the parameters of a basis, e.g. next to weights learned with it, and ReadFrom restores
+    * a basis with the same features. All values are stored in native byte order, starting with uint32 type, uint32
+    * state dimension D.
+    */
+public:
+    // The types of bases, as stored by WriteTo
+    enum BasisType {
+        RadialBasisGridType = 1,
+        TileCodingType = 2
+    };
+
+    virtual ~LSPIStateBasis();
+
+    // Reads a basis stored by WriteTo from "stream"
+    static boost::shared_ptr<const LSPIStateBasis> ReadFrom(std::istream &stream);
+
+    // The number of basis functions
+    virtual unsigned int NumFeatures() const = 0;
+
+    // The number of values of a state
+    virtual unsigned int StateDimension() const = 0;
+
+    // Sets "indices" (ascending, unique) and "values" to the nonzero features of state "state"
+    virtual void Features(const double *state, std::vector<unsigned int> &indices, std::vector<double> &values) const = 0;
+
+    // Writes the type and the parameters of the basis to "stream"
+    virtual void WriteTo(std::ostream &stream) const = 0;
+
+    // LSPIStateBasis can throw the following exceptions
+    class Exception {};
+    class InvalidFormatException : public Exception {};
+};
+
+#endif // LSPISTATEBASIS_H
@@ -0,0 +1,25 @@
+#ifndef LSTDQSTATISTICS_H
+#define LSTDQSTATISTICS_H
+
+// The statistics of one LSTDQ solution of LSPI
+struct LSTDQStatistics {
+    // Wall times in seconds of choosing the greedy next actions, of accumulating A and of solving A w = b
+    double policy_time;
+    double accumulation_time;
+    double solve_time;
+
+    // Number of samples whose greedy next action changed, A and w are not updated if none changed
+    unsigned int num_changed_actions;
+
+    // Number of nonzeros of A, all its entries if A is dense, 0 if A was not updated
+    unsigned int num_non_zeros;
+
+    // Iterations and estimated relative error of an iterative solver, 0 for a direct solver or if w was not updated
+    unsigned int solver_iterations;
+    double solver_error;
+
+    // ||A w - b|| / ||b|| of the solution w, 0 if w was not updated
+    double residual;
+};
+
+#endif // LSTDQSTATISTICS_H
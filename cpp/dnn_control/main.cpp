@@ -1,9 +1,17 @@
 #include "sensordatagenerator.h"
 #include "evolutionaryrobotics.h"
 #include "leastsquarespolicyrobotics.h"
+#include "benchmarks.h"
+
+#include <string>
 
 
 int main(int argc, char *argv[]) {
+    // "main benchmark" only times the vector kernels
+    if (argc > 1 && std::string(argv[1]) == "benchmark") {
+        BenchmarkVectorKernels();
+        return 0;
+    }
 
     TrainNeuralNetworkController();
     TestNeuralNetworkController(0);
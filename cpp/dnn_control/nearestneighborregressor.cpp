@@ -0,0 +1,120 @@
+#include "nearestneighborregressor.h"
+
+#include <cmath>
+#include <algorithm>
+
+// The number of queries whose weights or Q values are computed by one task
+static const unsigned int kBlockSize = 1024;
+
+NearestNeighborRegressor::NearestNeighborRegressor(ThreadPool &thread_pool, const unsigned int &num_neighbors, const double &bandwidth, const double &error_bound)
+    : thread_pool_(thread_pool), num_neighbors_(num_neighbors), bandwidth_(bandwidth), error_bound_(error_bound) {
+
+    if (num_neighbors_ == 0 || bandwidth_ < 0.0 || error_bound_ < 0.0) {
+        throw InvalidInputsException();
+    }
+}
+
+void NearestNeighborRegressor::SetInputs(const InputMatrix &inputs, const InputMatrix &queries) {
+    if (inputs.rows() == 0 || queries.cols() != inputs.cols()) {
+        throw InvalidInputsException();
+    }
+
+    tree_.reset(new KDTree(thread_pool_, inputs.data(), inputs.rows(), inputs.cols()));
+    num_neighbors_ = std::min(num_neighbors_, tree_->Size());
+    targets_.resize(0);
+
+    const unsigned int num_queries = queries.rows();
+    query_indices_.resize(static_cast<std::size_t>(num_queries) * num_neighbors_);
+    query_weights_.resize(query_indices_.size());
+    tree_->Search(thread_pool_, queries.data(), num_queries, num_neighbors_, query_indices_.data(), query_weights_.data(), error_bound_);
+    const unsigned int num_blocks = (num_queries + kBlockSize - 1) / kBlockSize;
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        const unsigned int end = std::min(num_queries, (block + 1) * kBlockSize);
+        for (unsigned int i = block * kBlockSize; i < end; ++i) {
+            KernelWeights(query_weights_.data() + static_cast<std::size_t>(i) * num_neighbors_);
+        }
+    });
+}
+
+void NearestNeighborRegressor::Fit(const Eigen::VectorXd &targets) {
+    if (!tree_ || targets.size() != tree_->Size()) {
+        throw InvalidTargetsException();
+    }
+
+    targets_ = targets;
+}
+
+void NearestNeighborRegressor::PredictQueries(Eigen::VectorXd &q_values) {
+    if (targets_.size() == 0) {
+        throw InvalidTargetsException();
+    }
+
+    const unsigned int num_queries = query_indices_.size() / num_neighbors_;
+    q_values.resize(num_queries);
+    const unsigned int num_blocks = (num_queries + kBlockSize - 1) / kBlockSize;
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        const unsigned int end = std::min(num_queries, (block + 1) * kBlockSize);
+        for (unsigned int i = block * kBlockSize; i < end; ++i) {
+            const std::size_t offset = static_cast<std::size_t>(i) * num_neighbors_;
+            q_values(i) = WeightedTarget(query_indices_.data() + offset, query_weights_.data() + offset);
+        }
+    });
+}
+
+void NearestNeighborRegressor::Predict(const InputMatrix &inputs, Eigen::VectorXd &q_values) const {
+    if (targets_.size() == 0) {
+        throw InvalidTargetsException();
+    }
+    if (inputs.cols() != tree_->Dimension()) {
+        throw InvalidInputsException();
+    }
+
+    const unsigned int num_inputs = inputs.rows();
+    std::vector<unsigned int> indices(num_neighbors_);
+    std::vector<float> weights(num_neighbors_);
+    q_values.resize(num_inputs);
+    for (unsigned int i = 0; i < num_inputs; ++i) {
+        tree_->Search(inputs.data() + static_cast<std::size_t>(i) * inputs.cols(), num_neighbors_, indices.data(), weights.data(), error_bound_);
+        KernelWeights(weights.data());
+        q_values(i) = WeightedTarget(indices.data(), weights.data());
+    }
+}
+
+Eigen::VectorXd NearestNeighborRegressor::Parameters() const {
+    if (targets_.size() == 0) {
+        throw InvalidTargetsException();
+    }
+
+    return targets_;
+}
+
+void NearestNeighborRegressor::SetParameters(const InputMatrix &inputs, const Eigen::VectorXd &parameters) {
+    if (parameters.size() != inputs.rows()) {
+        throw InvalidParametersException();
+    }
+
+    SetInputs(inputs, InputMatrix(0, inputs.cols()));
+    Fit(parameters);
+}
+
+void NearestNeighborRegressor::KernelWeights(float *weights) const {
+    // relative to the nearest neighbor, whose weight is 1, so far queries do not underflow
+    const double coef = (bandwidth_ > 0.0 ? -0.5 / (bandwidth_ * bandwidth_) : 0.0);
+    const double nearest = weights[0];
+    double sum = 0.0;
+    for (unsigned int k = 0; k < num_neighbors_; ++k) {
+        weights[k] = std::exp(coef * (weights[k] - nearest));
+        sum += weights[k];
+    }
+    for (unsigned int k = 0; k < num_neighbors_; ++k) {
+        weights[k] /= sum;
+    }
+}
+
+double NearestNeighborRegressor::WeightedTarget(const unsigned int *indices, const float *weights) const {
+    double q = 0.0;
+    for (unsigned int k = 0; k < num_neighbors_; ++k) {
+        q += weights[k] * targets_(indices[k]);
+    }
+    return q;
+}
@@ -0,0 +1,66 @@
+#ifndef NEARESTNEIGHBORREGRESSOR_H
+#define NEARESTNEIGHBORREGRESSOR_H
+
+#include "qregressor.h"
+#include "kdtree.h"
+#include "threadpool.h"
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+class NearestNeighborRegressor : public QRegressor {
+    /*
+    * This class represents a kernel weighted k nearest neighbor regression of Q values.
+    *
+    * The Q value of an input is the average of the targets of its k nearest training inputs, weighted by the Gaussian
+    * kernel exp(-(d^2 - d_1^2) / (2 h^2)) of their distances d relative to the nearest distance d_1, or uniformly if the
+    * bandwidth h is 0. As an averager the regression keeps fitted Q iteration a contraction.
+    *
+    * SetInputs builds a KDTree over the training inputs and searches the approximate neighbors of all queries, within
+    * the tree's error bound, as one batch, both on the thread pool, and keeps the neighbors' indices and weights, 8 k
+    * bytes per query. Fitting only stores the targets and PredictQueries is a weighted sum over the stored neighbors, so
+    * the tree is searched once per run. The parameters of the regression are its targets.
+    */
+public:
+    NearestNeighborRegressor(ThreadPool &thread_pool, const unsigned int &num_neighbors, const double &bandwidth, const double &error_bound=0.0);
+
+    virtual void SetInputs(const InputMatrix &inputs, const InputMatrix &queries);
+
+    virtual void Fit(const Eigen::VectorXd &targets);
+
+    virtual void PredictQueries(Eigen::VectorXd &q_values);
+
+    virtual void Predict(const InputMatrix &inputs, Eigen::VectorXd &q_values) const;
+
+    virtual Eigen::VectorXd Parameters() const;
+
+    virtual void SetParameters(const InputMatrix &inputs, const Eigen::VectorXd &parameters);
+
+private:
+    // Replaces the squared distances of a query's neighbors "weights" by their normalized kernel weights
+    void KernelWeights(float *weights) const;
+
+    // Returns the Q value of a query from its neighbors "indices" with weights "weights"
+    double WeightedTarget(const unsigned int *indices, const float *weights) const;
+
+    ThreadPool &thread_pool_;
+
+    // The number of neighbors, at most the number of training inputs
+    unsigned int num_neighbors_;
+
+    double bandwidth_;
+
+    // The relative error bound of the neighbor search
+    double error_bound_;
+
+    // The tree of the training inputs
+    boost::shared_ptr<KDTree> tree_;
+
+    // The neighbors of query i are at [i * num_neighbors_, (i + 1) * num_neighbors_)
+    std::vector<unsigned int> query_indices_;
+    std::vector<float> query_weights_;
+
+    Eigen::VectorXd targets_;
+};
+
+#endif // NEARESTNEIGHBORREGRESSOR_H
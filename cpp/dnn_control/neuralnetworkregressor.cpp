@@ -0,0 +1,224 @@
+#include "neuralnetworkregressor.h"
+
+#include <cmath>
+#include <algorithm>
+
+// The number of inputs whose Q values are computed by one task
+static const unsigned int kBlockSize = 1024;
+
+// The decay rates of the moments of Adam and its term against division by 0
+static const double kAdamBeta1 = 0.9;
+static const double kAdamBeta2 = 0.999;
+static const double kAdamEpsilon = 1e-8;
+
+NeuralNetworkRegressor::NeuralNetworkRegressor(ThreadPool &thread_pool, const unsigned int &num_hidden_units, const unsigned int &num_epochs, const unsigned int &batch_size, const double &learning_rate, const unsigned int &seed)
+    : thread_pool_(thread_pool), num_hidden_units_(num_hidden_units), num_epochs_(num_epochs), batch_size_(batch_size), learning_rate_(learning_rate),
+      sample_factory_(seed), input_dimension_(0), num_steps_(0), target_mean_(0.0), target_deviation_(1.0) {
+
+    if (num_hidden_units_ == 0 || batch_size_ == 0 || learning_rate_ <= 0.0) {
+        throw InvalidInputsException();
+    }
+}
+
+void NeuralNetworkRegressor::SetInputs(const InputMatrix &inputs, const InputMatrix &queries) {
+    if (inputs.rows() == 0 || queries.cols() != inputs.cols()) {
+        throw InvalidInputsException();
+    }
+
+    inputs_ = inputs;
+    queries_ = queries;
+
+    const unsigned int input_dimension = inputs_.cols();
+    input_dimension_ = input_dimension;
+
+    // biases 0, weights with a deviation of 1 / sqrt(fan in)
+    const unsigned int hidden_stride = input_dimension + 1;
+    weights_ = Eigen::VectorXd::Zero(num_hidden_units_ * hidden_stride + 1 + num_hidden_units_);
+    for (unsigned int i = 0; i < num_hidden_units_; ++i) {
+        for (unsigned int j = 1; j < hidden_stride; ++j) {
+            weights_(i * hidden_stride + j) = sample_factory_.SampleNormal(0.0, 1.0 / std::sqrt(static_cast<double>(input_dimension)));
+        }
+    }
+    const unsigned int output_offset = num_hidden_units_ * hidden_stride;
+    for (unsigned int i = 0; i < num_hidden_units_; ++i) {
+        weights_(output_offset + 1 + i) = sample_factory_.SampleNormal(0.0, 1.0 / std::sqrt(static_cast<double>(num_hidden_units_)));
+    }
+
+    first_moments_ = Eigen::VectorXd::Zero(weights_.size());
+    second_moments_ = Eigen::VectorXd::Zero(weights_.size());
+    num_steps_ = 0;
+    target_mean_ = 0.0;
+    target_deviation_ = 1.0;
+}
+
+void NeuralNetworkRegressor::Fit(const Eigen::VectorXd &targets) {
+    const unsigned int num_inputs = inputs_.rows();
+    if (num_inputs == 0 || targets.size() != num_inputs) {
+        throw InvalidTargetsException();
+    }
+
+    // rescales the output layer to the new standardization, so the network's Q values stay the same
+    const double target_mean = targets.mean();
+    const double target_deviation = std::sqrt((targets.array() - target_mean).square().mean());
+    const double new_deviation = (target_deviation > 0.0 ? target_deviation : 1.0);
+    const unsigned int output_offset = num_hidden_units_ * (input_dimension_ + 1);
+    weights_(output_offset) = (weights_(output_offset) * target_deviation_ + target_mean_ - target_mean) / new_deviation;
+    weights_.tail(num_hidden_units_) *= target_deviation_ / new_deviation;
+    target_mean_ = target_mean;
+    target_deviation_ = new_deviation;
+    const Eigen::VectorXd standardized_targets = (targets.array() - target_mean_) / target_deviation_;
+
+    std::vector<unsigned int> order(num_inputs);
+    for (unsigned int i = 0; i < num_inputs; ++i) {
+        order[i] = i;
+    }
+
+    const unsigned int num_chunks = thread_pool_.NumThreads();
+    std::vector<Eigen::VectorXd> gradients(num_chunks);
+    for (unsigned int epoch = 0; epoch < num_epochs_; ++epoch) {
+        for (unsigned int i = num_inputs - 1; i > 0; --i) {
+            std::swap(order[i], order[sample_factory_.SampleRandomNatural() % (i + 1)]);
+        }
+
+        for (unsigned int begin = 0; begin < num_inputs; begin += batch_size_) {
+            const unsigned int batch_size = std::min(batch_size_, num_inputs - begin);
+            thread_pool_.ParallelFor(num_chunks, [&](const unsigned int &chunk, const unsigned int &) {
+                const unsigned int chunk_begin = begin + static_cast<unsigned long long>(batch_size) * chunk / num_chunks;
+                const unsigned int chunk_end = begin + static_cast<unsigned long long>(batch_size) * (chunk + 1) / num_chunks;
+                gradients[chunk] = Eigen::VectorXd::Zero(weights_.size());
+                AccumulateGradient(order.data() + chunk_begin, chunk_end - chunk_begin, standardized_targets, gradients[chunk]);
+            });
+
+            Eigen::VectorXd gradient = gradients[0];
+            for (unsigned int chunk = 1; chunk < num_chunks; ++chunk) {
+                gradient += gradients[chunk];
+            }
+            gradient /= batch_size;
+
+            num_steps_++;
+            first_moments_ = kAdamBeta1 * first_moments_ + (1.0 - kAdamBeta1) * gradient;
+            second_moments_ = kAdamBeta2 * second_moments_ + (1.0 - kAdamBeta2) * gradient.cwiseAbs2();
+            const double step_size = learning_rate_ * std::sqrt(1.0 - std::pow(kAdamBeta2, num_steps_)) / (1.0 - std::pow(kAdamBeta1, num_steps_));
+            weights_.array() -= step_size * first_moments_.array() / (second_moments_.array().sqrt() + kAdamEpsilon);
+        }
+    }
+}
+
+void NeuralNetworkRegressor::PredictQueries(Eigen::VectorXd &q_values) {
+    if (input_dimension_ == 0) {
+        throw InvalidInputsException();
+    }
+
+    const unsigned int num_queries = queries_.rows();
+    q_values.resize(num_queries);
+    const unsigned int num_blocks = (num_queries + kBlockSize - 1) / kBlockSize;
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        PredictRows(queries_, block * kBlockSize, std::min(num_queries, (block + 1) * kBlockSize), q_values);
+    });
+}
+
+void NeuralNetworkRegressor::Predict(const InputMatrix &inputs, Eigen::VectorXd &q_values) const {
+    if (input_dimension_ == 0 || inputs.cols() != input_dimension_) {
+        throw InvalidInputsException();
+    }
+
+    FeedForwardNeuralNetwork network = Network();
+    std::vector<double> input(input_dimension_);
+    q_values.resize(inputs.rows());
+    for (unsigned int i = 0; i < inputs.rows(); ++i) {
+        for (unsigned int j = 0; j < input_dimension_; ++j) {
+            input[j] = inputs(i, j);
+        }
+        q_values(i) = target_mean_ + target_deviation_ * network.Evaluate(input)[0];
+    }
+}
+
+Eigen::VectorXd NeuralNetworkRegressor::Parameters() const {
+    if (input_dimension_ == 0) {
+        throw InvalidInputsException();
+    }
+
+    Eigen::VectorXd parameters(2 + weights_.size());
+    parameters << target_mean_, target_deviation_, weights_;
+    return parameters;
+}
+
+void NeuralNetworkRegressor::SetParameters(const InputMatrix &inputs, const Eigen::VectorXd &parameters) {
+    if (inputs.rows() == 0) {
+        throw InvalidInputsException();
+    }
+    if (parameters.size() != 2 + num_hidden_units_ * (inputs.cols() + 1) + 1 + num_hidden_units_ || parameters(1) <= 0.0) {
+        throw InvalidParametersException();
+    }
+
+    inputs_ = inputs;
+    queries_.resize(0, inputs.cols());
+    input_dimension_ = inputs.cols();
+    target_mean_ = parameters(0);
+    target_deviation_ = parameters(1);
+    weights_ = parameters.tail(parameters.size() - 2);
+    first_moments_ = Eigen::VectorXd::Zero(weights_.size());
+    second_moments_ = Eigen::VectorXd::Zero(weights_.size());
+    num_steps_ = 0;
+}
+
+FeedForwardNeuralNetwork NeuralNetworkRegressor::Network() const {
+    if (input_dimension_ == 0) {
+        throw InvalidInputsException();
+    }
+
+    FeedForwardNeuralNetwork network(input_dimension_, true, 1, NeuralNetwork::ActivationFunctionType::Linear, {{num_hidden_units_, true, NeuralNetwork::ActivationFunctionType::Sigmoid}});
+    network.SetWeights(std::vector<double>(weights_.data(), weights_.data() + weights_.size()));
+    return network;
+}
+
+Eigen::MatrixXd NeuralNetworkRegressor::HiddenActivations(const Eigen::MatrixXd &x) const {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorMatrix;
+    const Eigen::Map<const RowMajorMatrix> hidden_weights(weights_.data(), num_hidden_units_, input_dimension_ + 1);
+
+    Eigen::MatrixXd hidden = x * hidden_weights.rightCols(input_dimension_).transpose();
+    hidden.rowwise() += hidden_weights.col(0).transpose();
+    return (1.0 + (-hidden.array()).exp()).inverse().matrix();
+}
+
+void NeuralNetworkRegressor::PredictRows(const InputMatrix &inputs, const unsigned int &begin, const unsigned int &end, Eigen::VectorXd &q_values) const {
+    if (begin >= end) {
+        return;
+    }
+
+    const unsigned int output_offset = num_hidden_units_ * (input_dimension_ + 1);
+    const Eigen::Map<const Eigen::VectorXd> output_weights(weights_.data() + output_offset + 1, num_hidden_units_);
+    const Eigen::MatrixXd hidden = HiddenActivations(inputs.middleRows(begin, end - begin).cast<double>());
+    q_values.segment(begin, end - begin) = (target_mean_ + target_deviation_ * ((hidden * output_weights).array() + weights_(output_offset))).matrix();
+}
+
+void NeuralNetworkRegressor::AccumulateGradient(const unsigned int *batch, const unsigned int &batch_size, const Eigen::VectorXd &targets, Eigen::VectorXd &gradient) const {
+    if (batch_size == 0) {
+        return;
+    }
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorMatrix;
+    const unsigned int input_dimension = inputs_.cols();
+    const unsigned int output_offset = num_hidden_units_ * (input_dimension + 1);
+    const Eigen::Map<const Eigen::VectorXd> output_weights(weights_.data() + output_offset + 1, num_hidden_units_);
+    Eigen::Map<RowMajorMatrix> hidden_gradient(gradient.data(), num_hidden_units_, input_dimension + 1);
+    Eigen::Map<Eigen::VectorXd> output_gradient(gradient.data() + output_offset + 1, num_hidden_units_);
+
+    Eigen::MatrixXd x(batch_size, input_dimension);
+    Eigen::VectorXd t(batch_size);
+    for (unsigned int k = 0; k < batch_size; ++k) {
+        x.row(k) = inputs_.row(batch[k]).cast<double>();
+        t(k) = targets(batch[k]);
+    }
+
+    // forward pass, one row of hidden activations per input
+    const Eigen::MatrixXd hidden = HiddenActivations(x);
+    const Eigen::VectorXd errors = (hidden * output_weights).array() + weights_(output_offset) - t.array();
+
+    // backward pass of 1/2 the squared errors
+    gradient(output_offset) += errors.sum();
+    output_gradient += hidden.transpose() * errors;
+    const Eigen::MatrixXd deltas = ((errors * output_weights.transpose()).array() * hidden.array() * (1.0 - hidden.array())).matrix();
+    hidden_gradient.col(0) += deltas.colwise().sum().transpose();
+    hidden_gradient.rightCols(input_dimension) += deltas.transpose() * x;
+}
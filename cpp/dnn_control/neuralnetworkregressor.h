@@ -0,0 +1,90 @@
+#ifndef NEURALNETWORKREGRESSOR_H
+#define NEURALNETWORKREGRESSOR_H
+
+#include "feedforwardneuralnetwork.h"
+#include "qregressor.h"
+#include "samplefactory.h"
+#include "threadpool.h"
+
+#include <vector>
+
+class NeuralNetworkRegressor : public QRegressor {
+    /*
+    * This class represents a regression of Q values by a FeedForwardNeuralNetwork with one hidden layer of sigmoid
+    * units and a linear output, both with bias. Network returns the network of the current weights.
+    *
+    * Fit trains the weights by Adam on the squared error of mini batches of shuffled training inputs, starting from
+    * the weights of the previous fit, for a fixed number of epochs. The network learns standardized targets, when the
+    * mean and deviation of the targets change the output layer is rescaled so it keeps its Q values. The gradient of a
+    * mini batch is accumulated in one chunk per thread and the chunks are summed in order, so a fit does not depend on
+    * the number of threads up to rounding.
+    *
+    * Training and the Q values of the queries use the same weights as one matrix product per layer, the queries in
+    * blocks on the thread pool. The queries are copied, 4 bytes per value. Predict, e.g. for the few candidate actions
+    * of a policy's state, evaluates the inputs one by one with the Network. The parameters of the regression are the
+    * mean and the deviation of the targets followed by the weights.
+    */
+public:
+    NeuralNetworkRegressor(ThreadPool &thread_pool, const unsigned int &num_hidden_units, const unsigned int &num_epochs, const unsigned int &batch_size, const double &learning_rate, const unsigned int &seed);
+
+    virtual void SetInputs(const InputMatrix &inputs, const InputMatrix &queries);
+
+    virtual void Fit(const Eigen::VectorXd &targets);
+
+    virtual void PredictQueries(Eigen::VectorXd &q_values);
+
+    virtual void Predict(const InputMatrix &inputs, Eigen::VectorXd &q_values) const;
+
+    virtual Eigen::VectorXd Parameters() const;
+
+    virtual void SetParameters(const InputMatrix &inputs, const Eigen::VectorXd &parameters);
+
+    // Returns the network of the current weights, whose output y is the Q value target_mean + target_deviation * y of
+    // the parameters
+    FeedForwardNeuralNetwork Network() const;
+
+private:
+    // Returns the sigmoid activations of the hidden units for the inputs "x", one row per input
+    Eigen::MatrixXd HiddenActivations(const Eigen::MatrixXd &x) const;
+
+    // Computes the Q values of the rows [begin, end) of "inputs" into the same rows of "q_values"
+    void PredictRows(const InputMatrix &inputs, const unsigned int &begin, const unsigned int &end, Eigen::VectorXd &q_values) const;
+
+    // Adds the gradient of the squared error of the standardized targets "targets" of the training inputs
+    // "batch[0..batch_size)" to "gradient"
+    void AccumulateGradient(const unsigned int *batch, const unsigned int &batch_size, const Eigen::VectorXd &targets, Eigen::VectorXd &gradient) const;
+
+    ThreadPool &thread_pool_;
+
+    unsigned int num_hidden_units_;
+
+    unsigned int num_epochs_;
+
+    unsigned int batch_size_;
+
+    double learning_rate_;
+
+    // Initializes the weights and shuffles the training inputs
+    SampleFactory sample_factory_;
+
+    InputMatrix inputs_;
+    InputMatrix queries_;
+
+    // The number of values of an input
+    unsigned int input_dimension_;
+
+    // The weights of the Network: per hidden unit its bias and input weights, then the bias and the hidden unit weights
+    // of the output
+    Eigen::VectorXd weights_;
+
+    // The moment estimates and the number of steps of Adam
+    Eigen::VectorXd first_moments_;
+    Eigen::VectorXd second_moments_;
+    unsigned int num_steps_;
+
+    // The Q value of a network output y is target_mean_ + target_deviation_ * y
+    double target_mean_;
+    double target_deviation_;
+};
+
+#endif // NEURALNETWORKREGRESSOR_H
@@ -0,0 +1,14 @@
+#include "noisebuffer.h"
+
+const unsigned int NoiseBuffer::kDefaultBlockSize;
+
+NoiseBuffer::NoiseBuffer(SampleFactory &sample_factory, const unsigned int &block_size)
+    : sample_factory_(sample_factory), block_(block_size) {
+    // the first block is drawn on first use
+    cursor_ = block_.size();
+}
+
+void NoiseBuffer::Refill() {
+    sample_factory_.FillNormal(block_, 0.0, 1.0);
+    cursor_ = 0;
+}
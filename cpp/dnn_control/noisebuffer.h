@@ -0,0 +1,46 @@
+#ifndef NOISEBUFFER_H
+#define NOISEBUFFER_H
+
+#include "samplefactory.h"
+
+#include <vector>
+
+class NoiseBuffer {
+    /*
+    * This class draws standard normal variates from a SampleFactory in blocks and hands them out with a cursor.
+    *
+    * The variates are drawn in the same order from the same generator, hence a NoiseBuffer returns exactly the values
+    * the SampleFactory would have returned for the same sequence of SampleNormal calls. The buffer reads ahead by up to
+    * one block, so nothing else may draw from the factory while the buffer is in use.
+    */
+public:
+    // The default number of variates drawn at once
+    const static unsigned int kDefaultBlockSize = 256;
+
+    NoiseBuffer(SampleFactory &sample_factory, const unsigned int &block_size=kDefaultBlockSize);
+
+    // X ~ N(mean, std)
+    double SampleNormal(const double &mean, const double &standard_deviation);
+
+private:
+    // Draws the next block of variates from the factory
+    void Refill();
+
+    // The factory the variates are drawn from
+    SampleFactory &sample_factory_;
+
+    // The drawn N(0,1) variates
+    std::vector<double> block_;
+
+    // Position of the next unused variate in block_
+    unsigned int cursor_;
+};
+
+inline double NoiseBuffer::SampleNormal(const double &mean, const double &standard_deviation) {
+    if (cursor_ == block_.size()) {
+        Refill();
+    }
+    return block_[cursor_++] * standard_deviation + mean;
+}
+
+#endif // NOISEBUFFER_H
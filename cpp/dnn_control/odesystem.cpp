@@ -10,6 +10,9 @@ ODESystem::ODESystem(const Asteroid &asteroid, const Vector3D &perturbations_acc
     spacecraft_specific_impulse_ = spacecraft_specific_impulse;
     spacecraft_minimum_mass_ = spacecraft_minimum_mass;
     engine_noise_ = engine_noise;
+    gravity_model_ = &asteroid;
+    shape_model_ = NULL;
+    physics_snapshot_ = NULL;
 }
 
 ODESystem::ODESystem(const ODESystem &other)
@@ -20,6 +23,21 @@ ODESystem::ODESystem(const ODESystem &other)
     spacecraft_specific_impulse_ = other.spacecraft_specific_impulse_;
     spacecraft_minimum_mass_ = other.spacecraft_minimum_mass_;
     engine_noise_ = other.engine_noise_;
+    gravity_model_ = other.gravity_model_;
+    shape_model_ = other.shape_model_;
+    physics_snapshot_ = other.physics_snapshot_;
+}
+
+void ODESystem::SetGravityModel(const GravityModel *gravity_model) {
+    gravity_model_ = (gravity_model != NULL ? gravity_model : &asteroid_);
+}
+
+void ODESystem::SetShapeModel(const ShapeModel *shape_model) {
+    shape_model_ = shape_model;
+}
+
+void ODESystem::SetPhysicsSnapshot(const PhysicsSnapshot *physics_snapshot) {
+    physics_snapshot_ = physics_snapshot;
 }
 
 void ODESystem::operator ()(const SystemState &state, SystemState &d_state_dt, const double &time) {
@@ -35,34 +53,44 @@ void ODESystem::operator ()(const SystemState &state, SystemState &d_state_dt, c
     const Vector3D &position = {state[0], state[1], state[2]};
     const Vector3D &velocity = {state[3], state[4], state[5]};
 
-    // Fg
-    const Vector3D gravity_acceleration = asteroid_.GravityAccelerationAtPosition(position);
+    // crash
+    if (shape_model_ != NULL && shape_model_->PositionIsInside(position)) {
+        throw Asteroid::PositionInsideException();
+    }
+
+    Vector3D gravity_acceleration;
+    Vector3D angular_velocity;
+    Vector3D angular_acceleration;
+    if (physics_snapshot_ != NULL && physics_snapshot_->Matches(position, time)) {
+        // Fg, w, w' of the tick, shared with the sensor simulators
+        gravity_acceleration = physics_snapshot_->GravityAcceleration();
+        angular_velocity = physics_snapshot_->AngularVelocity();
+        angular_acceleration = physics_snapshot_->AngularAcceleration();
+    } else {
+        // Fg
+        gravity_acceleration = gravity_model_->GravityAccelerationAtPosition(position);
 
-    // w, w'
-    const boost::tuple<Vector3D, Vector3D> result = asteroid_.AngularVelocityAndAccelerationAtTime(time);
-    const Vector3D &angular_velocity = boost::get<0>(result);
-    const Vector3D &angular_acceleration = boost::get<1>(result);
+        // w, w'
+        const boost::tuple<Vector3D, Vector3D> result = asteroid_.AngularVelocityAndAccelerationAtTime(time);
+        angular_velocity = boost::get<0>(result);
+        angular_acceleration = boost::get<1>(result);
+    }
 
     // Fc
     const Vector3D thrust_acceleration = VectorMul(coef_mass, thrust_);
 
-    // w' x r
-    const Vector3D euler_acceleration = VectorCrossProduct(angular_acceleration, position);
-
-    // w x (w x r)
-    const Vector3D centrifugal_acceleration = VectorCrossProduct(angular_velocity, VectorCrossProduct(angular_velocity, position));
+    // Fp + Fg + Fc
+    Vector3D external_acceleration;
+    for (unsigned int i = 0; i < 3; ++i) {
+        external_acceleration[i] = perturbations_acceleration_[i] + gravity_acceleration[i] + thrust_acceleration[i];
+    }
 
-    // 2w x r'
-    const Vector3D coriolis_acceleration = VectorCrossProduct(VectorMul(2.0, angular_velocity), velocity);
+    // - 2w x r' - w' x r - w x (w x r)
+    const Vector3D acceleration = VectorRotatingFrameAcceleration(external_acceleration, angular_velocity, angular_acceleration, position, velocity);
 
     for (unsigned int i = 0; i < 3 ;++i) {
         d_state_dt[i] = state[3+i];
-        d_state_dt[3+i] = perturbations_acceleration_[i]
-                + gravity_acceleration[i]
-                + thrust_acceleration[i]
-                - coriolis_acceleration[i]
-                - euler_acceleration[i]
-                - centrifugal_acceleration[i];
+        d_state_dt[3+i] = acceleration[i];
     }
 
     if (fuel_usage_enabled_) {
@@ -4,10 +4,17 @@
 #include "vector.h"
 #include "systemstate.h"
 #include "asteroid.h"
+#include "physicssnapshot.h"
 
 class ODESystem {
     /*
     * This class represents an ordinary differential equation system.
+    *
+    * If a PhysicsSnapshot is attached, evaluations at the snapshot's position and time (the first stage of every step
+    * starting at the tick's state) take gravity and angular velocity from the snapshot instead of recomputing them.
+    *
+    * If a shape model is set, every evaluation at a position inside it throws Asteroid::PositionInsideException, so a
+    * crash into a mesh is detected by its exact inside test and not only by the gravity model.
     */
 public:
     ODESystem(const Asteroid &asteroid, const Vector3D &perturbations_acceleration, const Vector3D &thrust, const double &spacecraft_specific_impulse, const double &spacecraft_minimum_mass, const double &engine_noise, const bool &fuel_usage_enabled);
@@ -16,6 +23,15 @@ public:
 
     void operator () (const SystemState &state, SystemState &d_state_dt, const double &time);
 
+    // Replace the asteroid's gravity, pass NULL for the asteroid's own. The model has to outlive the system and its copies.
+    void SetGravityModel(const GravityModel *gravity_model);
+
+    // Detect crashes by the shape "shape_model", pass NULL to leave them to the gravity model. The model has to outlive the system and its copies.
+    void SetShapeModel(const ShapeModel *shape_model);
+
+    // Attach the physics of the current tick, pass NULL to detach. The snapshot has to outlive the system and its copies.
+    void SetPhysicsSnapshot(const PhysicsSnapshot *physics_snapshot);
+
     // ODESystem can throw the following exceptions
     class Exception {};
     class OutOfFuelException : public Exception {};
@@ -41,6 +57,15 @@ private:
 
     // The asteroid the ode system works with
     const Asteroid &asteroid_;
+
+    // The gravity used, the asteroid's by default
+    const GravityModel *gravity_model_;
+
+    // The shape which detects crashes, if set
+    const ShapeModel *shape_model_;
+
+    // The physics of the current tick, if attached
+    const PhysicsSnapshot *physics_snapshot_;
 };
 
 #endif // ODESYSTEM_H
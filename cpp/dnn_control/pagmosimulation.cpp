@@ -1,5 +1,6 @@
 #include "pagmosimulation.h"
 #include "samplefactory.h"
+#include "asteroidcache.h"
 #include "odeint.h"
 #include "modifiedcontrolledrungekutta.h"
 #include "odesystem.h"
@@ -9,7 +10,7 @@
 PaGMOSimulation::PaGMOSimulation(const unsigned int &random_seed, const std::set<SensorSimulator::SensorType> &control_sensor_types, const bool &control_with_noise, const std::set<SensorSimulator::SensorType> &recording_sensor_types, const bool &recording_with_noise, const bool &fuel_usage_enabled, const bool &initial_spacecraft_offset_enabled, const InitialSpacecraftVelocity &initial_spacecraft_velocity, const std::map<SensorSimulator::SensorType, std::vector<std::pair<double, double> > > &sensor_value_transformations)
     : random_seed_(random_seed), simulation_time_(0.0), control_sensor_types_(control_sensor_types), control_with_noise_(control_with_noise), recording_sensor_types_(recording_sensor_types), recording_with_noise_(recording_with_noise), fuel_usage_enabled_(fuel_usage_enabled), initial_spacecraft_offset_enabled_(initial_spacecraft_offset_enabled), initial_spacecraft_velocity_(initial_spacecraft_velocity), sensor_value_transformations_(sensor_value_transformations) {
     Init();
-    simulation_time_ = (int) (asteroid_.EstimatedMainMotionPeriod() * 0.5);
+    simulation_time_ = (int) (asteroid_->EstimatedMainMotionPeriod() * 0.5);
 }
 
 PaGMOSimulation::PaGMOSimulation(const unsigned int &random_seed, const double &simulation_time, const std::set<SensorSimulator::SensorType> &control_sensor_types, const bool &control_with_noise, const std::set<SensorSimulator::SensorType> &recording_sensor_types, const bool &recording_with_noise, const bool &fuel_usage_enabled, const bool &initial_spacecraft_offset_enabled, const InitialSpacecraftVelocity &initial_spacecraft_velocity, const std::map<SensorSimulator::SensorType, std::vector<std::pair<double, double> > > &sensor_value_transformations)
@@ -33,8 +34,8 @@ double PaGMOSimulation::ControlFrequency() const {
     return control_frequency_;
 }
 
-Asteroid &PaGMOSimulation::AsteroidOfSystem() {
-    return asteroid_;
+const Asteroid &PaGMOSimulation::AsteroidOfSystem() const {
+    return *asteroid_;
 }
 
 double PaGMOSimulation::SpacecraftMaximumMass() const {
@@ -73,23 +74,48 @@ void PaGMOSimulation::SetSimulationTime(const double &simulation_time) {
     simulation_time_ = simulation_time;
 }
 
+void PaGMOSimulation::SetRecordingStride(const unsigned int &stride) {
+    if (stride == 0) {
+        throw InvalidRecordingStrideException();
+    }
+    recording_stride_ = stride;
+}
+
+void PaGMOSimulation::SetRecordingCapacity(const unsigned int &capacity) {
+    recording_capacity_ = capacity;
+}
+
+unsigned int PaGMOSimulation::RecordingStride() const {
+    return recording_stride_;
+}
+
+void PaGMOSimulation::SetGravityModel(const boost::shared_ptr<const GravityModel> &gravity_model) {
+    gravity_model_ = gravity_model;
+}
+
+void PaGMOSimulation::SetShapeModel(const boost::shared_ptr<const ShapeModel> &shape_model) {
+    shape_model_ = shape_model;
+}
+
+unsigned int PaGMOSimulation::RecordingCapacity() const {
+    return recording_capacity_;
+}
+
+std::vector<unsigned int> PaGMOSimulation::RecordedTicks() const {
+    return recorded_ticks_;
+}
+
 void PaGMOSimulation::Init() {
     minimum_step_size_ = 0.1;
     fixed_step_size_ = 0.1;
     control_frequency_ = 1.0;
+    recording_stride_ = 1;
+    recording_capacity_ = 0;
 
-    SampleFactory asteroid_sf(random_seed_);
     SampleFactory spacecraft_sf(random_seed_);
 
-    const double c_semi_axis = asteroid_sf.SampleUniformReal(100.0, 8000.0);
-    const double b_semi_axis_n = asteroid_sf.SampleUniformReal(1.1, 2.0);
-    const double a_semi_axis_n = asteroid_sf.SampleUniformReal(1.1 * b_semi_axis_n, 4.0);
-    const Vector3D &semi_axis = {a_semi_axis_n * c_semi_axis, b_semi_axis_n * c_semi_axis, c_semi_axis};
-    const double density = asteroid_sf.SampleUniformReal(1500.0, 3000.0);
-    const double magn_angular_velocity = 0.85 * sqrt((kGravitationalConstant * 4.0/3.0 * kPi * semi_axis[0] * semi_axis[1] * semi_axis[2] * density) / (semi_axis[0] * semi_axis[0] * semi_axis[0]));
-    const Vector2D &angular_velocity_xz = {asteroid_sf.SampleSign() * asteroid_sf.SampleUniformReal(magn_angular_velocity * 0.5, magn_angular_velocity), asteroid_sf.SampleSign() * asteroid_sf.SampleUniformReal(magn_angular_velocity * 0.5, magn_angular_velocity)};
-    const double time_bias = asteroid_sf.SampleUniformReal(0.0, 12.0 * 60 * 60);
-    asteroid_ = Asteroid(semi_axis, density, angular_velocity_xz, time_bias);
+    asteroid_ = AsteroidCache::AsteroidForSeed(random_seed_);
+    const Vector3D semi_axis = asteroid_->SemiAxis();
 
     spacecraft_maximum_mass_ = spacecraft_sf.SampleUniformReal(450.0, 500.0);
     spacecraft_minimum_mass_ = spacecraft_maximum_mass_ * 0.5;
@@ -135,11 +161,11 @@ void PaGMOSimulation::Init() {
     switch(initial_spacecraft_velocity_) {
     case InertialOrbitalVelocity:
     {
-        const Vector3D angular_velocity = boost::get<0>(asteroid_.AngularVelocityAndAccelerationAtTime(0.0));
+        const Vector3D angular_velocity = boost::get<0>(asteroid_->AngularVelocityAndAccelerationAtTime(0.0));
         spacecraft_velocity = VectorCrossProduct(angular_velocity, spacecraft_position);
 
         const double norm_position = VectorNorm(spacecraft_position);
-        const double magn_orbital_vel = sqrt(asteroid_.MassGravitationalConstant() / norm_position);
+        const double magn_orbital_vel = sqrt(asteroid_->MassGravitationalConstant() / norm_position);
         Vector3D orth_pos = {spacecraft_sf.SampleSign() * spacecraft_sf.SampleUniformReal(1e-10, 1.0), spacecraft_sf.SampleSign() * spacecraft_sf.SampleUniformReal(1e-10, 1.0), spacecraft_sf.SampleSign() * spacecraft_sf.SampleUniformReal(1e-10, 1.0)};
 
         std::vector<unsigned int> choices;
@@ -171,7 +197,7 @@ void PaGMOSimulation::Init() {
 
     case InertialZeroVelocity:
     {
-        const Vector3D angular_velocity = boost::get<0>(asteroid_.AngularVelocityAndAccelerationAtTime(0.0));
+        const Vector3D angular_velocity = boost::get<0>(asteroid_->AngularVelocityAndAccelerationAtTime(0.0));
         spacecraft_velocity = VectorMul(-1.0, VectorCrossProduct(angular_velocity, spacecraft_position));
     }
         break;
@@ -6,6 +6,8 @@
 #include "systemstate.h"
 #include "sensorsimulator.h"
 
+#include <boost/shared_ptr.hpp>
+
 #include <boost/tuple/tuple.hpp>
 
 class PaGMOSimulation {
@@ -43,7 +45,7 @@ public:
     SystemState InitialSystemState() const;
 
     // Returns the asteroid the simulation is working with
-    Asteroid& AsteroidOfSystem();
+    const Asteroid& AsteroidOfSystem() const;
 
     // Returns the random seed the simulation is configured with
     unsigned int RandomSeed() const;
@@ -75,9 +77,32 @@ public:
     // Change the simulation time manually
     void SetSimulationTime(const double &simulation_time);
 
+    // Record the sensor data of every "stride"-th tick only
+    void SetRecordingStride(const unsigned int &stride);
+
+    // Keep only the sensor data of the last "capacity" recorded ticks, 0 keeps all
+    void SetRecordingCapacity(const unsigned int &capacity);
+
+    // Replace the asteroid's gravity or shape (e.g. by a PolyhedronGravity and PolyhedronShape of a mesh), an empty
+    // pointer restores the asteroid's ellipsoid. The asteroid keeps providing the rotation, a replaced shape also
+    // detects crashes.
+    void SetGravityModel(const boost::shared_ptr<const GravityModel> &gravity_model);
+    void SetShapeModel(const boost::shared_ptr<const ShapeModel> &shape_model);
+
+    // Returns the recording stride
+    unsigned int RecordingStride() const;
+
+    // Returns the recording capacity
+    unsigned int RecordingCapacity() const;
+
+    // Returns for each recorded sensor data entry of the last evaluation the index of its tick in the evaluated times.
+    // Without recording sensor types nothing is recorded.
+    std::vector<unsigned int> RecordedTicks() const;
+
     // PaGMOSimulation can throw the following exceptions
     class Exception {};
     class InitialConditionNotImplemented : public Exception {};
+    class InvalidRecordingStrideException : public Exception {};
 
 protected:
     // This class is used to observe the actual simulated time in case of an exception in the adaptive integration (out of fuel, crash)
@@ -130,8 +155,12 @@ protected:
     // Random perturbation standard deviation during the simulation
     double perturbation_noise_;
 
-    // The asteroid the simulation works with
-    Asteroid asteroid_;
+    // The asteroid the simulation works with, shared with all simulations on the same asteroid
+    boost::shared_ptr<const Asteroid> asteroid_;
+
+    // Replacements of the asteroid's gravity and shape, empty for the asteroid's own
+    boost::shared_ptr<const GravityModel> gravity_model_;
+    boost::shared_ptr<const ShapeModel> shape_model_;
 
     // The initial spacecraft system state
     SystemState initial_system_state_;
@@ -165,6 +194,15 @@ protected:
 
     // Sensor values can be transformed using these two parameters
     std::map<SensorSimulator::SensorType, std::vector<std::pair<double, double> > > sensor_value_transformations_;
+
+    // Sensor data is recorded every recording_stride_-th tick
+    unsigned int recording_stride_;
+
+    // The number of recorded ticks kept, 0 if all
+    unsigned int recording_capacity_;
+
+    // The ticks the sensor data of the last evaluation was recorded at
+    std::vector<unsigned int> recorded_ticks_;
 };
 
 #endif // PAGMOSIMULATION_H
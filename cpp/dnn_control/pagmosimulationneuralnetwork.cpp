@@ -3,7 +3,10 @@
 #include "modifiedcontrolledrungekutta.h"
 #include "odesystem.h"
 #include "samplefactory.h"
+#include "noisebuffer.h"
 #include "sensorsimulator.h"
+#include "physicssnapshot.h"
+#include "recordingbuffer.h"
 #include "controllerneuralnetwork.h"
 #include "controllerdeepneuralnetwork.h"
 #include "configuration.h"
@@ -40,13 +43,16 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
     SampleFactory sf_sensor_simulator(sample_factory.SampleRandomNatural());
     SampleFactory sf_sensor_recording(sf_sensor_simulator.Seed());
 
-    SensorSimulator sensor_simulator(sf_sensor_simulator, asteroid_);
+    // all further samples of sample_factory are normal variates, draw them in blocks
+    NoiseBuffer noise_buffer(sample_factory);
+
+    SensorSimulator sensor_simulator(sf_sensor_simulator, *asteroid_);
     sensor_simulator.SetNoiseEnabled(control_with_noise_);
     sensor_simulator.SetSensorTypes(control_sensor_types_);
     sensor_simulator.SetSensorValueTransformations(sensor_value_transformations_);
     sensor_simulator.SetTargetPosition(target_position_);
 
-    SensorSimulator sensor_recorder(sf_sensor_recording, asteroid_);
+    SensorSimulator sensor_recorder(sf_sensor_recording, *asteroid_);
     sensor_recorder.SetNoiseEnabled(recording_with_noise_);
     sensor_recorder.SetSensorTypes(recording_sensor_types_);
     sensor_recorder.SetSensorValueTransformations(sensor_value_transformations_);
@@ -68,10 +74,22 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
     std::vector<Vector3D> evaluated_velocities(num_iterations + 1);
     std::vector<Vector3D> evaluated_heights(num_iterations + 1);
     std::vector<Vector3D> evaluated_thrusts(num_iterations +1);
-    std::vector<std::vector<double> > evaluated_sensor_data(num_iterations + 1);
+    std::vector<std::vector<double> > evaluated_sensor_data;
+
+    // without recording sensors the recorder is never run
+    const bool recording_enabled = recording_sensor_types_.size() > 0;
+    RecordingBuffer recording_buffer(recording_stride_, recording_capacity_);
+    if (recording_enabled) {
+        recording_buffer.Reserve(num_iterations / recording_stride_ + 2);
+    }
 
     SystemState system_state(initial_system_state_);
 
+    // the physics of each tick, shared by both sensor simulators and the ode system
+    PhysicsSnapshot physics_snapshot(*asteroid_);
+    physics_snapshot.SetGravityModel(gravity_model_.get());
+    physics_snapshot.SetShapeModel(shape_model_.get());
+
     Vector3D perturbations_acceleration;
     Vector3D thrust;
     std::vector<double> sensor_data;
@@ -89,8 +107,8 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
             const Vector3D &velocity = {system_state[3], system_state[4], system_state[5]};
             const double &mass = system_state[6];
 
-            const Vector3D surf_pos = boost::get<0>(asteroid_.NearestPointOnSurfaceToPosition(position));
-            const Vector3D height = VectorSub(position, surf_pos);
+            physics_snapshot.Update(system_state, current_time);
+            const Vector3D &height = physics_snapshot.Height();
 
             evaluated_times.at(iteration) = current_time;
             evaluated_masses.at(iteration) = mass;
@@ -99,21 +117,26 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
             evaluated_heights.at(iteration) = height;
 
             for (unsigned int i = 0; i < 3; ++i) {
-                perturbations_acceleration[i] = sample_factory.SampleNormal(perturbation_mean_, perturbation_noise_);
+                perturbations_acceleration[i] = noise_buffer.SampleNormal(perturbation_mean_, perturbation_noise_);
             }
 
-            sensor_data = sensor_simulator.Simulate(system_state, height, perturbations_acceleration, current_time, thrust);
+            sensor_simulator.Simulate(physics_snapshot, perturbations_acceleration, thrust, sensor_data);
 
-            sensor_recording = sensor_recorder.Simulate(system_state, height, perturbations_acceleration, current_time, thrust);
-            evaluated_sensor_data.at(iteration) = sensor_recording;
+            if (recording_enabled && recording_buffer.IsDue(iteration)) {
+                sensor_recorder.Simulate(physics_snapshot, perturbations_acceleration, thrust, sensor_recording);
+                recording_buffer.Store(iteration, sensor_recording);
+            }
 
 
             thrust = controller.GetThrustForSensorData(sensor_data);
             evaluated_thrusts.at(iteration) = thrust;
 
-            const double engine_noise = sample_factory.SampleNormal(0.0, spacecraft_engine_noise_);
+            const double engine_noise = noise_buffer.SampleNormal(0.0, spacecraft_engine_noise_);
 
-            ODESystem ode_system(asteroid_, perturbations_acceleration, thrust, spacecraft_specific_impulse_, spacecraft_minimum_mass_, engine_noise, fuel_usage_enabled_);
+            ODESystem ode_system(*asteroid_, perturbations_acceleration, thrust, spacecraft_specific_impulse_, spacecraft_minimum_mass_, engine_noise, fuel_usage_enabled_);
+            ode_system.SetGravityModel(gravity_model_.get());
+            ode_system.SetShapeModel(shape_model_.get());
+            ode_system.SetPhysicsSnapshot(&physics_snapshot);
 
             integrate_adaptive(controlled_stepper, ode_system, system_state, current_time, current_time + dt, minimum_step_size_, observer);
 
@@ -133,7 +156,6 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
         evaluated_positions.resize(new_size);
         evaluated_velocities.resize(new_size);
         evaluated_heights.resize(new_size);
-        evaluated_sensor_data.resize(new_size);
         evaluated_thrusts.resize(new_size);
     }
 
@@ -141,7 +163,8 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
     const Vector3D &velocity = {system_state[3], system_state[4], system_state[5]};
     const double &mass = system_state[6];
 
-    const Vector3D surf_pos = boost::get<0>(asteroid_.NearestPointOnSurfaceToPosition(position));
+    const ShapeModel &shape_model = (shape_model_ ? *shape_model_ : *asteroid_);
+    const Vector3D surf_pos = boost::get<0>(shape_model.NearestPointOnSurfaceToPosition(position));
     const Vector3D height = VectorSub(position, surf_pos);
 
     evaluated_times.back() = current_time_observer;
@@ -149,9 +172,15 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
     evaluated_positions.back() = position;
     evaluated_velocities.back() = velocity;
     evaluated_heights.back() = height;
-    evaluated_sensor_data.back() = sensor_recording;
     evaluated_thrusts.back() = thrust;
 
+    // the final state repeats the last recording, which is only the previous tick's without decimation
+    if (recording_enabled && recording_stride_ == 1) {
+        recording_buffer.Store(evaluated_times.size() - 1, sensor_recording);
+    }
+    evaluated_sensor_data = recording_buffer.Recordings();
+    recorded_ticks_ = recording_buffer.Ticks();
+
     return boost::make_tuple(evaluated_times, evaluated_masses, evaluated_positions, evaluated_heights, evaluated_velocities, evaluated_thrusts, evaluated_sensor_data);
 }
 
@@ -162,13 +191,16 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
     SampleFactory sf_sensor_simulator(sample_factory.SampleRandomNatural());
     SampleFactory sf_sensor_recording(sf_sensor_simulator.Seed());
 
-    SensorSimulator sensor_simulator(sf_sensor_simulator, asteroid_);
+    // all further samples of sample_factory are normal variates, draw them in blocks
+    NoiseBuffer noise_buffer(sample_factory);
+
+    SensorSimulator sensor_simulator(sf_sensor_simulator, *asteroid_);
     sensor_simulator.SetNoiseEnabled(control_with_noise_);
     sensor_simulator.SetSensorTypes(control_sensor_types_);
     sensor_simulator.SetSensorValueTransformations(sensor_value_transformations_);
     sensor_simulator.SetTargetPosition(target_position_);
 
-    SensorSimulator sensor_recorder(sf_sensor_recording, asteroid_);
+    SensorSimulator sensor_recorder(sf_sensor_recording, *asteroid_);
     sensor_recorder.SetNoiseEnabled(recording_with_noise_);
     sensor_recorder.SetSensorTypes(recording_sensor_types_);
     sensor_recorder.SetSensorValueTransformations(sensor_value_transformations_);
@@ -188,11 +220,21 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
     std::vector<Vector3D> evaluated_thrusts;
     std::vector<std::vector<double> > evaluated_sensor_data;
 
+    // without recording sensors the recorder is never run
+    const bool recording_enabled = recording_sensor_types_.size() > 0;
+    RecordingBuffer recording_buffer(recording_stride_, recording_capacity_);
+
     SystemState system_state(initial_system_state_);
 
+    // the physics of each tick, shared by both sensor simulators and the ode system
+    PhysicsSnapshot physics_snapshot(*asteroid_);
+    physics_snapshot.SetGravityModel(gravity_model_.get());
+    physics_snapshot.SetShapeModel(shape_model_.get());
+
     Vector3D perturbations_acceleration;
     Vector3D thrust;
     std::vector<double> sensor_data;
+    std::vector<double> sensor_recording;
 
     double current_time = 0.0;
     double engine_noise = 0.0;
@@ -203,8 +245,8 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
             const Vector3D &velocity = {system_state[3], system_state[4], system_state[5]};
             const double &mass = system_state[6];
 
-            const Vector3D surf_pos = boost::get<0>(asteroid_.NearestPointOnSurfaceToPosition(position));
-            const Vector3D height = VectorSub(position, surf_pos);
+            physics_snapshot.Update(system_state, current_time);
+            const Vector3D &height = physics_snapshot.Height();
 
             evaluated_times.push_back(current_time);
             evaluated_masses.push_back(mass);
@@ -213,20 +255,25 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
             evaluated_heights.push_back(height);
 
             for (unsigned int i = 0; i < 3; ++i) {
-                perturbations_acceleration[i] = sample_factory.SampleNormal(perturbation_mean_, perturbation_noise_);
+                perturbations_acceleration[i] = noise_buffer.SampleNormal(perturbation_mean_, perturbation_noise_);
             }
 
-            sensor_data = sensor_simulator.Simulate(system_state, height, perturbations_acceleration, current_time, thrust);
+            sensor_simulator.Simulate(physics_snapshot, perturbations_acceleration, thrust, sensor_data);
 
-            const std::vector<double> sensor_recording = sensor_recorder.Simulate(system_state, height, perturbations_acceleration, current_time, thrust);
-            evaluated_sensor_data.push_back(sensor_recording);
+            if (recording_enabled && recording_buffer.IsDue(evaluated_times.size() - 1)) {
+                sensor_recorder.Simulate(physics_snapshot, perturbations_acceleration, thrust, sensor_recording);
+                recording_buffer.Store(evaluated_times.size() - 1, sensor_recording);
+            }
 
             thrust = controller.GetThrustForSensorData(sensor_data);
             evaluated_thrusts.push_back(thrust);
 
-            engine_noise = sample_factory.SampleNormal(0.0, spacecraft_engine_noise_);
+            engine_noise = noise_buffer.SampleNormal(0.0, spacecraft_engine_noise_);
 
-            ODESystem ode_system(asteroid_, perturbations_acceleration, thrust, spacecraft_specific_impulse_, spacecraft_minimum_mass_, engine_noise, fuel_usage_enabled_);
+            ODESystem ode_system(*asteroid_, perturbations_acceleration, thrust, spacecraft_specific_impulse_, spacecraft_minimum_mass_, engine_noise, fuel_usage_enabled_);
+            ode_system.SetGravityModel(gravity_model_.get());
+            ode_system.SetShapeModel(shape_model_.get());
+            ode_system.SetPhysicsSnapshot(&physics_snapshot);
 
             for (unsigned int i = 0; i < num_steps; ++i) {
                 stepper.do_step(ode_system, system_state, current_time, fixed_step_size_);
@@ -239,12 +286,15 @@ boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, st
         //std::cout << "The spacecraft is out of fuel." << std::endl;
     }
 
+    evaluated_sensor_data = recording_buffer.Recordings();
+    recorded_ticks_ = recording_buffer.Ticks();
+
     return boost::make_tuple(evaluated_times, evaluated_masses, evaluated_positions, evaluated_heights, evaluated_velocities,evaluated_thrusts, evaluated_sensor_data);
 }
 
 unsigned int PaGMOSimulationNeuralNetwork::ChromosomeSize() const {
     SampleFactory sf;
-    SensorSimulator sens_sim(sf, asteroid_);
+    SensorSimulator sens_sim(sf, *asteroid_);
     sens_sim.SetSensorTypes(control_sensor_types_);
     const unsigned int dimensions = sens_sim.Dimensions();
 
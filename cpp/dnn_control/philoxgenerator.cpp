@@ -0,0 +1,121 @@
+#include "philoxgenerator.h"
+#include "constants.h"
+
+#include <cmath>
+
+// Philox4x32 multipliers and Weyl key increments
+static const boost::uint32_t kPhiloxM0 = 0xD2511F53;
+static const boost::uint32_t kPhiloxM1 = 0xCD9E8D57;
+static const boost::uint32_t kPhiloxW0 = 0x9E3779B9;
+static const boost::uint32_t kPhiloxW1 = 0xBB67AE85;
+static const unsigned int kPhiloxRounds = 10;
+
+// 2^-53
+static const double kDoubleScale = 1.0 / 9007199254740992.0;
+
+// One Philox4x32 round on counter (c0, c1, c2, c3) with key (k0, k1)
+static inline void PhiloxRound(boost::uint32_t &c0, boost::uint32_t &c1, boost::uint32_t &c2, boost::uint32_t &c3, const boost::uint32_t &k0, const boost::uint32_t &k1) {
+    const boost::uint64_t product_0 = static_cast<boost::uint64_t>(kPhiloxM0) * c0;
+    const boost::uint64_t product_1 = static_cast<boost::uint64_t>(kPhiloxM1) * c2;
+    const boost::uint32_t next_0 = static_cast<boost::uint32_t>(product_1 >> 32) ^ c1 ^ k0;
+    const boost::uint32_t next_2 = static_cast<boost::uint32_t>(product_0 >> 32) ^ c3 ^ k1;
+    c1 = static_cast<boost::uint32_t>(product_1);
+    c3 = static_cast<boost::uint32_t>(product_0);
+    c0 = next_0;
+    c2 = next_2;
+}
+
+// Philox4x32-10 of counter (c0, c1, c2, c3) with key (k0, k1)
+static inline void Philox(boost::uint32_t &c0, boost::uint32_t &c1, boost::uint32_t &c2, boost::uint32_t &c3, boost::uint32_t k0, boost::uint32_t k1) {
+    PhiloxRound(c0, c1, c2, c3, k0, k1);
+    for (unsigned int i = 1; i < kPhiloxRounds; ++i) {
+        k0 += kPhiloxW0;
+        k1 += kPhiloxW1;
+        PhiloxRound(c0, c1, c2, c3, k0, k1);
+    }
+}
+
+// u = [0,1) with 53 random bits taken from two words
+static inline double WordsToUniform(const boost::uint32_t &high, const boost::uint32_t &low) {
+    return ((high >> 5) * 67108864.0 + (low >> 6)) * kDoubleScale;
+}
+
+PhiloxGenerator::PhiloxGenerator(const unsigned int &seed, const unsigned int &stream)
+    : seed_(seed), stream_(stream), index_(0) {
+    block_.fill(0);
+}
+
+PhiloxGenerator::Block PhiloxGenerator::GenerateBlock(const unsigned int &seed, const unsigned int &stream, const boost::uint64_t &block_index) {
+    boost::uint32_t c0 = static_cast<boost::uint32_t>(block_index);
+    boost::uint32_t c1 = static_cast<boost::uint32_t>(block_index >> 32);
+    boost::uint32_t c2 = 0;
+    boost::uint32_t c3 = 0;
+    Philox(c0, c1, c2, c3, seed, stream);
+
+    const Block block = {c0, c1, c2, c3};
+    return block;
+}
+
+void PhiloxGenerator::FillUniform(double *values, const unsigned int &num_values, const boost::uint64_t &first_block_index) const {
+    // blocks are independent, the loop has no carried dependency
+    for (unsigned int i = 0; i < num_values; i += 2) {
+        const boost::uint64_t block_index = first_block_index + i / 2;
+        boost::uint32_t c0 = static_cast<boost::uint32_t>(block_index);
+        boost::uint32_t c1 = static_cast<boost::uint32_t>(block_index >> 32);
+        boost::uint32_t c2 = 0;
+        boost::uint32_t c3 = 0;
+        Philox(c0, c1, c2, c3, seed_, stream_);
+
+        values[i] = WordsToUniform(c0, c1);
+        if (i + 1 < num_values) {
+            values[i + 1] = WordsToUniform(c2, c3);
+        }
+    }
+}
+
+void PhiloxGenerator::FillNormal(double *values, const unsigned int &num_values, const boost::uint64_t &first_block_index) const {
+    for (unsigned int i = 0; i < num_values; i += 2) {
+        const boost::uint64_t block_index = first_block_index + i / 2;
+        boost::uint32_t c0 = static_cast<boost::uint32_t>(block_index);
+        boost::uint32_t c1 = static_cast<boost::uint32_t>(block_index >> 32);
+        boost::uint32_t c2 = 0;
+        boost::uint32_t c3 = 0;
+        Philox(c0, c1, c2, c3, seed_, stream_);
+
+        // u_1 in (0,1] keeps the logarithm finite
+        const double u_1 = 1.0 - WordsToUniform(c0, c1);
+        const double u_2 = WordsToUniform(c2, c3);
+        const double radius = sqrt(-2.0 * log(u_1));
+        const double angle = 2.0 * kPi * u_2;
+
+        values[i] = radius * cos(angle);
+        if (i + 1 < num_values) {
+            values[i + 1] = radius * sin(angle);
+        }
+    }
+}
+
+void PhiloxGenerator::Seek(const boost::uint64_t &index) {
+    index_ = index;
+    if (index_ & 3) {
+        block_ = GenerateBlock(seed_, stream_, index_ >> 2);
+    }
+}
+
+boost::uint64_t PhiloxGenerator::Index() const {
+    return index_;
+}
+
+void PhiloxGenerator::SetSeed(const unsigned int &seed, const unsigned int &stream) {
+    seed_ = seed;
+    stream_ = stream;
+    index_ = 0;
+}
+
+unsigned int PhiloxGenerator::Seed() const {
+    return seed_;
+}
+
+unsigned int PhiloxGenerator::Stream() const {
+    return stream_;
+}
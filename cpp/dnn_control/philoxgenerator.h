@@ -0,0 +1,78 @@
+#ifndef PHILOXGENERATOR_H
+#define PHILOXGENERATOR_H
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+
+class PhiloxGenerator {
+    /*
+    * This class represents the counter based random number generator Philox4x32-10 (Salmon et al., "Parallel Random Numbers:
+    * As Easy as 1, 2, 3"). Every 32 bit word is a pure function of (seed, stream, index), hence any part of a stream can be
+    * generated out of order, in bulk or by different threads without replaying the words before it.
+    *
+    * The generator fulfills the UniformRandomNumberGenerator concept and can be used with the boost distributions.
+    */
+public:
+    typedef boost::uint32_t result_type;
+    typedef boost::array<boost::uint32_t, 4> Block;
+
+    PhiloxGenerator(const unsigned int &seed=0, const unsigned int &stream=0);
+
+    // Returns the next 32 bit word of the stream
+    result_type operator () ();
+
+    static result_type min() {
+        return 0;
+    }
+    static result_type max() {
+        return 0xFFFFFFFF;
+    }
+
+    // Returns the 4 words at position 4 * block_index of stream "stream" for seed "seed"
+    static Block GenerateBlock(const unsigned int &seed, const unsigned int &stream, const boost::uint64_t &block_index);
+
+    // values[i] ~ U[0,1), generated from block first_block_index + i / 2 of the stream
+    void FillUniform(double *values, const unsigned int &num_values, const boost::uint64_t &first_block_index) const;
+
+    // values[i] ~ N(0,1), Box-Muller transformed from block first_block_index + i / 2 of the stream
+    void FillNormal(double *values, const unsigned int &num_values, const boost::uint64_t &first_block_index) const;
+
+    // Moves to the 32 bit word at position "index" of the stream
+    void Seek(const boost::uint64_t &index);
+
+    // Returns the position of the next 32 bit word
+    boost::uint64_t Index() const;
+
+    // Restarts the stream "stream" of seed "seed" at position 0
+    void SetSeed(const unsigned int &seed, const unsigned int &stream=0);
+
+    // Get the seed of the generator
+    unsigned int Seed() const;
+
+    // Get the stream of the generator
+    unsigned int Stream() const;
+
+private:
+    // The seed, first key word
+    unsigned int seed_;
+
+    // The stream, second key word
+    unsigned int stream_;
+
+    // The position of the next word
+    boost::uint64_t index_;
+
+    // The block containing word index_ - 1
+    Block block_;
+};
+
+inline PhiloxGenerator::result_type PhiloxGenerator::operator () () {
+    const unsigned int word = index_ & 3;
+    if (word == 0) {
+        block_ = GenerateBlock(seed_, stream_, index_ >> 2);
+    }
+    ++index_;
+    return block_[word];
+}
+
+#endif // PHILOXGENERATOR_H
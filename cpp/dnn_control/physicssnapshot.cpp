@@ -0,0 +1,101 @@
+#include "physicssnapshot.h"
+
+PhysicsSnapshot::PhysicsSnapshot(const Asteroid &asteroid)
+    : asteroid_(asteroid), gravity_model_(&asteroid), shape_model_(&asteroid), surface_hint_(0) {
+    state_.fill(0.0);
+    time_ = 0.0;
+    height_norm_ = 0.0;
+    height_computed_ = false;
+    height_norm_computed_ = false;
+    gravity_computed_ = false;
+    angular_computed_ = false;
+}
+
+void PhysicsSnapshot::SetGravityModel(const GravityModel *gravity_model) {
+    gravity_model_ = (gravity_model != NULL ? gravity_model : &asteroid_);
+    gravity_computed_ = false;
+}
+
+void PhysicsSnapshot::SetShapeModel(const ShapeModel *shape_model) {
+    shape_model_ = (shape_model != NULL ? shape_model : &asteroid_);
+    surface_hint_ = 0;
+    height_computed_ = false;
+    height_norm_computed_ = false;
+}
+
+void PhysicsSnapshot::Update(const SystemState &state, const double &time) {
+    state_ = state;
+    time_ = time;
+    height_computed_ = false;
+    height_norm_computed_ = false;
+    gravity_computed_ = false;
+    angular_computed_ = false;
+}
+
+void PhysicsSnapshot::Update(const SystemState &state, const double &time, const Vector3D &height) {
+    Update(state, time);
+
+    const Vector3D &position = {state_[0], state_[1], state_[2]};
+    height_ = height;
+    surface_point_ = VectorSub(position, height_);
+    height_computed_ = true;
+}
+
+bool PhysicsSnapshot::Matches(const Vector3D &position, const double &time) const {
+    return time == time_ && position[0] == state_[0] && position[1] == state_[1] && position[2] == state_[2];
+}
+
+const SystemState& PhysicsSnapshot::State() const {
+    return state_;
+}
+
+double PhysicsSnapshot::Time() const {
+    return time_;
+}
+
+const Vector3D& PhysicsSnapshot::SurfacePoint() const {
+    if (!height_computed_) {
+        const Vector3D &position = {state_[0], state_[1], state_[2]};
+        surface_point_ = boost::get<0>(shape_model_->NearestPointOnSurfaceToPositionWithHint(position, surface_hint_));
+        height_ = VectorSub(position, surface_point_);
+        height_computed_ = true;
+    }
+    return surface_point_;
+}
+
+const Vector3D& PhysicsSnapshot::Height() const {
+    SurfacePoint();
+    return height_;
+}
+
+double PhysicsSnapshot::HeightNorm() const {
+    if (!height_norm_computed_) {
+        height_norm_ = VectorNorm(Height());
+        height_norm_computed_ = true;
+    }
+    return height_norm_;
+}
+
+const Vector3D& PhysicsSnapshot::GravityAcceleration() const {
+    if (!gravity_computed_) {
+        const Vector3D &position = {state_[0], state_[1], state_[2]};
+        gravity_acceleration_ = gravity_model_->GravityAccelerationAtPosition(position);
+        gravity_computed_ = true;
+    }
+    return gravity_acceleration_;
+}
+
+const Vector3D& PhysicsSnapshot::AngularVelocity() const {
+    if (!angular_computed_) {
+        const boost::tuple<Vector3D, Vector3D> result = asteroid_.AngularVelocityAndAccelerationAtTime(time_);
+        angular_velocity_ = boost::get<0>(result);
+        angular_acceleration_ = boost::get<1>(result);
+        angular_computed_ = true;
+    }
+    return angular_velocity_;
+}
+
+const Vector3D& PhysicsSnapshot::AngularAcceleration() const {
+    AngularVelocity();
+    return angular_acceleration_;
+}
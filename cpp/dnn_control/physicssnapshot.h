@@ -0,0 +1,87 @@
+#ifndef PHYSICSSNAPSHOT_H
+#define PHYSICSSNAPSHOT_H
+
+#include "vector.h"
+#include "systemstate.h"
+#include "asteroid.h"
+
+class PhysicsSnapshot {
+    /*
+    * This class holds the physics of one control tick: the spacecraft state at a time, the nearest point on the asteroid's
+    * surface, the height above it, the gravity acceleration and the asteroid's angular velocity and acceleration.
+    *
+    * Every quantity is computed on first request and then reused until the next Update, so the control sensor simulator,
+    * the recording sensor simulator and the first right hand side evaluation of the ODESystem share one evaluation.
+    * A quantity that nobody requests during a tick is never computed.
+    */
+public:
+    // The asteroid has to outlive the snapshot
+    PhysicsSnapshot(const Asteroid &asteroid);
+
+    // Replace the asteroid's gravity or shape, pass NULL for the asteroid's own. The models have to outlive the snapshot.
+    void SetGravityModel(const GravityModel *gravity_model);
+    void SetShapeModel(const ShapeModel *shape_model);
+
+    // Starts a new tick for spacecraft state "state" at time "time"
+    void Update(const SystemState &state, const double &time);
+
+    // Starts a new tick for spacecraft state "state" at time "time" whose height above the surface "height" is already known
+    void Update(const SystemState &state, const double &time, const Vector3D &height);
+
+    // Returns true if the snapshot describes position "position" at time "time"
+    bool Matches(const Vector3D &position, const double &time) const;
+
+    // The snapshot's spacecraft state
+    const SystemState& State() const;
+
+    // The snapshot's time
+    double Time() const;
+
+    // The nearest point on the asteroid's surface to the spacecraft's position
+    const Vector3D& SurfacePoint() const;
+
+    // Position - SurfacePoint
+    const Vector3D& Height() const;
+
+    // |Height|
+    double HeightNorm() const;
+
+    // Fg at the spacecraft's position
+    const Vector3D& GravityAcceleration() const;
+
+    // w at the snapshot's time
+    const Vector3D& AngularVelocity() const;
+
+    // d/dt w at the snapshot's time
+    const Vector3D& AngularAcceleration() const;
+
+private:
+    // The asteroid the physics are computed for
+    const Asteroid &asteroid_;
+
+    // The gravity and shape used, the asteroid's by default
+    const GravityModel *gravity_model_;
+    const ShapeModel *shape_model_;
+
+    // The shape model's surface element nearest to the previous tick's position
+    mutable unsigned int surface_hint_;
+
+    // The spacecraft state and time of the tick
+    SystemState state_;
+    double time_;
+
+    // The computed quantities, valid if the corresponding flag is set
+    mutable Vector3D surface_point_;
+    mutable Vector3D height_;
+    mutable double height_norm_;
+    mutable Vector3D gravity_acceleration_;
+    mutable Vector3D angular_velocity_;
+    mutable Vector3D angular_acceleration_;
+
+    mutable bool height_computed_;
+    mutable bool height_norm_computed_;
+    mutable bool gravity_computed_;
+    mutable bool angular_computed_;
+};
+
+#endif // PHYSICSSNAPSHOT_H
@@ -0,0 +1,346 @@
+#include "polyhedrongravity.h"
+#include "asteroid.h"
+#include "constants.h"
+
+#include <cmath>
+#include <algorithm>
+
+const unsigned int PolyhedronGravity::kMaxLeafFacets;
+const unsigned int PolyhedronGravity::kMaxDepth;
+
+PolyhedronGravity::PolyhedronGravity(const TriangleMesh &mesh, const double &density, const double &opening_angle)
+    : density_(density), opening_angle_(opening_angle) {
+    if (density <= 0.0 || opening_angle < 0.0) {
+        throw InvalidParameterException();
+    }
+
+    mass_ = density_ * mesh.Volume();
+    gravitational_constant_density_ = kGravitationalConstant * density_;
+
+    const std::vector<Vector3D> &vertices = mesh.Vertices();
+    const std::vector<TriangleFace> &faces = mesh.Faces();
+    const unsigned int num_facets = faces.size();
+
+    std::vector<Vector3D> centroids(num_facets);
+    std::vector<unsigned int> order(num_facets);
+    for (unsigned int f = 0; f < num_facets; ++f) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            centroids[f][j] = (vertices[faces[f][0]][j] + vertices[faces[f][1]][j] + vertices[faces[f][2]][j]) / 3.0;
+        }
+        order[f] = f;
+    }
+
+    OctreeNode root;
+    root.begin = 0;
+    root.end = num_facets;
+    nodes_.push_back(root);
+    BuildOctree(0, order, centroids, 0);
+
+    // the facet data in octree order
+    for (unsigned int i = 0; i < 3; ++i) {
+        vertex_x_[i].resize(num_facets);
+        vertex_y_[i].resize(num_facets);
+        vertex_z_[i].resize(num_facets);
+        edge_length_[i].resize(num_facets);
+        edge_normal_x_[i].resize(num_facets);
+        edge_normal_y_[i].resize(num_facets);
+        edge_normal_z_[i].resize(num_facets);
+    }
+    normal_x_.resize(num_facets);
+    normal_y_.resize(num_facets);
+    normal_z_.resize(num_facets);
+    area_.resize(num_facets);
+    std::vector<Vector3D> normals(num_facets);
+    for (unsigned int k = 0; k < num_facets; ++k) {
+        const TriangleFace &face = faces[order[k]];
+        const Vector3D cross = VectorCrossProduct(VectorSub(vertices[face[1]], vertices[face[0]]), VectorSub(vertices[face[2]], vertices[face[0]]));
+        const double norm = VectorNorm(cross);
+        if (norm == 0.0) {
+            throw TriangleMesh::InvalidMeshException();
+        }
+        const Vector3D normal = VectorMul(1.0 / norm, cross);
+        normals[k] = normal;
+        normal_x_[k] = normal[0];
+        normal_y_[k] = normal[1];
+        normal_z_[k] = normal[2];
+        area_[k] = 0.5 * norm;
+
+        for (unsigned int i = 0; i < 3; ++i) {
+            const Vector3D &vertex = vertices[face[i]];
+            vertex_x_[i][k] = vertex[0];
+            vertex_y_[i][k] = vertex[1];
+            vertex_z_[i][k] = vertex[2];
+
+            const Vector3D edge = VectorSub(vertices[face[(i + 1) % 3]], vertex);
+            const double length = VectorNorm(edge);
+            const Vector3D edge_normal = VectorMul(1.0 / length, VectorCrossProduct(edge, normal));
+            edge_length_[i][k] = length;
+            edge_normal_x_[i][k] = edge_normal[0];
+            edge_normal_y_[i][k] = edge_normal[1];
+            edge_normal_z_[i][k] = edge_normal[2];
+        }
+    }
+
+    // surface multipoles of the nodes, the facet integrals use the Strang & Fix four point rule which is exact for cubics
+    const double quadrature_weights[4] = {-27.0 / 48.0, 25.0 / 48.0, 25.0 / 48.0, 25.0 / 48.0};
+    const double quadrature_points[4][3] = {{1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0}, {0.6, 0.2, 0.2}, {0.2, 0.6, 0.2}, {0.2, 0.2, 0.6}};
+    const double quadratic_multiplicities[6] = {1.0, 1.0, 1.0, 2.0, 2.0, 2.0};
+    const double cubic_multiplicities[10] = {1.0, 1.0, 1.0, 3.0, 3.0, 3.0, 3.0, 3.0, 3.0, 6.0};
+    for (unsigned int n = 0; n < nodes_.size(); ++n) {
+        OctreeNode &node = nodes_[n];
+        double area = 0.0;
+        node.center.fill(0.0);
+        for (unsigned int k = node.begin; k < node.end; ++k) {
+            area += area_[k];
+            for (unsigned int j = 0; j < 3; ++j) {
+                node.center[j] += area_[k] * centroids[order[k]][j];
+            }
+        }
+        node.center = VectorMul(1.0 / area, node.center);
+
+        node.radius = 0.0;
+        node.moment.fill(0.0);
+        node.dipole.fill(0.0);
+        node.quadrupole.fill(0.0);
+        node.quadrupole_trace.fill(0.0);
+        node.octupole.fill(0.0);
+        node.octupole_trace.fill(0.0);
+        for (unsigned int k = node.begin; k < node.end; ++k) {
+            Vector3D facet_vertices[3];
+            for (unsigned int i = 0; i < 3; ++i) {
+                const Vector3D vertex = {vertex_x_[i][k], vertex_y_[i][k], vertex_z_[i][k]};
+                facet_vertices[i] = VectorSub(vertex, node.center);
+                node.radius = std::max(node.radius, VectorNorm(facet_vertices[i]));
+            }
+
+            for (unsigned int q = 0; q < 4; ++q) {
+                Vector3D offset;
+                for (unsigned int j = 0; j < 3; ++j) {
+                    offset[j] = quadrature_points[q][0] * facet_vertices[0][j] + quadrature_points[q][1] * facet_vertices[1][j] + quadrature_points[q][2] * facet_vertices[2][j];
+                }
+                const double offset_norm_pow2 = VectorDotProduct(offset, offset);
+                double quadratic[6], cubic[10];
+                Monomials(offset, quadratic, cubic);
+
+                for (unsigned int i = 0; i < 3; ++i) {
+                    const double weight = quadrature_weights[q] * area_[k] * normals[k][i];
+                    node.moment[i] += weight;
+                    node.quadrupole_trace[i] += weight * offset_norm_pow2;
+                    for (unsigned int j = 0; j < 3; ++j) {
+                        node.dipole[3 * i + j] += weight * offset[j];
+                        node.octupole_trace[3 * i + j] += weight * offset[j] * offset_norm_pow2;
+                    }
+                    for (unsigned int m = 0; m < 6; ++m) {
+                        node.quadrupole[6 * i + m] += weight * quadratic_multiplicities[m] * quadratic[m];
+                    }
+                    for (unsigned int m = 0; m < 10; ++m) {
+                        node.octupole[10 * i + m] += weight * cubic_multiplicities[m] * cubic[m];
+                    }
+                }
+            }
+        }
+    }
+}
+
+PolyhedronGravity::~PolyhedronGravity() {
+
+}
+
+void PolyhedronGravity::BuildOctree(const unsigned int &node, std::vector<unsigned int> &order, const std::vector<Vector3D> &centroids, const unsigned int &depth) {
+    const unsigned int begin = nodes_[node].begin;
+    const unsigned int end = nodes_[node].end;
+    nodes_[node].first_child = 0;
+    nodes_[node].num_children = 0;
+    if (end - begin <= kMaxLeafFacets || depth >= kMaxDepth) {
+        return;
+    }
+
+    Vector3D lower = centroids[order[begin]];
+    Vector3D upper = lower;
+    for (unsigned int k = begin + 1; k < end; ++k) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            lower[j] = std::min(lower[j], centroids[order[k]][j]);
+            upper[j] = std::max(upper[j], centroids[order[k]][j]);
+        }
+    }
+    const Vector3D middle = VectorMul(0.5, VectorAdd(lower, upper));
+
+    // stable partition into the eight octants
+    std::vector<unsigned int> octants[8];
+    for (unsigned int k = begin; k < end; ++k) {
+        const Vector3D &centroid = centroids[order[k]];
+        const unsigned int octant = (centroid[0] > middle[0] ? 1 : 0) + (centroid[1] > middle[1] ? 2 : 0) + (centroid[2] > middle[2] ? 4 : 0);
+        octants[octant].push_back(order[k]);
+    }
+
+    unsigned int num_children = 0;
+    for (unsigned int o = 0; o < 8; ++o) {
+        num_children += (octants[o].size() ? 1 : 0);
+    }
+    if (num_children < 2) {
+        // coincident centroids can not be separated
+        return;
+    }
+
+    const unsigned int first_child = nodes_.size();
+    nodes_[node].first_child = first_child;
+    nodes_[node].num_children = num_children;
+    unsigned int position = begin;
+    for (unsigned int o = 0; o < 8; ++o) {
+        if (octants[o].empty()) {
+            continue;
+        }
+        OctreeNode child;
+        child.begin = position;
+        child.end = position + octants[o].size();
+        nodes_.push_back(child);
+        std::copy(octants[o].begin(), octants[o].end(), order.begin() + position);
+        position = child.end;
+    }
+
+    for (unsigned int c = 0; c < num_children; ++c) {
+        BuildOctree(first_child + c, order, centroids, depth + 1);
+    }
+}
+
+void PolyhedronGravity::Monomials(const Vector3D &offset, double *quadratic, double *cubic) {
+    const double &x = offset[0];
+    const double &y = offset[1];
+    const double &z = offset[2];
+    quadratic[0] = x * x;
+    quadratic[1] = y * y;
+    quadratic[2] = z * z;
+    quadratic[3] = x * y;
+    quadratic[4] = x * z;
+    quadratic[5] = y * z;
+    cubic[0] = quadratic[0] * x;
+    cubic[1] = quadratic[1] * y;
+    cubic[2] = quadratic[2] * z;
+    cubic[3] = quadratic[0] * y;
+    cubic[4] = quadratic[0] * z;
+    cubic[5] = quadratic[1] * x;
+    cubic[6] = quadratic[1] * z;
+    cubic[7] = quadratic[2] * x;
+    cubic[8] = quadratic[2] * y;
+    cubic[9] = quadratic[3] * z;
+}
+
+void PolyhedronGravity::AddFacets(const unsigned int &begin, const unsigned int &end, const Vector3D &position, Vector3D &integral, double &solid_angle) const {
+    for (unsigned int k = begin; k < end; ++k) {
+        // vertices relative to the field point
+        double r_x[3], r_y[3], r_z[3], r_norm[3];
+        for (unsigned int i = 0; i < 3; ++i) {
+            r_x[i] = vertex_x_[i][k] - position[0];
+            r_y[i] = vertex_y_[i][k] - position[1];
+            r_z[i] = vertex_z_[i][k] - position[2];
+            r_norm[i] = sqrt(r_x[i] * r_x[i] + r_y[i] * r_y[i] + r_z[i] * r_z[i]);
+        }
+
+        // Werner & Scheeres eq (7): edge line integrals
+        double edge_sum = 0.0;
+        for (unsigned int i = 0; i < 3; ++i) {
+            const unsigned int j = (i + 1) % 3;
+            const double sum_norms = r_norm[i] + r_norm[j];
+            const double line_integral = log((sum_norms + edge_length_[i][k]) / (sum_norms - edge_length_[i][k]));
+            edge_sum += (edge_normal_x_[i][k] * r_x[i] + edge_normal_y_[i][k] * r_y[i] + edge_normal_z_[i][k] * r_z[i]) * line_integral;
+        }
+
+        // Werner & Scheeres eq (27): signed solid angle of the facet
+        const double triple_product = r_x[0] * (r_y[1] * r_z[2] - r_z[1] * r_y[2])
+                + r_y[0] * (r_z[1] * r_x[2] - r_x[1] * r_z[2])
+                + r_z[0] * (r_x[1] * r_y[2] - r_y[1] * r_x[2]);
+        const double denominator = r_norm[0] * r_norm[1] * r_norm[2]
+                + r_norm[0] * (r_x[1] * r_x[2] + r_y[1] * r_y[2] + r_z[1] * r_z[2])
+                + r_norm[1] * (r_x[2] * r_x[0] + r_y[2] * r_y[0] + r_z[2] * r_z[0])
+                + r_norm[2] * (r_x[0] * r_x[1] + r_y[0] * r_y[1] + r_z[0] * r_z[1]);
+        const double omega = 2.0 * atan2(triple_product, denominator);
+
+        const double height = normal_x_[k] * r_x[0] + normal_y_[k] * r_y[0] + normal_z_[k] * r_z[0];
+        const double facet_integral = edge_sum - height * omega;
+        integral[0] += normal_x_[k] * facet_integral;
+        integral[1] += normal_y_[k] * facet_integral;
+        integral[2] += normal_z_[k] * facet_integral;
+        solid_angle += omega;
+    }
+}
+
+Vector3D PolyhedronGravity::GravityAccelerationAtPosition(const Vector3D &position) const {
+    Vector3D integral = {0.0, 0.0, 0.0};
+    double solid_angle = 0.0;
+
+    // depth first traversal, every level adds at most seven nodes to the stack
+    unsigned int stack[8 * (kMaxDepth + 1)];
+    unsigned int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size) {
+        const OctreeNode &node = nodes_[stack[--stack_size]];
+        const Vector3D offset = VectorSub(node.center, position);
+        const double distance = VectorNorm(offset);
+
+        if (node.num_children && node.radius < opening_angle_ * distance) {
+            // 1/|x + y| = 1/d - x.y/d^3 + (3 (x.y)^2 - d^2 |y|^2)/(2 d^5) - (5 (x.y)^3 - 3 d^2 (x.y) |y|^2)/(2 d^7) + ...
+            const double inv_distance = 1.0 / distance;
+            const double inv_distance_pow2 = inv_distance * inv_distance;
+            const double inv_distance_pow3 = inv_distance_pow2 * inv_distance;
+            const double inv_distance_pow5 = inv_distance_pow3 * inv_distance_pow2;
+            const double inv_distance_pow7 = inv_distance_pow5 * inv_distance_pow2;
+            const double distance_pow2 = distance * distance;
+            double quadratic[6], cubic[10];
+            Monomials(offset, quadratic, cubic);
+
+            Vector3D dipole_offset;
+            for (unsigned int i = 0; i < 3; ++i) {
+                const double *dipole = &node.dipole[3 * i];
+                const double *quadrupole = &node.quadrupole[6 * i];
+                const double *octupole = &node.octupole[10 * i];
+                const double *octupole_trace = &node.octupole_trace[3 * i];
+
+                dipole_offset[i] = dipole[0] * offset[0] + dipole[1] * offset[1] + dipole[2] * offset[2];
+                double quadrupole_offset = 0.0;
+                for (unsigned int m = 0; m < 6; ++m) {
+                    quadrupole_offset += quadrupole[m] * quadratic[m];
+                }
+                double octupole_offset = 0.0;
+                for (unsigned int m = 0; m < 10; ++m) {
+                    octupole_offset += octupole[m] * cubic[m];
+                }
+                const double octupole_trace_offset = octupole_trace[0] * offset[0] + octupole_trace[1] * offset[1] + octupole_trace[2] * offset[2];
+
+                integral[i] += node.moment[i] * inv_distance
+                        - dipole_offset[i] * inv_distance_pow3
+                        + 0.5 * (3.0 * quadrupole_offset - distance_pow2 * node.quadrupole_trace[i]) * inv_distance_pow5
+                        - 0.5 * (5.0 * octupole_offset - 3.0 * distance_pow2 * octupole_trace_offset) * inv_distance_pow7;
+            }
+
+            // the solid angle is only needed to tell inside from outside, the first order suffices
+            const double trace = node.dipole[0] + node.dipole[4] + node.dipole[8];
+            solid_angle += (VectorDotProduct(node.moment, offset) + trace) * inv_distance_pow3
+                    - 3.0 * VectorDotProduct(offset, dipole_offset) * inv_distance_pow5;
+        } else if (node.num_children) {
+            for (unsigned int c = 0; c < node.num_children; ++c) {
+                stack[stack_size++] = node.first_child + c;
+            }
+        } else {
+            AddFacets(node.begin, node.end, position, integral, solid_angle);
+        }
+    }
+
+    // the solid angle of a closed surface is 4 pi inside and 0 outside
+    if (solid_angle > 2.0 * kPi) {
+        throw Asteroid::PositionInsideException();
+    }
+
+    return VectorMul(-gravitational_constant_density_, integral);
+}
+
+double PolyhedronGravity::Mass() const {
+    return mass_;
+}
+
+double PolyhedronGravity::Density() const {
+    return density_;
+}
+
+double PolyhedronGravity::OpeningAngle() const {
+    return opening_angle_;
+}
@@ -0,0 +1,109 @@
+#ifndef POLYHEDRONGRAVITY_H
+#define POLYHEDRONGRAVITY_H
+
+#include "gravitymodel.h"
+#include "trianglemesh.h"
+
+#include <vector>
+
+class PolyhedronGravity : public GravityModel {
+    /*
+    * This class represents the gravity field of a homogeneous polyhedron (Werner & Scheeres 1997) given by a closed
+    * triangle mesh in the asteroid's body fixed RF.
+    *
+    * By Gauss' theorem the acceleration is a sum of surface integrals over the facets, -G rho sum_f n_f int_f 1/R dS,
+    * which are evaluated exactly with the line integrals of the facet's edges and the facet's solid angle. The facets
+    * are sorted into an octree over their centroids: a node whose facets are seen under an angle smaller than
+    * "opening_angle" is evaluated by the third order Taylor expansion of 1/R around the node's center, using surface
+    * multipoles of the node's facets, instead of facet by facet. An opening angle of 0 evaluates every facet exactly.
+    *
+    * The facet data is stored as structure of arrays in octree order, the object is read only after construction and can
+    * be shared by threads.
+    */
+public:
+    PolyhedronGravity(const TriangleMesh &mesh, const double &density, const double &opening_angle=0.3);
+
+    virtual ~PolyhedronGravity();
+
+    // Computes the gravity acceleration at an outside point "position", throws Asteroid::PositionInsideException otherwise
+    virtual Vector3D GravityAccelerationAtPosition(const Vector3D &position) const;
+
+    double Mass() const;
+
+    double Density() const;
+
+    double OpeningAngle() const;
+
+    // PolyhedronGravity can throw the following exceptions
+    class Exception {};
+    class InvalidParameterException : public Exception {};
+
+private:
+    // A node of the octree covers the facets [begin, end) of the SoA arrays
+    struct OctreeNode {
+        unsigned int begin;
+        unsigned int end;
+
+        // Index of the first child, the children are consecutive, 0 for leaves
+        unsigned int first_child;
+        unsigned int num_children;
+
+        // Area centroid and radius of the ball around it which contains all of the node's vertices
+        Vector3D center;
+        double radius;
+
+        // Surface multipoles of the node's facets around its center, with y = p - center: int n dS, int n y^T dS (row major)
+        Vector3D moment;
+        boost::array<double, 9> dipole;
+
+        // int n_i y_j y_k dS and int n_i y_j y_k y_l dS folded into the coefficients of the monomials of degree 2 and 3
+        // in the offset to the field point (see Monomials), and their traces
+        // int n_i |y|^2 dS and int n_i y_j |y|^2 dS
+        boost::array<double, 18> quadrupole;
+        Vector3D quadrupole_trace;
+        boost::array<double, 30> octupole;
+        boost::array<double, 9> octupole_trace;
+    };
+
+    // Sorts the facets [begin, end) of "order" into the subtree rooted at node "node"
+    void BuildOctree(const unsigned int &node, std::vector<unsigned int> &order, const std::vector<Vector3D> &centroids, const unsigned int &depth);
+
+    // Adds the exact contributions of facets [begin, end) to the surface integral "integral" and to the solid angle "solid_angle"
+    void AddFacets(const unsigned int &begin, const unsigned int &end, const Vector3D &position, Vector3D &integral, double &solid_angle) const;
+
+    // Evaluates the monomials of degree 2 and 3 of "offset" in the order of the folded multipoles
+    static void Monomials(const Vector3D &offset, double *quadratic, double *cubic);
+
+    // Maximal number of facets in a leaf and maximal depth of the octree
+    const static unsigned int kMaxLeafFacets = 8;
+    const static unsigned int kMaxDepth = 16;
+
+    double density_;
+
+    double opening_angle_;
+
+    double mass_;
+
+    // G * density
+    double gravitational_constant_density_;
+
+    // Facet vertices, unit normals and areas in octree order
+    std::vector<double> vertex_x_[3];
+    std::vector<double> vertex_y_[3];
+    std::vector<double> vertex_z_[3];
+    std::vector<double> normal_x_;
+    std::vector<double> normal_y_;
+    std::vector<double> normal_z_;
+    std::vector<double> area_;
+
+    // Per facet edge i from vertex i to vertex (i + 1) % 3: its length and its outward unit normal within the facet's plane
+    std::vector<double> edge_length_[3];
+    std::vector<double> edge_normal_x_[3];
+    std::vector<double> edge_normal_y_[3];
+    std::vector<double> edge_normal_z_[3];
+
+    // The octree, the root is node 0
+    std::vector<OctreeNode> nodes_;
+};
+
+#endif // POLYHEDRONGRAVITY_H
@@ -0,0 +1,347 @@
+#include "polyhedronshape.h"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+const unsigned int PolyhedronShape::kMaxLeafTriangles;
+const unsigned int PolyhedronShape::kMaxDepth;
+
+// Orders triangles by their centroid's coordinate along one axis
+struct CentroidLess {
+    CentroidLess(const std::vector<Vector3D> &centroids, const unsigned int &axis)
+        : centroids_(centroids), axis_(axis) {}
+
+    bool operator()(const unsigned int &first, const unsigned int &second) const {
+        return centroids_[first][axis_] < centroids_[second][axis_];
+    }
+
+    const std::vector<Vector3D> &centroids_;
+    unsigned int axis_;
+};
+
+PolyhedronShape::PolyhedronShape(const TriangleMesh &mesh)
+    : mesh_(mesh) {
+    const std::vector<Vector3D> &vertices = mesh_.Vertices();
+    const std::vector<TriangleFace> &faces = mesh_.Faces();
+    const unsigned int num_triangles = faces.size();
+
+    std::vector<Vector3D> centroids(num_triangles);
+    std::vector<unsigned int> order(num_triangles);
+    for (unsigned int f = 0; f < num_triangles; ++f) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            centroids[f][j] = (vertices[faces[f][0]][j] + vertices[faces[f][1]][j] + vertices[faces[f][2]][j]) / 3.0;
+        }
+        order[f] = f;
+    }
+
+    nodes_.reserve(2 * num_triangles / kMaxLeafTriangles + 1);
+    BuildHierarchy(0, num_triangles, order, centroids);
+
+    vertex_x_.resize(num_triangles);
+    vertex_y_.resize(num_triangles);
+    vertex_z_.resize(num_triangles);
+    edge_ab_x_.resize(num_triangles);
+    edge_ab_y_.resize(num_triangles);
+    edge_ab_z_.resize(num_triangles);
+    edge_ac_x_.resize(num_triangles);
+    edge_ac_y_.resize(num_triangles);
+    edge_ac_z_.resize(num_triangles);
+    normal_x_.resize(num_triangles);
+    normal_y_.resize(num_triangles);
+    normal_z_.resize(num_triangles);
+    ab_ab_.resize(num_triangles);
+    ab_ac_.resize(num_triangles);
+    ac_ac_.resize(num_triangles);
+    bc_bc_.resize(num_triangles);
+    inv_determinant_.resize(num_triangles);
+    for (unsigned int k = 0; k < num_triangles; ++k) {
+        const TriangleFace &face = faces[order[k]];
+        const Vector3D &a = vertices[face[0]];
+        const Vector3D edge_ab = VectorSub(vertices[face[1]], a);
+        const Vector3D edge_ac = VectorSub(vertices[face[2]], a);
+        vertex_x_[k] = a[0];
+        vertex_y_[k] = a[1];
+        vertex_z_[k] = a[2];
+        edge_ab_x_[k] = edge_ab[0];
+        edge_ab_y_[k] = edge_ab[1];
+        edge_ab_z_[k] = edge_ab[2];
+        edge_ac_x_[k] = edge_ac[0];
+        edge_ac_y_[k] = edge_ac[1];
+        edge_ac_z_[k] = edge_ac[2];
+
+        const Vector3D normal = VectorNormalized(VectorCrossProduct(edge_ab, edge_ac));
+        normal_x_[k] = normal[0];
+        normal_y_[k] = normal[1];
+        normal_z_[k] = normal[2];
+        ab_ab_[k] = VectorDotProduct(edge_ab, edge_ab);
+        ab_ac_[k] = VectorDotProduct(edge_ab, edge_ac);
+        ac_ac_[k] = VectorDotProduct(edge_ac, edge_ac);
+        bc_bc_[k] = ab_ab_[k] - 2.0 * ab_ac_[k] + ac_ac_[k];
+        const double determinant = ab_ab_[k] * ac_ac_[k] - ab_ac_[k] * ab_ac_[k];
+        if (determinant <= 0.0) {
+            throw TriangleMesh::InvalidMeshException();
+        }
+        inv_determinant_[k] = 1.0 / determinant;
+    }
+}
+
+PolyhedronShape::~PolyhedronShape() {
+
+}
+
+void PolyhedronShape::BuildHierarchy(const unsigned int &begin, const unsigned int &end, std::vector<unsigned int> &order, const std::vector<Vector3D> &centroids) {
+    const std::vector<Vector3D> &vertices = mesh_.Vertices();
+    const std::vector<TriangleFace> &faces = mesh_.Faces();
+
+    const unsigned int node = nodes_.size();
+    nodes_.push_back(BVHNode());
+
+    // bounds of the triangles and of their centroids
+    Vector3D lower = vertices[faces[order[begin]][0]];
+    Vector3D upper = lower;
+    Vector3D centroid_lower = centroids[order[begin]];
+    Vector3D centroid_upper = centroid_lower;
+    for (unsigned int k = begin; k < end; ++k) {
+        const TriangleFace &face = faces[order[k]];
+        for (unsigned int j = 0; j < 3; ++j) {
+            for (unsigned int i = 0; i < 3; ++i) {
+                lower[j] = std::min(lower[j], vertices[face[i]][j]);
+                upper[j] = std::max(upper[j], vertices[face[i]][j]);
+            }
+            centroid_lower[j] = std::min(centroid_lower[j], centroids[order[k]][j]);
+            centroid_upper[j] = std::max(centroid_upper[j], centroids[order[k]][j]);
+        }
+    }
+    nodes_[node].lower = lower;
+    nodes_[node].upper = upper;
+    nodes_[node].begin = begin;
+    nodes_[node].end = end;
+    nodes_[node].right_child = 0;
+    if (end - begin <= kMaxLeafTriangles) {
+        return;
+    }
+
+    unsigned int axis = 0;
+    for (unsigned int j = 1; j < 3; ++j) {
+        if (centroid_upper[j] - centroid_lower[j] > centroid_upper[axis] - centroid_lower[axis]) {
+            axis = j;
+        }
+    }
+    const unsigned int middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, CentroidLess(centroids, axis));
+
+    BuildHierarchy(begin, middle, order, centroids);
+    nodes_[node].right_child = nodes_.size();
+    BuildHierarchy(middle, end, order, centroids);
+}
+
+double PolyhedronShape::DistancePow2ToBox(const BVHNode &node, const Vector3D &position) const {
+    double distance_pow2 = 0.0;
+    for (unsigned int j = 0; j < 3; ++j) {
+        const double below = node.lower[j] - position[j];
+        const double above = position[j] - node.upper[j];
+        const double outside = std::max(0.0, std::max(below, above));
+        distance_pow2 += outside * outside;
+    }
+    return distance_pow2;
+}
+
+Vector3D PolyhedronShape::NearestPointOnTriangle(const unsigned int &triangle, const Vector3D &position) const {
+    const Vector3D a = {vertex_x_[triangle], vertex_y_[triangle], vertex_z_[triangle]};
+    const Vector3D ab = {edge_ab_x_[triangle], edge_ab_y_[triangle], edge_ab_z_[triangle]};
+    const Vector3D ac = {edge_ac_x_[triangle], edge_ac_y_[triangle], edge_ac_z_[triangle]};
+
+    const Vector3D ap = VectorSub(position, a);
+    const double d1 = VectorDotProduct(ab, ap);
+    const double d2 = VectorDotProduct(ac, ap);
+    if (d1 <= 0.0 && d2 <= 0.0) {
+        return a;
+    }
+
+    // bp = ap - ab and cp = ap - ac
+    const double ab_ab = VectorDotProduct(ab, ab);
+    const double ab_ac = VectorDotProduct(ab, ac);
+    const double ac_ac = VectorDotProduct(ac, ac);
+    const double d3 = d1 - ab_ab;
+    const double d4 = d2 - ab_ac;
+    if (d3 >= 0.0 && d4 <= d3) {
+        return VectorAdd(a, ab);
+    }
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+        return VectorAdd(a, VectorMul(d1 / (d1 - d3), ab));
+    }
+
+    const double d5 = d1 - ab_ac;
+    const double d6 = d2 - ac_ac;
+    if (d6 >= 0.0 && d5 <= d6) {
+        return VectorAdd(a, ac);
+    }
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+        return VectorAdd(a, VectorMul(d2 / (d2 - d6), ac));
+    }
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+        const double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return VectorAdd(a, VectorAdd(VectorMul(1.0 - w, ab), VectorMul(w, ac)));
+    }
+
+    const double denominator = 1.0 / (va + vb + vc);
+    const double v = vb * denominator;
+    const double w = vc * denominator;
+    return VectorAdd(a, VectorAdd(VectorMul(v, ab), VectorMul(w, ac)));
+}
+
+void PolyhedronShape::DistancesPow2ToTriangles(const unsigned int &begin, const unsigned int &end, const Vector3D &position, double *distances_pow2) const {
+    for (unsigned int k = begin; k < end; ++k) {
+        const double ap_x = position[0] - vertex_x_[k];
+        const double ap_y = position[1] - vertex_y_[k];
+        const double ap_z = position[2] - vertex_z_[k];
+        const double ap_ap = ap_x * ap_x + ap_y * ap_y + ap_z * ap_z;
+        const double ab_ap = edge_ab_x_[k] * ap_x + edge_ab_y_[k] * ap_y + edge_ab_z_[k] * ap_z;
+        const double ac_ap = edge_ac_x_[k] * ap_x + edge_ac_y_[k] * ap_y + edge_ac_z_[k] * ap_z;
+        const double height = normal_x_[k] * ap_x + normal_y_[k] * ap_y + normal_z_[k] * ap_z;
+
+        // barycentric coordinates of the projection onto the plane
+        const double v = (ac_ac_[k] * ab_ap - ab_ac_[k] * ac_ap) * inv_determinant_[k];
+        const double w = (ab_ab_[k] * ac_ap - ab_ac_[k] * ab_ap) * inv_determinant_[k];
+
+        // the edges ab, ac and bc as clamped segments, with bp = ap - ab
+        const double s_ab = std::min(1.0, std::max(0.0, ab_ap / ab_ab_[k]));
+        const double s_ac = std::min(1.0, std::max(0.0, ac_ap / ac_ac_[k]));
+        const double bc_bp = ac_ap - ab_ap - ab_ac_[k] + ab_ab_[k];
+        const double s_bc = std::min(1.0, std::max(0.0, bc_bp / bc_bc_[k]));
+        const double distance_ab_pow2 = ap_ap - s_ab * (2.0 * ab_ap - s_ab * ab_ab_[k]);
+        const double distance_ac_pow2 = ap_ap - s_ac * (2.0 * ac_ap - s_ac * ac_ac_[k]);
+        const double distance_bc_pow2 = ap_ap - 2.0 * ab_ap + ab_ab_[k] - s_bc * (2.0 * bc_bp - s_bc * bc_bc_[k]);
+        const double distance_edges_pow2 = std::min(distance_ab_pow2, std::min(distance_ac_pow2, distance_bc_pow2));
+
+        const bool inside = (v >= 0.0) & (w >= 0.0) & (v + w <= 1.0);
+        distances_pow2[k - begin] = (inside ? height * height : distance_edges_pow2);
+    }
+}
+
+boost::tuple<Vector3D, double> PolyhedronShape::NearestPointOnSurfaceToPosition(const Vector3D &position) const {
+    unsigned int hint = 0;
+    return NearestPointOnSurfaceToPositionWithHint(position, hint);
+}
+
+boost::tuple<Vector3D, double> PolyhedronShape::NearestPointOnSurfaceToPositionWithHint(const Vector3D &position, unsigned int &hint) const {
+    if (hint >= vertex_x_.size()) {
+        hint = 0;
+    }
+
+    // the hint's distance bounds the search
+    Vector3D nearest_point = NearestPointOnTriangle(hint, position);
+    const Vector3D offset = VectorSub(nearest_point, position);
+    double min_distance_pow2 = VectorDotProduct(offset, offset);
+
+    // depth first traversal, every level adds at most one node to the stack
+    unsigned int stack[kMaxDepth + 1];
+    unsigned int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size) {
+        const BVHNode &node = nodes_[stack[--stack_size]];
+        if (DistancePow2ToBox(node, position) >= min_distance_pow2) {
+            continue;
+        }
+
+        if (node.right_child) {
+            const unsigned int left_child = &node - &nodes_[0] + 1;
+            const unsigned int &right_child = node.right_child;
+            if (DistancePow2ToBox(nodes_[left_child], position) < DistancePow2ToBox(nodes_[right_child], position)) {
+                stack[stack_size++] = right_child;
+                stack[stack_size++] = left_child;
+            } else {
+                stack[stack_size++] = left_child;
+                stack[stack_size++] = right_child;
+            }
+            continue;
+        }
+
+        double distances_pow2[kMaxLeafTriangles];
+        DistancesPow2ToTriangles(node.begin, node.end, position, distances_pow2);
+        unsigned int nearest = node.end;
+        for (unsigned int k = node.begin; k < node.end; ++k) {
+            if (distances_pow2[k - node.begin] < min_distance_pow2) {
+                min_distance_pow2 = distances_pow2[k - node.begin];
+                nearest = k;
+            }
+        }
+        if (nearest != node.end) {
+            nearest_point = NearestPointOnTriangle(nearest, position);
+            hint = nearest;
+        }
+    }
+
+    return boost::make_tuple(nearest_point, VectorNorm(VectorSub(nearest_point, position)));
+}
+
+bool PolyhedronShape::PositionIsInside(const Vector3D &position) const {
+    // a fixed direction which is unlikely to graze edges of meshes aligned to the axes
+    const Vector3D direction = {0.8017837257372732, 0.5345224838248488, 0.2672612419124244};
+    const Vector3D inv_direction = {1.0 / direction[0], 1.0 / direction[1], 1.0 / direction[2]};
+
+    int winding_number = 0;
+    unsigned int stack[kMaxDepth + 1];
+    unsigned int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size) {
+        const BVHNode &node = nodes_[stack[--stack_size]];
+
+        // slab test of the ray against the box
+        double t_min = 0.0;
+        double t_max = std::numeric_limits<double>::max();
+        for (unsigned int j = 0; j < 3; ++j) {
+            const double t_lower = (node.lower[j] - position[j]) * inv_direction[j];
+            const double t_upper = (node.upper[j] - position[j]) * inv_direction[j];
+            t_min = std::max(t_min, std::min(t_lower, t_upper));
+            t_max = std::min(t_max, std::max(t_lower, t_upper));
+        }
+        if (t_min > t_max) {
+            continue;
+        }
+
+        if (node.right_child) {
+            stack[stack_size++] = &node - &nodes_[0] + 1;
+            stack[stack_size++] = node.right_child;
+            continue;
+        }
+
+        // Moeller & Trumbore ray triangle intersection, the sign of the determinant tells exits from entries
+        for (unsigned int k = node.begin; k < node.end; ++k) {
+            const Vector3D ab = {edge_ab_x_[k], edge_ab_y_[k], edge_ab_z_[k]};
+            const Vector3D ac = {edge_ac_x_[k], edge_ac_y_[k], edge_ac_z_[k]};
+            const Vector3D p = VectorCrossProduct(direction, ac);
+            const double determinant = VectorDotProduct(ab, p);
+            if (determinant == 0.0) {
+                continue;
+            }
+            const double inv_determinant = 1.0 / determinant;
+            const Vector3D ap = {position[0] - vertex_x_[k], position[1] - vertex_y_[k], position[2] - vertex_z_[k]};
+            const double u = VectorDotProduct(ap, p) * inv_determinant;
+            if (u < 0.0 || u > 1.0) {
+                continue;
+            }
+            const Vector3D q = VectorCrossProduct(ap, ab);
+            const double v = VectorDotProduct(direction, q) * inv_determinant;
+            if (v < 0.0 || u + v > 1.0) {
+                continue;
+            }
+            if (VectorDotProduct(ac, q) * inv_determinant > 0.0) {
+                winding_number += (determinant < 0.0 ? 1 : -1);
+            }
+        }
+    }
+
+    return winding_number > 0;
+}
+
+const TriangleMesh& PolyhedronShape::Mesh() const {
+    return mesh_;
+}
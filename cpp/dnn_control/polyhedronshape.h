@@ -0,0 +1,96 @@
+#ifndef POLYHEDRONSHAPE_H
+#define POLYHEDRONSHAPE_H
+
+#include "shapemodel.h"
+#include "trianglemesh.h"
+
+#include <vector>
+
+class PolyhedronShape : public ShapeModel {
+    /*
+    * This class represents the surface of an asteroid given by a closed triangle mesh in its body fixed RF.
+    *
+    * The triangles are sorted into a bounding volume hierarchy of axis aligned boxes, split at the median centroid along
+    * the longest axis. Nearest point queries descend into the nearer child first and skip boxes further away than the
+    * best triangle so far. The hinted query starts from the triangle found in the previous tick, which usually is the
+    * result again, so the search is bounded from the first box on. The inside test counts the signed crossings of a ray
+    * with the mesh.
+    *
+    * The triangles are stored as structure of arrays in hierarchy order, a leaf's distances are computed in one branch
+    * free loop and only a closer triangle's nearest point is computed. The object is read only after construction and
+    * can be shared by threads.
+    */
+public:
+    PolyhedronShape(const TriangleMesh &mesh);
+
+    virtual ~PolyhedronShape();
+
+    // Computes the distance "distance" and the nearest point on the mesh "point" of a position "position" outside the asteroid
+    virtual boost::tuple<Vector3D, double> NearestPointOnSurfaceToPosition(const Vector3D &position) const;
+
+    // Same as NearestPointOnSurfaceToPosition, "hint" is the triangle of the previous query
+    virtual boost::tuple<Vector3D, double> NearestPointOnSurfaceToPositionWithHint(const Vector3D &position, unsigned int &hint) const;
+
+    // Returns true if the winding number of the mesh around position "position" is positive
+    virtual bool PositionIsInside(const Vector3D &position) const;
+
+    const TriangleMesh& Mesh() const;
+
+private:
+    // A node of the hierarchy covers the triangles [begin, end), its right child is at "right_child", its left child follows it directly
+    struct BVHNode {
+        Vector3D lower;
+        Vector3D upper;
+        unsigned int begin;
+        unsigned int end;
+
+        // 0 for leaves
+        unsigned int right_child;
+    };
+
+    // Sorts the triangles [begin, end) of "order" into the subtree rooted at a new node
+    void BuildHierarchy(const unsigned int &begin, const unsigned int &end, std::vector<unsigned int> &order, const std::vector<Vector3D> &centroids);
+
+    // Returns the squared distance of position "position" to box "node"
+    double DistancePow2ToBox(const BVHNode &node, const Vector3D &position) const;
+
+    // Computes the nearest point of triangle "triangle" to "position" (Ericson, Real-Time Collision Detection, 5.1.5)
+    Vector3D NearestPointOnTriangle(const unsigned int &triangle, const Vector3D &position) const;
+
+    // Computes the squared distances "distances_pow2" of triangles [begin, end) to "position" without branches, the distance
+    // to the plane if the projection falls inside the triangle and to the nearest edge otherwise
+    void DistancesPow2ToTriangles(const unsigned int &begin, const unsigned int &end, const Vector3D &position, double *distances_pow2) const;
+
+    // Maximal number of triangles in a leaf, median splits keep the depth below log2 of the number of triangles
+    const static unsigned int kMaxLeafTriangles = 4;
+    const static unsigned int kMaxDepth = 32;
+
+    // The surface mesh
+    TriangleMesh mesh_;
+
+    // Triangle vertex a and edges b - a and c - a in hierarchy order
+    std::vector<double> vertex_x_;
+    std::vector<double> vertex_y_;
+    std::vector<double> vertex_z_;
+    std::vector<double> edge_ab_x_;
+    std::vector<double> edge_ab_y_;
+    std::vector<double> edge_ab_z_;
+    std::vector<double> edge_ac_x_;
+    std::vector<double> edge_ac_y_;
+    std::vector<double> edge_ac_z_;
+
+    // Unit normals, the Gram matrix of the edges ab.ab, ab.ac, ac.ac, |c - b|^2 and the inverse of its determinant
+    std::vector<double> normal_x_;
+    std::vector<double> normal_y_;
+    std::vector<double> normal_z_;
+    std::vector<double> ab_ab_;
+    std::vector<double> ab_ac_;
+    std::vector<double> ac_ac_;
+    std::vector<double> bc_bc_;
+    std::vector<double> inv_determinant_;
+
+    // The hierarchy, the root is node 0
+    std::vector<BVHNode> nodes_;
+};
+
+#endif // POLYHEDRONSHAPE_H
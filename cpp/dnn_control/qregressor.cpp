@@ -0,0 +1,5 @@
+#include "qregressor.h"
+
+QRegressor::~QRegressor() {
+
+}
@@ -0,0 +1,50 @@
+#ifndef QREGRESSOR_H
+#define QREGRESSOR_H
+
+#include <eigen3/Eigen/Dense>
+
+class QRegressor {
+    /*
+    * This abstract class represents a regression of Q values for fitted Q iteration.
+    *
+    * Fitted Q iteration fits the Q values of the same training inputs in every iteration and needs the Q values of the
+    * same queries to compute the next targets. Both are set once by SetInputs, so a regressor can prepare whatever does
+    * not depend on the targets only once, e.g. search the neighbors of the queries. An input is a row of a state
+    * followed by the features of an action.
+    *
+    * A fitted regressor is described by its training inputs and Parameters(), so it can be stored and restored by
+    * SetParameters, e.g. for the greedy policy of a finished run. Predict runs on the calling thread and does not change
+    * the regressor, so the tasks of a thread pool can predict concurrently.
+    */
+public:
+    // Inputs, one per row
+    typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> InputMatrix;
+
+    virtual ~QRegressor();
+
+    // Sets the training inputs "inputs" and the queries "queries" of all following calls of Fit and PredictQueries
+    virtual void SetInputs(const InputMatrix &inputs, const InputMatrix &queries) = 0;
+
+    // Fits the Q values "targets" of the training inputs
+    virtual void Fit(const Eigen::VectorXd &targets) = 0;
+
+    // Computes the Q values "q_values" of the queries
+    virtual void PredictQueries(Eigen::VectorXd &q_values) = 0;
+
+    // Computes the Q values "q_values" of the inputs "inputs"
+    virtual void Predict(const InputMatrix &inputs, Eigen::VectorXd &q_values) const = 0;
+
+    // Returns the values which the Q values depend on besides the training inputs, e.g. the targets or the weights of a network
+    virtual Eigen::VectorXd Parameters() const = 0;
+
+    // Restores the fitted regressor of the training inputs "inputs" and the parameters "parameters" without queries
+    virtual void SetParameters(const InputMatrix &inputs, const Eigen::VectorXd &parameters) = 0;
+
+    // QRegressor can throw the following exceptions
+    class Exception {};
+    class InvalidInputsException : public Exception {};
+    class InvalidTargetsException : public Exception {};
+    class InvalidParametersException : public Exception {};
+};
+
+#endif // QREGRESSOR_H
@@ -0,0 +1,98 @@
+#include "radialbasisgrid.h"
+
+#include <cmath>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+
+RadialBasisGrid::RadialBasisGrid(const std::vector<double> &lower, const std::vector<double> &upper, const unsigned int &grid_size, const double &width, const double &cutoff)
+    : lower_(lower), upper_(upper), grid_size_(grid_size), width_(width), cutoff_(cutoff) {
+
+    if (lower.empty() || lower.size() != upper.size() || grid_size < 2 || width <= 0.0 || cutoff <= 0.0) {
+        throw InvalidParameterException();
+    }
+
+    double num_centers = 1.0;
+    for (unsigned int i = 0; i < lower.size(); ++i) {
+        if (upper[i] <= lower[i]) {
+            throw InvalidParameterException();
+        }
+        spacing_.push_back((upper[i] - lower[i]) / (grid_size - 1));
+        sigma_.push_back(width * spacing_.back());
+        num_centers *= grid_size;
+    }
+    if (num_centers + 1.0 > 4294967295.0) {
+        throw InvalidParameterException();
+    }
+    num_features_ = static_cast<unsigned int>(num_centers) + 1;
+}
+
+RadialBasisGrid::~RadialBasisGrid() {
+
+}
+
+unsigned int RadialBasisGrid::NumFeatures() const {
+    return num_features_;
+}
+
+unsigned int RadialBasisGrid::StateDimension() const {
+    return lower_.size();
+}
+
+void RadialBasisGrid::Features(const double *state, std::vector<unsigned int> &indices, std::vector<double> &values) const {
+    const unsigned int dimension = lower_.size();
+    indices.assign(1, 0);
+    values.assign(1, 1.0);
+
+    // the range of centers [first, last] within the cutoff per dimension, and their one dimensional values
+    std::vector<int> first(dimension);
+    std::vector<int> last(dimension);
+    std::vector<double> axis_values;
+    std::vector<unsigned int> axis_offsets(dimension);
+    for (unsigned int i = 0; i < dimension; ++i) {
+        const double position = (state[i] - lower_[i]) / spacing_[i];
+        const double reach = cutoff_ * sigma_[i] / spacing_[i];
+        first[i] = std::max(0, static_cast<int>(std::ceil(position - reach)));
+        last[i] = std::min(static_cast<int>(grid_size_) - 1, static_cast<int>(std::floor(position + reach)));
+        if (first[i] > last[i]) {
+            return;
+        }
+
+        axis_offsets[i] = axis_values.size();
+        for (int c = first[i]; c <= last[i]; ++c) {
+            const double distance = (state[i] - lower_[i] - c * spacing_[i]) / sigma_[i];
+            axis_values.push_back(std::exp(-0.5 * distance * distance));
+        }
+    }
+
+    // the first dimension is the most significant digit of the center index, counting the last dimension up first keeps the indices ascending
+    std::vector<int> center(first);
+    while (true) {
+        unsigned int index = 0;
+        double value = 1.0;
+        for (unsigned int i = 0; i < dimension; ++i) {
+            index = index * grid_size_ + center[i];
+            value *= axis_values[axis_offsets[i] + center[i] - first[i]];
+        }
+        indices.push_back(1 + index);
+        values.push_back(value);
+
+        int i = dimension - 1;
+        while (i >= 0 && center[i] == last[i]) {
+            center[i] = first[i];
+            --i;
+        }
+        if (i < 0) {
+            break;
+        }
+        ++center[i];
+    }
+}
+
+void RadialBasisGrid::WriteTo(std::ostream &stream) const {
+    const boost::uint32_t header[3] = {RadialBasisGridType, static_cast<boost::uint32_t>(lower_.size()), grid_size_};
+    const double shape[2] = {width_, cutoff_};
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+    stream.write(reinterpret_cast<const char*>(lower_.data()), lower_.size() * sizeof(double));
+    stream.write(reinterpret_cast<const char*>(upper_.data()), upper_.size() * sizeof(double));
+}
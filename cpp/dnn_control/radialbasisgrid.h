@@ -0,0 +1,56 @@
+#ifndef RADIALBASISGRID_H
+#define RADIALBASISGRID_H
+
+#include "lspistatebasis.h"
+
+#include <vector>
+
+class RadialBasisGrid : public LSPIStateBasis {
+    /*
+    * This class represents Gaussian radial basis functions centered on a regular grid of "grid_size" centers per
+    * dimension over the box [lower, upper] of the state space, plus a constant function (feature 0). The standard
+    * deviation is "width" grid spacings.
+    *
+    * The Gaussian is the product of one dimensional Gaussians, so per dimension only the centers within "cutoff"
+    * standard deviations of the state are considered and the features are the products of their values. Functions
+    * further away are treated as 0.
+    *
+    * WriteTo stores uint32 type, uint32 D, uint32 grid size, double width, double cutoff, double lower[D],
+    * double upper[D].
+    */
+public:
+    RadialBasisGrid(const std::vector<double> &lower, const std::vector<double> &upper, const unsigned int &grid_size, const double &width=1.0, const double &cutoff=2.0);
+
+    virtual ~RadialBasisGrid();
+
+    virtual unsigned int NumFeatures() const;
+
+    virtual unsigned int StateDimension() const;
+
+    virtual void Features(const double *state, std::vector<unsigned int> &indices, std::vector<double> &values) const;
+
+    virtual void WriteTo(std::ostream &stream) const;
+
+    // RadialBasisGrid can throw the following exceptions
+    class Exception {};
+    class InvalidParameterException : public Exception {};
+
+private:
+    std::vector<double> lower_;
+    std::vector<double> upper_;
+
+    // Distance of neighbouring centers and standard deviation per dimension
+    std::vector<double> spacing_;
+    std::vector<double> sigma_;
+
+    unsigned int grid_size_;
+
+    // The standard deviation in grid spacings
+    double width_;
+
+    double cutoff_;
+
+    unsigned int num_features_;
+};
+
+#endif // RADIALBASISGRID_H
@@ -0,0 +1,51 @@
+#include "recordingbuffer.h"
+
+RecordingBuffer::RecordingBuffer(const unsigned int &stride, const unsigned int &capacity)
+    : stride_(stride), capacity_(capacity), oldest_(0) {
+    if (stride_ == 0) {
+        throw InvalidStrideException();
+    }
+}
+
+void RecordingBuffer::Store(const unsigned int &tick, const std::vector<double> &recording) {
+    if (capacity_ == 0 || recordings_.size() < capacity_) {
+        recordings_.push_back(recording);
+        ticks_.push_back(tick);
+    } else {
+        // assign keeps the slot's storage
+        recordings_[oldest_].assign(recording.begin(), recording.end());
+        ticks_[oldest_] = tick;
+        oldest_ = (oldest_ + 1) % capacity_;
+    }
+}
+
+void RecordingBuffer::Reserve(const unsigned int &num_recordings) {
+    unsigned int size = num_recordings;
+    if (capacity_ > 0 && capacity_ < size) {
+        size = capacity_;
+    }
+    recordings_.reserve(size);
+    ticks_.reserve(size);
+}
+
+std::vector<std::vector<double> > RecordingBuffer::Recordings() const {
+    std::vector<std::vector<double> > recordings;
+    recordings.reserve(recordings_.size());
+    for (unsigned int i = 0; i < recordings_.size(); ++i) {
+        recordings.push_back(recordings_[(oldest_ + i) % recordings_.size()]);
+    }
+    return recordings;
+}
+
+std::vector<unsigned int> RecordingBuffer::Ticks() const {
+    std::vector<unsigned int> ticks;
+    ticks.reserve(ticks_.size());
+    for (unsigned int i = 0; i < ticks_.size(); ++i) {
+        ticks.push_back(ticks_[(oldest_ + i) % ticks_.size()]);
+    }
+    return ticks;
+}
+
+unsigned int RecordingBuffer::Size() const {
+    return recordings_.size();
+}
@@ -0,0 +1,59 @@
+#ifndef RECORDINGBUFFER_H
+#define RECORDINGBUFFER_H
+
+#include <vector>
+
+class RecordingBuffer {
+    /*
+    * This class collects the sensor recordings of a simulation. Only every "stride"-th tick is recorded and, if a capacity
+    * is set, only the last "capacity" recordings are kept in a ring whose slots (and their storage) are reused.
+    *
+    * Every recording is stored together with the tick it was taken at, so the recordings can be aligned with the per tick
+    * results of the simulation.
+    */
+public:
+    // capacity == 0 keeps all recordings
+    RecordingBuffer(const unsigned int &stride=1, const unsigned int &capacity=0);
+
+    // Returns true if tick "tick" has to be recorded
+    bool IsDue(const unsigned int &tick) const;
+
+    // Stores a copy of "recording" as the recording of tick "tick"
+    void Store(const unsigned int &tick, const std::vector<double> &recording);
+
+    // Reserves space for "num_recordings" recordings, limited by the capacity
+    void Reserve(const unsigned int &num_recordings);
+
+    // Returns the kept recordings in the order they were stored
+    std::vector<std::vector<double> > Recordings() const;
+
+    // Returns the ticks of the kept recordings in the order they were stored
+    std::vector<unsigned int> Ticks() const;
+
+    // Returns the number of kept recordings
+    unsigned int Size() const;
+
+    // RecordingBuffer can throw the following exceptions
+    class Exception {};
+    class InvalidStrideException : public Exception {};
+
+private:
+    // Record every stride_-th tick
+    unsigned int stride_;
+
+    // Maximum number of kept recordings, 0 if unlimited
+    unsigned int capacity_;
+
+    // The recordings and their ticks, a ring starting at oldest_ once the capacity is reached
+    std::vector<std::vector<double> > recordings_;
+    std::vector<unsigned int> ticks_;
+
+    // Position of the oldest recording, the next one to overwrite
+    unsigned int oldest_;
+};
+
+inline bool RecordingBuffer::IsDue(const unsigned int &tick) const {
+    return tick % stride_ == 0;
+}
+
+#endif // RECORDINGBUFFER_H
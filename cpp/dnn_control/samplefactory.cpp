@@ -1,7 +1,13 @@
 #include "samplefactory.h"
 #include "constants.h"
 
-SampleFactory::SampleFactory() {
+// Returns the first word index >= index which starts a Philox block
+static boost::uint64_t AlignToBlock(const boost::uint64_t &index) {
+    return (index + 3) & ~static_cast<boost::uint64_t>(3);
+}
+
+SampleFactory::SampleFactory()
+    : backend_(MersenneTwister) {
     srand(time(0));
     seed_ = rand();
     generator_ = boost::mt19937(seed_);
@@ -9,34 +15,53 @@ SampleFactory::SampleFactory() {
     normal_distribution_ = boost::random::normal_distribution<>(0.0, 1.0);
 }
 
-SampleFactory::SampleFactory(const unsigned int &random_seed) {
+SampleFactory::SampleFactory(const unsigned int &random_seed)
+    : backend_(MersenneTwister) {
     seed_ = random_seed;
     generator_ = boost::mt19937(seed_);
     uniform_real_distribution_ = boost::random::uniform_real_distribution<>(0.0, 1.0);
     normal_distribution_ = boost::random::normal_distribution<>(0.0, 1.0);
 }
 
-unsigned int SampleFactory::SampleRandomNatural() {
+SampleFactory::SampleFactory(const unsigned int &seed, const unsigned int &stream)
+    : backend_(Philox), philox_generator_(seed, stream) {
+    seed_ = seed;
+    uniform_real_distribution_ = boost::random::uniform_real_distribution<>(0.0, 1.0);
+    normal_distribution_ = boost::random::normal_distribution<>(0.0, 1.0);
+}
+
+SampleFactory SampleFactory::Fork(const unsigned int &stream) const {
+    return SampleFactory(seed_, stream);
+}
+
+unsigned int SampleFactory::NextWord() {
+    if (backend_ == Philox) {
+        return philox_generator_();
+    }
     return generator_();
 }
 
+unsigned int SampleFactory::SampleRandomNatural() {
+    return NextWord();
+}
+
 unsigned int SampleFactory::SampleUniformNatural(const int &minimum, const int &maximum) {
     if (minimum != uniform_int_distribution_.min() || maximum != uniform_int_distribution_.max()) {
         uniform_int_distribution_ = boost::random::uniform_int_distribution<>(minimum, maximum);
     }
-    return uniform_int_distribution_(generator_);
+    return Draw(uniform_int_distribution_);
 }
 
 double SampleFactory::SampleUniformReal(const double &minimum, const double &maximum) {
-    return minimum + (maximum - minimum) * uniform_real_distribution_(generator_);
+    return minimum + (maximum - minimum) * Draw(uniform_real_distribution_);
 }
 
 double SampleFactory::SampleNormal(const double &mean, const double &standard_deviation) {
-    return normal_distribution_(generator_) * standard_deviation + mean;
+    return Draw(normal_distribution_) * standard_deviation + mean;
 }
 
 double SampleFactory::SampleSign() {
-    if (generator_() % 2) {
+    if (NextWord() % 2) {
         return 1.0;
     } else {
         return -1.0;
@@ -44,7 +69,7 @@ double SampleFactory::SampleSign() {
 }
 
 bool SampleFactory::SampleBoolean() {
-    if (generator_() % 2) {
+    if (NextWord() % 2) {
         return true;
     } else {
         return false;
@@ -76,10 +101,78 @@ boost::tuple<Vector3D, double, double> SampleFactory::SamplePointOnEllipsoidSurf
     return boost::make_tuple(point, v, u);
 }
 
+void SampleFactory::FillUniformReal(std::vector<double> &values, const double &minimum, const double &maximum) {
+    const unsigned int num_values = values.size();
+    if (num_values == 0) {
+        return;
+    }
+    if (backend_ == Philox) {
+        // two values per block, starting at the next block of the stream
+        const boost::uint64_t first_block_index = AlignToBlock(philox_generator_.Index()) / 4;
+        philox_generator_.FillUniform(&values[0], num_values, first_block_index);
+        philox_generator_.Seek((first_block_index + (num_values + 1) / 2) * 4);
+        for (unsigned int i = 0; i < num_values; ++i) {
+            values[i] = minimum + (maximum - minimum) * values[i];
+        }
+    } else {
+        for (unsigned int i = 0; i < num_values; ++i) {
+            values[i] = SampleUniformReal(minimum, maximum);
+        }
+    }
+}
+
+void SampleFactory::FillNormal(std::vector<double> &values, const double &mean, const double &standard_deviation) {
+    const unsigned int num_values = values.size();
+    if (num_values == 0) {
+        return;
+    }
+    if (backend_ == Philox) {
+        const boost::uint64_t first_block_index = AlignToBlock(philox_generator_.Index()) / 4;
+        philox_generator_.FillNormal(&values[0], num_values, first_block_index);
+        philox_generator_.Seek((first_block_index + (num_values + 1) / 2) * 4);
+        for (unsigned int i = 0; i < num_values; ++i) {
+            values[i] = values[i] * standard_deviation + mean;
+        }
+    } else {
+        for (unsigned int i = 0; i < num_values; ++i) {
+            values[i] = SampleNormal(mean, standard_deviation);
+        }
+    }
+}
+
+void SampleFactory::Seek(const boost::uint64_t &index) {
+    if (backend_ != Philox) {
+        throw BackendNotSupportedException();
+    }
+    philox_generator_.Seek(index);
+}
+
+boost::uint64_t SampleFactory::Index() const {
+    if (backend_ != Philox) {
+        throw BackendNotSupportedException();
+    }
+    return philox_generator_.Index();
+}
+
 void SampleFactory::SetSeed(const unsigned int &random_seed) {
-    generator_.seed(random_seed);
+    if (backend_ == Philox) {
+        philox_generator_.SetSeed(random_seed, philox_generator_.Stream());
+    } else {
+        generator_.seed(random_seed);
+    }
 }
 
 unsigned int SampleFactory::Seed() const {
     return seed_;
 }
+
+unsigned int SampleFactory::Stream() const {
+    if (backend_ == Philox) {
+        return philox_generator_.Stream();
+    }
+    return 0;
+}
+
+SampleFactory::Backend SampleFactory::BackendOfFactory() const {
+    return backend_;
+}
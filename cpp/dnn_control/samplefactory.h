@@ -2,18 +2,37 @@
 #define SAMPLEFACTORY_H
 
 #include "vector.h"
+#include "philoxgenerator.h"
 
 #include <boost/tuple/tuple.hpp>
 #include <boost/random.hpp>
 
+#include <vector>
+
 class SampleFactory {
     /*
     * This class represents a factory from which different distributed samples can be drawn.
+    *
+    * The samples are drawn either from a Mersenne twister (default, every simulation relies on its sequences) or from the
+    * counter based Philox generator. A Philox factory is addressable by (seed, stream, index): streams are independent of
+    * each other and any position of a stream can be reached without drawing the samples before it.
     */
 public:
+    // The available random number generators
+    enum Backend {
+        MersenneTwister,
+        Philox
+    };
+
     SampleFactory();
     SampleFactory(const unsigned int &seed);
 
+    // Philox factory drawing from stream "stream" of seed "seed"
+    SampleFactory(const unsigned int &seed, const unsigned int &stream);
+
+    // Returns a Philox factory with the same seed drawing from stream "stream"
+    SampleFactory Fork(const unsigned int &stream) const;
+
 
     // X ~ U(N)
     unsigned int SampleRandomNatural();
@@ -45,19 +64,60 @@ public:
     // semi_axis_[2] * cos(v)          = point[2]
     boost::tuple<Vector3D, double, double> SamplePointOnEllipsoidSurface(const Vector3D &semi_axis);
 
+    // values[i] ~ U(minimum, maximum), drawn in bulk
+    void FillUniformReal(std::vector<double> &values, const double &minimum, const double &maximum);
+
+    // values[i] ~ N(mean, std), drawn in bulk
+    void FillNormal(std::vector<double> &values, const double &mean, const double &standard_deviation);
+
+    // Moves a Philox factory to the 32 bit word at position "index" of its stream
+    void Seek(const boost::uint64_t &index);
+
+    // Returns the stream position of a Philox factory
+    boost::uint64_t Index() const;
+
     // Set the seed of the factory
     void SetSeed(const unsigned int &random_seed);
 
     // Get the seed of the factory
     unsigned int Seed() const;
 
+    // Get the stream of the factory, 0 for the Mersenne twister
+    unsigned int Stream() const;
+
+    // Get the random number generator the factory draws from
+    Backend BackendOfFactory() const;
+
+    // SampleFactory can throw the following exceptions
+    class Exception {};
+    class BackendNotSupportedException : public Exception {};
+
 private:
+    // Draws one sample from "distribution" with the configured generator
+    template <typename Distribution>
+    typename Distribution::result_type Draw(Distribution &distribution) {
+        if (backend_ == Philox) {
+            return distribution(philox_generator_);
+        }
+        return distribution(generator_);
+    }
+
+    // Draws the next 32 bit word of the configured generator
+    unsigned int NextWord();
+
+    // The generator samples are drawn from
+    Backend backend_;
+
+
     // The seed the random number generator is initialized with
     unsigned int seed_;
 
     // The random number generator used for producing different samples
     boost::mt19937 generator_;
 
+    // The counter based random number generator used by Philox factories
+    PhiloxGenerator philox_generator_;
+
     // Uniform distribution between [0,1]
     boost::random::uniform_real_distribution<> uniform_real_distribution_;
 
@@ -0,0 +1,28 @@
+#ifndef SCOPEDGILRELEASE_H
+#define SCOPEDGILRELEASE_H
+
+#include <Python.h>
+
+class ScopedGILRelease {
+    /*
+    * This class releases Python's global interpreter lock for its lifetime, so other Python threads run while a
+    * binding loops in C++. No Python object may be touched while the lock is released.
+    */
+public:
+    ScopedGILRelease() {
+        state_ = PyEval_SaveThread();
+    }
+
+    ~ScopedGILRelease() {
+        PyEval_RestoreThread(state_);
+    }
+
+private:
+    ScopedGILRelease(const ScopedGILRelease &other);
+    ScopedGILRelease& operator=(const ScopedGILRelease &other);
+
+    // The thread state saved on release
+    PyThreadState *state_;
+};
+
+#endif // SCOPEDGILRELEASE_H
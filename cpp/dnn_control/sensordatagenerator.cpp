@@ -1,65 +1,148 @@
 #include "sensordatagenerator.h"
+#include "sensordatashard.h"
 #include "filewriter.h"
 #include "pagmosimulationneuralnetwork.h"
 #include "samplefactory.h"
+#include "threadpool.h"
 
-#include <ctime>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
 #include <sstream>
 
-SensorDataGenerator::SensorDataGenerator(const std::string &path_to_output_folder, const double &data_set_time)
-    : data_set_time_(data_set_time), path_to_output_folder_(path_to_output_folder) {
+const unsigned int SensorDataGenerator::kDefaultDataSetsPerShard;
 
+SensorDataGenerator::SensorDataGenerator(const std::string &path_to_output_folder, const double &data_set_time, const std::set<SensorSimulator::SensorType> &recording_sensor_types, const bool &recording_with_noise, const unsigned int &recording_stride, const unsigned int &num_threads, const unsigned int &data_sets_per_shard)
+    : data_set_time_(data_set_time), path_to_output_folder_(path_to_output_folder), recording_sensor_types_(recording_sensor_types), recording_with_noise_(recording_with_noise), recording_stride_(recording_stride), num_threads_(num_threads), data_sets_per_shard_(data_sets_per_shard), text_files_enabled_(false) {
+    if (data_sets_per_shard_ == 0) {
+        throw InvalidDataSetsPerShardException();
+    }
+}
+
+void SensorDataGenerator::SetTextFilesEnabled(const bool &enabled) {
+    text_files_enabled_ = enabled;
+}
+
+std::string SensorDataGenerator::PathToShardFile(const unsigned int &random_seed, const unsigned int &shard) const {
+    std::stringstream ss;
+    ss << path_to_output_folder_ << "sensor_data_" << random_seed << "_shard_" << shard << ".bin";
+    return ss.str();
+}
+
+std::string SensorDataGenerator::PathToManifestFile(const unsigned int &random_seed) const {
+    std::stringstream ss;
+    ss << path_to_output_folder_ << "sensor_data_" << random_seed << "_manifest.txt";
+    return ss.str();
 }
 
 void SensorDataGenerator::Generate(const unsigned int &num_datasets, const unsigned int &random_seed, const std::vector<double> &neural_network_weights) {
+    // draw all seeds first, they are the same as for a serial generation
     SampleFactory sample_factory(random_seed);
-
+    std::vector<unsigned int> seeds(num_datasets);
     for (unsigned int data_iter = 0; data_iter < num_datasets; ++data_iter) {
-        std::cout << "generation " << (data_iter + 1) << " : " << std::endl;
-        PaGMOSimulationNeuralNetwork simulation(sample_factory.SampleRandomNatural(), 6, neural_network_weights);
+        seeds.at(data_iter) = sample_factory.SampleRandomNatural();
+    }
+
+    const unsigned int num_shards = (num_datasets + data_sets_per_shard_ - 1) / data_sets_per_shard_;
+    std::vector<SensorDataShard> shards;
+    std::vector<unsigned int> missing_data_sets;
+    for (unsigned int shard = 0; shard < num_shards; ++shard) {
+        const unsigned int first_data_set = shard * data_sets_per_shard_;
+        const unsigned int size = std::min(data_sets_per_shard_, num_datasets - first_data_set);
+        shards.push_back(SensorDataShard(size));
+        missing_data_sets.push_back(size);
+    }
+
+    ThreadPool thread_pool(num_threads_);
+    std::cout << "generating " << num_datasets << " data sets in " << num_shards << " shards on " << thread_pool.NumThreads() << " threads" << std::endl;
+
+    std::mutex mutex;
+    unsigned int num_finished = 0;
+    unsigned long num_rows = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    thread_pool.ParallelFor(num_datasets, [&](const unsigned int &data_iter, const unsigned int &) {
+        const unsigned int &seed = seeds.at(data_iter);
+        PaGMOSimulationNeuralNetwork simulation(seed, 6, neural_network_weights, {}, false, recording_sensor_types_, recording_with_noise_);
         simulation.SetSimulationTime(data_set_time_);
+        simulation.SetRecordingStride(recording_stride_);
 
-        std::cout << "   running simulation ... ";
         const boost::tuple<std::vector<double>, std::vector<double>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<Vector3D>, std::vector<std::vector<double> > > result = simulation.EvaluateAdaptive();
-        const std::vector<Vector3D> &positions = boost::get<2>(result);
-        const std::vector<Vector3D> &heights = boost::get<3>(result);
-        const std::vector<Vector3D> &thrusts = boost::get<5>(result);
+        const std::vector<Vector3D> &evaluated_positions = boost::get<2>(result);
+        const std::vector<Vector3D> &evaluated_heights = boost::get<3>(result);
+        const std::vector<Vector3D> &evaluated_thrusts = boost::get<5>(result);
         const std::vector<std::vector<double> > &data_set = boost::get<6>(result);
-        std::cout << "done." << std::endl;
 
-        time_t raw_time;
-        struct tm *time_info;
-        std::time(&raw_time);
-        time_info = localtime(&raw_time);
+        // the thrusts, positions and heights at the recorded ticks
+        const std::vector<unsigned int> recorded_ticks = simulation.RecordedTicks();
+        std::vector<Vector3D> thrusts(recorded_ticks.size());
+        std::vector<Vector3D> positions(recorded_ticks.size());
+        std::vector<Vector3D> heights(recorded_ticks.size());
+        for (unsigned int i = 0; i < recorded_ticks.size(); ++i) {
+            const unsigned int &tick = recorded_ticks.at(i);
+            thrusts.at(i) = evaluated_thrusts.at(tick);
+            positions.at(i) = evaluated_positions.at(tick);
+            heights.at(i) = evaluated_heights.at(tick);
+        }
 
-        char buffer[80];
-        strftime(buffer,80,"%d_%m_%H_%I_%M_%S",time_info);
-        std::string str(buffer);
+        const SystemState system_state = simulation.InitialSystemState();
+        const double control_frequency = simulation.ControlFrequency();
 
-        std::string path_to_sensor_data_file = str + "_gen";
+        const unsigned int shard = data_iter / data_sets_per_shard_;
+        shards.at(shard).SetDataSet(data_iter % data_sets_per_shard_, seed, control_frequency, data_set_time_, system_state, data_set, thrusts, positions, heights);
 
-        std::stringstream ss;
-        ss << data_iter + 1;
-        ss << ".txt";
-        path_to_sensor_data_file += ss.str();
+        if (text_files_enabled_) {
+            std::stringstream ss;
+            ss << seed << ".txt";
+            const std::string path_to_sensor_data_file = path_to_output_folder_ + "sensor_stream_" + ss.str();
+            const std::string path_to_trajectory_file = path_to_output_folder_ + "trajectory_" + ss.str();
 
-        std::string path_to_trajectory_file(path_to_sensor_data_file);
+            FileWriter writer_sensor_data(path_to_sensor_data_file);
+            writer_sensor_data.CreateSensorDataFile(seed, control_frequency, data_set_time_, simulation.AsteroidOfSystem(), system_state, thrusts, data_set);
+            FileWriter writer_trajectory(path_to_trajectory_file);
+            writer_trajectory.CreateTrajectoryFile(control_frequency, simulation.AsteroidOfSystem(), evaluated_positions, evaluated_heights);
+        }
 
-        path_to_sensor_data_file = path_to_output_folder_ + "sensor_stream_" + path_to_sensor_data_file;
-        path_to_trajectory_file = path_to_output_folder_ + "trajectory_" + path_to_trajectory_file;
-
-        const unsigned int random_seed = simulation.RandomSeed();
-        const SystemState system_state = simulation.InitialSystemState();
-        const double control_frequency = simulation.ControlFrequency();
+        // the thread completing a shard writes it
+        bool shard_complete = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shard_complete = (--missing_data_sets.at(shard) == 0);
+        }
+        if (shard_complete) {
+            shards.at(shard).Write(PathToShardFile(random_seed, shard));
+        }
 
+        std::lock_guard<std::mutex> lock(mutex);
+        ++num_finished;
+        num_rows += data_set.size();
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "   [" << num_finished << "/" << num_datasets << "] seed " << seed << ": " << data_set.size() << " rows"
+                  << " (" << elapsed << " s, " << num_finished / elapsed << " data sets/s, " << num_rows / elapsed << " rows/s)" << std::endl;
+        if (shard_complete) {
+            std::cout << "   wrote shard " << PathToShardFile(random_seed, shard) << std::endl;
+        }
+    });
 
-        std::cout << "   writing sensor data to file " << path_to_sensor_data_file << " ... ";
-        FileWriter writer_sensor_data(path_to_sensor_data_file);
-        writer_sensor_data.CreateSensorDataFile(random_seed, control_frequency, data_set_time_, simulation.AsteroidOfSystem(), system_state, thrusts, data_set);
-        std::cout << "done." << std::endl;
-        std::cout << "   writing trajectory to file " << path_to_trajectory_file << " ... ";
-        FileWriter writer_trajectory(path_to_trajectory_file);
-        writer_trajectory.CreateTrajectoryFile(control_frequency, simulation.AsteroidOfSystem(), positions, heights);
-        std::cout << "done." << std::endl;
+    const std::string path_to_manifest_file = PathToManifestFile(random_seed);
+    std::ofstream manifest(path_to_manifest_file.c_str());
+    if (!manifest.is_open()) {
+        throw ManifestNotWritableException();
     }
+    manifest << "# sensor data shards, format version " << SensorDataShard::kVersion << std::endl;
+    manifest << "# random seed: " << random_seed << std::endl;
+    manifest << "# data set time: " << data_set_time_ << " s" << std::endl;
+    manifest << "# recording stride: " << recording_stride_ << std::endl;
+    manifest << "# data_set, shard_file, seed, offset, rows, dimensions" << std::endl;
+    for (unsigned int data_iter = 0; data_iter < num_datasets; ++data_iter) {
+        const unsigned int shard = data_iter / data_sets_per_shard_;
+        const unsigned int slot = data_iter % data_sets_per_shard_;
+        const std::string path_to_shard_file = PathToShardFile(random_seed, shard);
+        const SensorDataShard &data_shard = shards.at(shard);
+        manifest << data_iter << ", " << path_to_shard_file.substr(path_to_output_folder_.size()) << ", " << data_shard.SeedOfDataSet(slot) << ", " << data_shard.OffsetOfDataSet(slot) << ", " << data_shard.RowsOfDataSet(slot) << ", " << data_shard.DimensionsOfDataSet(slot) << std::endl;
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "done: " << num_datasets << " data sets, " << num_rows << " rows in " << elapsed << " s, manifest " << path_to_manifest_file << std::endl;
 }
@@ -1,25 +1,69 @@
 #ifndef SENSORDATAGENERATOR_H
 #define SENSORDATAGENERATOR_H
 
+#include "sensorsimulator.h"
+
 #include <string>
 #include <vector>
+#include <set>
 
 class SensorDataGenerator {
 	/*
 	* This class generates and creates files for sensor data streams generated by random simulations.
+	*
+	* The simulations run in parallel on a thread pool. Their seeds are drawn up front from the generator seed, so the
+	* output does not depend on the number of threads or the order in which the simulations finish. The data sets are
+	* written to binary SensorDataShard files together with a text manifest listing every data set's shard, byte offset,
+	* rows and dimensions. All file names derive from seeds, hence concurrent runs with different seeds never collide.
 	*/
 public:
-    SensorDataGenerator(const std::string &path_to_output_folder, const double &data_set_time);
+    // The default number of data sets per shard file
+    const static unsigned int kDefaultDataSetsPerShard = 16;
+
+    // Only every "recording_stride"-th tick of a simulation is written. num_threads == 0 uses all hardware threads.
+    SensorDataGenerator(const std::string &path_to_output_folder, const double &data_set_time, const std::set<SensorSimulator::SensorType> &recording_sensor_types, const bool &recording_with_noise=false, const unsigned int &recording_stride=1, const unsigned int &num_threads=0, const unsigned int &data_sets_per_shard=kDefaultDataSetsPerShard);
 
-    // Generates the sensor data stream files
+    // Generates the sensor data shards and their manifest
     void Generate(const unsigned int &num_datasets, const unsigned int &random_seed, const std::vector<double> &neural_network_weights=std::vector<double>());
 
+    // Additionally write every data set as sensor stream and trajectory text file, named after its seed
+    void SetTextFilesEnabled(const bool &enabled);
+
+    // Returns the path of shard "shard" of a generation with seed "random_seed"
+    std::string PathToShardFile(const unsigned int &random_seed, const unsigned int &shard) const;
+
+    // Returns the path of the manifest of a generation with seed "random_seed"
+    std::string PathToManifestFile(const unsigned int &random_seed) const;
+
+    // SensorDataGenerator can throw the following exceptions
+    class Exception {};
+    class InvalidDataSetsPerShardException : public Exception {};
+    class ManifestNotWritableException : public Exception {};
+
 private:
     // The time for which the sensor data stream will be produced
     double data_set_time_;
 
     // The path to the output folder
     std::string path_to_output_folder_;
+
+    // The recorded sensor types
+    std::set<SensorSimulator::SensorType> recording_sensor_types_;
+
+    // Is noise enabled for the recorded sensors
+    bool recording_with_noise_;
+
+    // Sensor data is recorded every recording_stride_-th tick
+    unsigned int recording_stride_;
+
+    // The number of threads the simulations run on, 0 if all hardware threads
+    unsigned int num_threads_;
+
+    // The number of data sets per shard file
+    unsigned int data_sets_per_shard_;
+
+    // Are the text files written too
+    bool text_files_enabled_;
 };
 
 #endif // SENSORDATAGENERATOR_H
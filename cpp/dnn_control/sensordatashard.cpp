@@ -0,0 +1,110 @@
+#include "sensordatashard.h"
+
+#include <fstream>
+#include <cstring>
+
+const char SensorDataShard::kMagic[8] = {'S', 'D', 'S', 'H', 'A', 'R', 'D', '\0'};
+const boost::uint32_t SensorDataShard::kVersion;
+const unsigned int SensorDataShard::kFileHeaderSize;
+const unsigned int SensorDataShard::kDataSetHeaderSize;
+
+SensorDataShard::SensorDataShard(const unsigned int &num_data_sets)
+    : records_(num_data_sets), seeds_(num_data_sets, 0), rows_(num_data_sets, 0), dimensions_(num_data_sets, 0), slot_set_(num_data_sets, 0) {
+
+}
+
+void SensorDataShard::SetDataSet(const unsigned int &slot, const unsigned int &random_seed, const double &control_frequency, const double &data_set_time, const SystemState &initial_system_state, const std::vector<std::vector<double> > &sensor_data, const std::vector<Vector3D> &thrusts, const std::vector<Vector3D> &positions, const std::vector<Vector3D> &heights) {
+    const unsigned int num_rows = sensor_data.size();
+    if (thrusts.size() != num_rows || positions.size() != num_rows || heights.size() != num_rows) {
+        throw InconsistentDataSetException();
+    }
+
+    const unsigned int dimensions = (num_rows > 0 ? sensor_data.front().size() : 0);
+    for (unsigned int i = 0; i < num_rows; ++i) {
+        if (sensor_data[i].size() != dimensions) {
+            throw InconsistentDataSetException();
+        }
+    }
+
+    std::vector<double> &record = records_.at(slot);
+    record.assign(kDataSetHeaderSize / sizeof(double) + num_rows * (dimensions + 9), 0.0);
+
+    const boost::uint32_t header[4] = {random_seed, num_rows, dimensions, 0};
+    std::memcpy(&record[0], header, sizeof(header));
+    record[2] = control_frequency;
+    record[3] = data_set_time;
+    for (unsigned int i = 0; i < initial_system_state.size(); ++i) {
+        record[4 + i] = initial_system_state[i];
+    }
+
+    double *values = &record[kDataSetHeaderSize / sizeof(double)];
+    for (unsigned int i = 0; i < num_rows; ++i) {
+        for (unsigned int j = 0; j < dimensions; ++j) {
+            *values++ = sensor_data[i][j];
+        }
+    }
+    const std::vector<Vector3D> *blocks[3] = {&thrusts, &positions, &heights};
+    for (unsigned int b = 0; b < 3; ++b) {
+        for (unsigned int i = 0; i < num_rows; ++i) {
+            for (unsigned int j = 0; j < 3; ++j) {
+                *values++ = (*blocks[b])[i][j];
+            }
+        }
+    }
+
+    seeds_.at(slot) = random_seed;
+    rows_.at(slot) = num_rows;
+    dimensions_.at(slot) = dimensions;
+    slot_set_.at(slot) = 1;
+}
+
+void SensorDataShard::Write(const std::string &path_to_file) {
+    for (unsigned int i = 0; i < slot_set_.size(); ++i) {
+        if (!slot_set_[i]) {
+            throw SlotNotSetException();
+        }
+    }
+
+    std::ofstream file(path_to_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw FileNotWritableException();
+    }
+
+    const boost::uint32_t header[2] = {kVersion, static_cast<boost::uint32_t>(records_.size())};
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    for (unsigned int i = 0; i < records_.size(); ++i) {
+        std::vector<double> &record = records_[i];
+        file.write(reinterpret_cast<const char*>(&record[0]), record.size() * sizeof(double));
+        std::vector<double>().swap(record);
+    }
+
+    if (!file.good()) {
+        throw FileNotWritableException();
+    }
+}
+
+unsigned int SensorDataShard::NumDataSets() const {
+    return records_.size();
+}
+
+boost::uint64_t SensorDataShard::OffsetOfDataSet(const unsigned int &slot) const {
+    boost::uint64_t offset = kFileHeaderSize;
+    for (unsigned int i = 0; i < slot; ++i) {
+        offset += kDataSetHeaderSize + static_cast<boost::uint64_t>(rows_.at(i)) * (dimensions_.at(i) + 9) * sizeof(double);
+    }
+    return offset;
+}
+
+unsigned int SensorDataShard::RowsOfDataSet(const unsigned int &slot) const {
+    return rows_.at(slot);
+}
+
+unsigned int SensorDataShard::DimensionsOfDataSet(const unsigned int &slot) const {
+    return dimensions_.at(slot);
+}
+
+unsigned int SensorDataShard::SeedOfDataSet(const unsigned int &slot) const {
+    return seeds_.at(slot);
+}
@@ -0,0 +1,82 @@
+#ifndef SENSORDATASHARD_H
+#define SENSORDATASHARD_H
+
+#include "vector.h"
+#include "systemstate.h"
+
+#include <vector>
+#include <string>
+#include <boost/cstdint.hpp>
+
+class SensorDataShard {
+    /*
+    * This class represents one binary file holding several sensor data sets, as written by the SensorDataGenerator.
+    *
+    * All values are stored in native byte order, every double is 8 byte aligned within the file, so a reader can map the
+    * file and view the arrays without copying. The layout is:
+    *
+    *   file header (16 bytes):   char magic[8] = "SDSHARD", uint32 version, uint32 number of data sets
+    *   per data set:
+    *     header (88 bytes):      uint32 random seed, uint32 number of rows R, uint32 sensor dimensions D, uint32 0,
+    *                             double control frequency, double data set time, double initial system state[7]
+    *     double sensor_data[R][D]
+    *     double thrusts[R][3]
+    *     double positions[R][3]
+    *     double heights[R][3]
+    *
+    * Data sets are set into numbered slots by any thread (one thread per slot) and written in slot order.
+    */
+public:
+    // The magic bytes at the beginning of every shard file
+    const static char kMagic[8];
+
+    // The current format version
+    const static boost::uint32_t kVersion = 1;
+
+    // The size of the file header in bytes
+    const static unsigned int kFileHeaderSize = 16;
+
+    // The size of a data set header in bytes
+    const static unsigned int kDataSetHeaderSize = 88;
+
+    SensorDataShard(const unsigned int &num_data_sets);
+
+    // Serializes a data set into slot "slot". All vectors need one entry per row, all sensor data rows the same dimensions.
+    void SetDataSet(const unsigned int &slot, const unsigned int &random_seed, const double &control_frequency, const double &data_set_time, const SystemState &initial_system_state, const std::vector<std::vector<double> > &sensor_data, const std::vector<Vector3D> &thrusts, const std::vector<Vector3D> &positions, const std::vector<Vector3D> &heights);
+
+    // Writes all data sets to file "path_to_file" and releases their memory
+    void Write(const std::string &path_to_file);
+
+    // Returns the number of slots
+    unsigned int NumDataSets() const;
+
+    // Returns the byte offset of the header of data set "slot" within the file
+    boost::uint64_t OffsetOfDataSet(const unsigned int &slot) const;
+
+    // Returns the number of rows of data set "slot"
+    unsigned int RowsOfDataSet(const unsigned int &slot) const;
+
+    // Returns the sensor dimensions of data set "slot"
+    unsigned int DimensionsOfDataSet(const unsigned int &slot) const;
+
+    // Returns the random seed of data set "slot"
+    unsigned int SeedOfDataSet(const unsigned int &slot) const;
+
+    // SensorDataShard can throw the following exceptions
+    class Exception {};
+    class InconsistentDataSetException : public Exception {};
+    class SlotNotSetException : public Exception {};
+    class FileNotWritableException : public Exception {};
+
+private:
+    // The serialized data sets, header included
+    std::vector<std::vector<double> > records_;
+
+    // Per slot meta data
+    std::vector<unsigned int> seeds_;
+    std::vector<unsigned int> rows_;
+    std::vector<unsigned int> dimensions_;
+    std::vector<char> slot_set_;
+};
+
+#endif // SENSORDATASHARD_H
@@ -14,8 +14,15 @@ const std::map<SensorSimulator::SensorType, std::pair<unsigned int, double> > Se
 };
 
 SensorSimulator::SensorSimulator(SampleFactory &sample_factory, const Asteroid &asteroid)
-    : sample_factory_(sample_factory), asteroid_(asteroid) {
+    : noise_buffer_(sample_factory), asteroid_(asteroid) {
+    gravity_model_ = NULL;
     dimensions_ = 0;
+    height_norm_required_ = false;
+    acceleration_required_ = false;
+    noise_standard_deviations_.resize(SensorTypeConfigurations.size());
+    for (auto configuration : SensorTypeConfigurations) {
+        noise_standard_deviations_.at(configuration.first) = configuration.second.second;
+    }
 }
 
 unsigned int SensorSimulator::Dimensions() const {
@@ -24,8 +31,8 @@ unsigned int SensorSimulator::Dimensions() const {
 
 double SensorSimulator::AddNoise(const double &sensor_value, const SensorType &type) {
     if (noise_enabled_) {
-        const double &standard_deviation = SensorTypeConfigurations.at(type).second;
-        return sensor_value + sensor_value * sample_factory_.SampleNormal(0.0, standard_deviation);
+        const double &standard_deviation = noise_standard_deviations_[type];
+        return sensor_value + sensor_value * noise_buffer_.SampleNormal(0.0, standard_deviation);
     } else {
         return sensor_value;
     }
@@ -37,6 +44,7 @@ void SensorSimulator::SetSensorTypes(const std::set<SensorSimulator::SensorType>
     for (auto t : sensor_types_) {
         dimensions_ += SensorTypeConfigurations.at(t).first;
     }
+    CompilePipeline();
 }
 
 void SensorSimulator::SetNoiseEnabled(const bool &enable_noise) {
@@ -49,119 +57,153 @@ void SensorSimulator::SetTargetPosition(const Vector3D &target_position) {
 
 void SensorSimulator::SetSensorValueTransformations(const std::map<SensorSimulator::SensorType, std::vector<std::pair<double, double> > > &sensor_value_transformations) {
     sensor_value_transformations_ = sensor_value_transformations;
+    CompilePipeline();
+}
+
+void SensorSimulator::SetGravityModel(const GravityModel *gravity_model) {
+    gravity_model_ = gravity_model;
 }
 
 std::vector<double> SensorSimulator::Simulate(const SystemState &state, const Vector3D &height, const Vector3D &perturbations_acceleration, const double &time, const Vector3D &thrust) {
-    std::vector<double> sensor_data(dimensions_, 0.0);
-    unsigned int offset = 0;
+    std::vector<double> sensor_data;
+    Simulate(state, height, perturbations_acceleration, time, thrust, sensor_data);
+    return sensor_data;
+}
 
-    for (auto t : sensor_types_) {
-        if (t == RelativePosition) {
-            const Vector3D &position = {state[0], state[1], state[2]};
+void SensorSimulator::Simulate(const SystemState &state, const Vector3D &height, const Vector3D &perturbations_acceleration, const double &time, const Vector3D &thrust, std::vector<double> &sensor_data) {
+    PhysicsSnapshot snapshot(asteroid_);
+    snapshot.SetGravityModel(gravity_model_);
+    snapshot.Update(state, time, height);
+    Simulate(snapshot, perturbations_acceleration, thrust, sensor_data);
+}
+
+void SensorSimulator::Simulate(const PhysicsSnapshot &snapshot, const Vector3D &perturbations_acceleration, const Vector3D &thrust, std::vector<double> &sensor_data) {
+    sensor_data.resize(dimensions_);
+
+    const SystemState &state = snapshot.State();
+    const Vector3D &position = {state[0], state[1], state[2]};
+    const Vector3D &velocity = {state[3], state[4], state[5]};
+    const double &mass = state[6];
+
+    // shared by OpticalFlow and Height
+    Vector3D height = {0.0, 0.0, 0.0};
+    double norm_height = 0.0;
+    if (height_norm_required_) {
+        height = snapshot.Height();
+        norm_height = snapshot.HeightNorm();
+    }
+
+    // shared by ExternalAcceleration and TotalAcceleration
+    Vector3D acceleration = {0.0, 0.0, 0.0};
+    if (acceleration_required_) {
+        const Vector3D &gravity_acceleration = snapshot.GravityAcceleration();
+        const Vector3D &angular_velocity = snapshot.AngularVelocity();
+        const Vector3D &angular_acceleration = snapshot.AngularAcceleration();
+
+        const Vector3D &external_acceleration = {perturbations_acceleration[0] + gravity_acceleration[0],
+                                                 perturbations_acceleration[1] + gravity_acceleration[1],
+                                                 perturbations_acceleration[2] + gravity_acceleration[2]};
+        acceleration = VectorRotatingFrameAcceleration(external_acceleration, angular_velocity, angular_acceleration, position, velocity);
+    }
+
+    // the stages draw their noise in the configured order
+    const unsigned int num_stages = stage_types_.size();
+    for (unsigned int stage = 0; stage < num_stages; ++stage) {
+        const SensorType t = stage_types_[stage];
+        double *data = &sensor_data[stage_offsets_[stage]];
+
+        switch (t) {
+        case RelativePosition:
             for (unsigned int i = 0; i < 3; ++i) {
-                sensor_data[offset + i] = AddNoise(target_position_[i] - position[i], t);
-            }
-            if (sensor_value_transformations_.find(t) != sensor_value_transformations_.end()) {
-                const std::vector<std::pair<double, double> > &transformations = sensor_value_transformations_.at(t);
-                for (unsigned int i = 0; i < 3; ++i) {
-                    sensor_data[offset + i] = TransformValue(sensor_data[offset + i], transformations.at(i));
-                }
+                data[i] = AddNoise(target_position_[i] - position[i], t);
             }
+            break;
 
-        } else if (t == Velocity) {
-            const Vector3D &velocity = {state[3], state[4], state[5]};
+        case Velocity:
             for (unsigned int i = 0; i < 3; ++i) {
-                sensor_data[offset + i] = AddNoise(velocity[i], t);
-            }
-            if (sensor_value_transformations_.find(t) != sensor_value_transformations_.end()) {
-                const std::vector<std::pair<double, double> > &transformations = sensor_value_transformations_.at(t);
-                for (unsigned int i = 0; i < 3; ++i) {
-                    sensor_data[offset + i] = TransformValue(sensor_data[offset + i], transformations.at(i));
-                }
+                data[i] = AddNoise(velocity[i], t);
             }
+            break;
 
-        } else if (t == OpticalFlow) {
+        case OpticalFlow:
+        {
             const double up_scale = 1000000.0;
-            const Vector3D &velocity = {state[3], state[4], state[5]};
 
-            const double coef_norm_height = 1.0 / VectorNorm(height);
+            const double coef_norm_height = 1.0 / norm_height;
             const Vector3D normalized_height = VectorMul(coef_norm_height, height);
             const double magn_velocity_parallel = VectorDotProduct(velocity, normalized_height);
             const Vector3D velocity_parallel = VectorMul(magn_velocity_parallel, normalized_height);
             const Vector3D velocity_perpendicular = VectorSub(velocity, velocity_parallel);
 
             for (unsigned int i = 0; i < 3; ++i) {
-                sensor_data[offset + i] = AddNoise(up_scale * velocity_parallel[i] * coef_norm_height, t);
+                data[i] = AddNoise(up_scale * velocity_parallel[i] * coef_norm_height, t);
             }
             for (unsigned int i = 0; i < 3; ++i) {
-                sensor_data[offset + 3 + i] = AddNoise(up_scale * velocity_perpendicular[i] * coef_norm_height, t);
-            }
-
-            if (sensor_value_transformations_.find(t) != sensor_value_transformations_.end()) {
-                const std::vector<std::pair<double, double> > &transformations = sensor_value_transformations_.at(t);
-                for (unsigned int i = 0; i < 6; ++i) {
-                    sensor_data[offset + i] = TransformValue(sensor_data[offset + i], transformations.at(i));
-                }
+                data[3 + i] = AddNoise(up_scale * velocity_perpendicular[i] * coef_norm_height, t);
             }
+        }
+            break;
 
-        } else if (t == ExternalAcceleration || t == TotalAcceleration) {
+        case ExternalAcceleration:
+        case TotalAcceleration:
+        {
             const double up_scale = 1.0;
-            const Vector3D &position = {state[0], state[1], state[2]};
-            const Vector3D &velocity = {state[3], state[4], state[5]};
-            const double &mass = state[6];
-
-            const Vector3D gravity_acceleration = asteroid_.GravityAccelerationAtPosition(position);
-
-            const boost::tuple<Vector3D, Vector3D> result_angular = asteroid_.AngularVelocityAndAccelerationAtTime(time);
-            const Vector3D &angular_velocity = boost::get<0>(result_angular);
-            const Vector3D &angular_acceleration = boost::get<1>(result_angular);
-
-            const Vector3D euler_acceleration = VectorCrossProduct(angular_acceleration, position);
-            const Vector3D centrifugal_acceleration = VectorCrossProduct(angular_velocity, VectorCrossProduct(angular_velocity, position));
-
-            const Vector3D coriolis_acceleration = VectorCrossProduct(VectorMul(2.0, angular_velocity), velocity);
-
             for (unsigned int i = 0; i < 3; ++i) {
-                double sensor_value = perturbations_acceleration[i]
-                        + gravity_acceleration[i]
-                        - coriolis_acceleration[i]
-                        - euler_acceleration[i]
-                        - centrifugal_acceleration[i];
+                double sensor_value = acceleration[i];
 
                 if (t == TotalAcceleration) {
                     sensor_value += thrust[i] / mass;
                 }
 
-                sensor_data[offset + i] = up_scale * AddNoise(sensor_value, t);
+                data[i] = up_scale * AddNoise(sensor_value, t);
             }
+        }
+            break;
 
-            if (sensor_value_transformations_.find(t) != sensor_value_transformations_.end()) {
-                const std::vector<std::pair<double, double> > &transformations = sensor_value_transformations_.at(t);
-                for (unsigned int i = 0; i < 3; ++i) {
-                    sensor_data[offset + i] = TransformValue(sensor_data[offset + i], transformations.at(i));
-                }
-            }
+        case Height:
+            data[0] = AddNoise(norm_height, t);
+            break;
 
-        } else if (t == Height) {
-            sensor_data[offset] = AddNoise(VectorNorm(height), t);
-            if (sensor_value_transformations_.find(t) != sensor_value_transformations_.end()) {
-                const std::vector<std::pair<double, double> > &transformations = sensor_value_transformations_.at(t);
-                sensor_data[offset] = TransformValue(sensor_data[offset], transformations.at(0));
-            }
+        case Mass:
+            data[0] = AddNoise(mass, t);
+            break;
+        }
+    }
+
+    for (unsigned int i = 0; i < dimensions_; ++i) {
+        if (dimension_transformed_[i]) {
+            sensor_data[i] = TransformValue(sensor_data[i], dimension_transformations_[i]);
+        }
+    }
+}
+
+void SensorSimulator::CompilePipeline() {
+    stage_types_.clear();
+    stage_offsets_.clear();
+    dimension_transformed_.assign(dimensions_, 0);
+    dimension_transformations_.assign(dimensions_, std::make_pair(0.0, 1.0));
+    height_norm_required_ = false;
+    acceleration_required_ = false;
 
-        } else if (t == Mass) {
-            const double &mass = state[6];
-            sensor_data[offset] = AddNoise(mass, t);
-            if (sensor_value_transformations_.find(t) != sensor_value_transformations_.end()) {
-                const std::vector<std::pair<double, double> > &transformations = sensor_value_transformations_.at(t);
-                sensor_data[offset] = TransformValue(sensor_data[offset], transformations.at(0));
+    unsigned int offset = 0;
+    for (auto t : sensor_types_) {
+        const unsigned int dimensions = SensorTypeConfigurations.at(t).first;
+        stage_types_.push_back(t);
+        stage_offsets_.push_back(offset);
+
+        if (sensor_value_transformations_.find(t) != sensor_value_transformations_.end()) {
+            const std::vector<std::pair<double, double> > &transformations = sensor_value_transformations_.at(t);
+            for (unsigned int i = 0; i < dimensions; ++i) {
+                dimension_transformed_.at(offset + i) = 1;
+                dimension_transformations_.at(offset + i) = transformations.at(i);
             }
         }
 
-        offset += SensorTypeConfigurations.at(t).first;
-    }
+        height_norm_required_ = height_norm_required_ || t == OpticalFlow || t == Height;
+        acceleration_required_ = acceleration_required_ || t == ExternalAcceleration || t == TotalAcceleration;
 
-    return sensor_data;
+        offset += dimensions;
+    }
 }
 
 double SensorSimulator::TransformValue(const double &sensor_value, const std::pair<double, double> &transformation_params) {
@@ -4,6 +4,8 @@
 #include "asteroid.h"
 #include "systemstate.h"
 #include "samplefactory.h"
+#include "noisebuffer.h"
+#include "physicssnapshot.h"
 
 #include <vector>
 #include <set>
@@ -12,6 +14,10 @@
 class SensorSimulator {
     /*
      * This class generates the artificial sensor data for a controller.
+     *
+     * The configured sensor types and value transformations are compiled into flat per stage and per dimension arrays,
+     * so Simulate only walks these arrays. Terms several sensors share (height norm, gravity and rotating frame
+     * acceleration) are computed once per call and, given a PhysicsSnapshot, once per tick for all simulators.
      */
 public:
     // The number of output types the sensor simulator can generate
@@ -45,10 +51,21 @@ public:
     // If sensor data needs to be normalized, specify normalization parameters here
     void SetSensorValueTransformations(const std::map<SensorType, std::vector<std::pair<double, double> > > &sensor_value_transformations);
 
+    // Replace the asteroid's gravity for the state based Simulate, pass NULL for the asteroid's own. Snapshots passed to
+    // Simulate carry their own models.
+    void SetGravityModel(const GravityModel *gravity_model);
+
 
     // Generates (simulates) sensor data based on the current spacecraft state "state" and time "time"
     virtual std::vector<double> Simulate(const SystemState &state, const Vector3D &height, const Vector3D &perturbations_acceleration, const double &time, const Vector3D &thrust);
 
+    // Generates (simulates) sensor data into "sensor_data", which gets resized to Dimensions()
+    void Simulate(const SystemState &state, const Vector3D &height, const Vector3D &perturbations_acceleration, const double &time, const Vector3D &thrust, std::vector<double> &sensor_data);
+
+    // Generates (simulates) sensor data into "sensor_data" from the physics of the current tick "snapshot". Height, gravity and
+    // angular velocity are taken from the snapshot, so several simulators fed the same snapshot evaluate them only once.
+    void Simulate(const PhysicsSnapshot &snapshot, const Vector3D &perturbations_acceleration, const Vector3D &thrust, std::vector<double> &sensor_data);
+
     // The number of sensor data dimensions produced by the SensorSimulator
     unsigned int Dimensions() const;
 
@@ -57,6 +74,9 @@ public:
 
 
 protected:
+    // Builds the stage and transformation arrays from sensor_types_ and sensor_value_transformations_
+    void CompilePipeline();
+
     // Normalizes sensor data
     static double TransformValue(const double &sensor_value, const std::pair<double, double> &transformation_params);
 
@@ -66,12 +86,18 @@ protected:
     // How large is the sensor data space
     unsigned int dimensions_;
 
-    // The underlying random sample factory
-    SampleFactory &sample_factory_;
+    // The noise drawn from the underlying random sample factory
+    NoiseBuffer noise_buffer_;
+
+    // Noise standard deviation per sensor type, avoids the SensorTypeConfigurations lookup per value
+    std::vector<double> noise_standard_deviations_;
 
     // The system's asteroid
     const Asteroid &asteroid_;
 
+    // The gravity used by the state based Simulate, NULL for the asteroid's
+    const GravityModel *gravity_model_;
+
     // The active sensor types
     std::set<SensorType> sensor_types_;
 
@@ -83,6 +109,18 @@ protected:
 
     // Transform sensor variables. Allow two parameters
     std::map<SensorType, std::vector<std::pair<double, double> > > sensor_value_transformations_;
+
+    // The compiled pipeline: sensor type and first output dimension per stage, in sensor_types_ order
+    std::vector<SensorType> stage_types_;
+    std::vector<unsigned int> stage_offsets_;
+
+    // The compiled transformations per output dimension
+    std::vector<char> dimension_transformed_;
+    std::vector<std::pair<double, double> > dimension_transformations_;
+
+    // Which shared terms the compiled stages need
+    bool height_norm_required_;
+    bool acceleration_required_;
 };
 
 #endif // SENSORSIMULATOR_H
@@ -0,0 +1,213 @@
+#include "sensorstream.h"
+#include "sensordatashard.h"
+
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+// Parses the comma separated values of the null terminated string "text" and appends them to "values", returns their number
+static unsigned int ParseValues(const char *text, std::vector<double> &values) {
+    unsigned int num_values = 0;
+    const char *cursor = text;
+    while (true) {
+        while (isspace(*cursor) || *cursor == ',') {
+            ++cursor;
+        }
+        if (*cursor == '\0') {
+            break;
+        }
+
+        char *next = NULL;
+        const double value = strtod(cursor, &next);
+        if (next == cursor) {
+            throw SensorStream::InvalidFileFormatException();
+        }
+        values.push_back(value);
+        ++num_values;
+        cursor = next;
+    }
+    return num_values;
+}
+
+SensorStream::SensorStream()
+    : sensor_data_(NULL), thrusts_(NULL), num_rows_(0), dimensions_(0) {
+
+}
+
+boost::shared_ptr<SensorStream> SensorStream::FromTextFile(const std::string &path_to_file, const unsigned int &num_lines) {
+    boost::shared_ptr<SensorStream> stream(new SensorStream());
+
+    std::ifstream probe(path_to_file.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!probe.is_open()) {
+        throw FileNotReadableException();
+    }
+    if (probe.tellg() == 0) {
+        // empty files can not be mapped
+        return stream;
+    }
+    probe.close();
+
+    try {
+        stream->file_.open(path_to_file);
+    } catch (const std::exception &exception) {
+        throw FileNotReadableException();
+    }
+
+    const char *cursor = stream->file_.data();
+    const char *end = cursor + stream->file_.size();
+    std::string line;
+    bool first_row = true;
+    while (cursor < end && (num_lines == 0 || stream->num_rows_ < num_lines)) {
+        const char *line_end = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+        if (line_end == NULL) {
+            line_end = end;
+        }
+
+        if (line_end > cursor && *cursor != '#') {
+            // a line is "sensor values | thrust values", the copy is null terminated for strtod
+            line.assign(cursor, line_end);
+            const std::string::size_type separator = line.find('|');
+            if (separator == std::string::npos) {
+                throw InvalidFileFormatException();
+            }
+            line[separator] = '\0';
+
+            const unsigned int dimensions = ParseValues(line.c_str(), stream->parsed_sensor_data_);
+            const unsigned int num_thrusts = ParseValues(line.c_str() + separator + 1, stream->parsed_thrusts_);
+            if (first_row) {
+                stream->dimensions_ = dimensions;
+                first_row = false;
+            }
+            if (dimensions != stream->dimensions_ || num_thrusts != 3) {
+                throw InvalidFileFormatException();
+            }
+            ++stream->num_rows_;
+        }
+
+        cursor = line_end + 1;
+    }
+
+    // the values are parsed, the text is not needed anymore
+    stream->file_.close();
+
+    stream->sensor_data_ = (stream->parsed_sensor_data_.size() ? &stream->parsed_sensor_data_[0] : NULL);
+    stream->thrusts_ = (stream->parsed_thrusts_.size() ? &stream->parsed_thrusts_[0] : NULL);
+
+    return stream;
+}
+
+boost::shared_ptr<SensorStream> SensorStream::FromShardFile(const std::string &path_to_file, const boost::uint64_t &offset) {
+    boost::shared_ptr<SensorStream> stream(new SensorStream());
+
+    try {
+        stream->file_.open(path_to_file);
+    } catch (const std::exception &exception) {
+        throw FileNotReadableException();
+    }
+
+    const char *data = stream->file_.data();
+    const boost::uint64_t size = stream->file_.size();
+    if (size < SensorDataShard::kFileHeaderSize || std::memcmp(data, SensorDataShard::kMagic, sizeof(SensorDataShard::kMagic)) != 0) {
+        throw InvalidFileFormatException();
+    }
+
+    boost::uint32_t file_header[2];
+    std::memcpy(file_header, data + sizeof(SensorDataShard::kMagic), sizeof(file_header));
+    if (file_header[0] != SensorDataShard::kVersion) {
+        throw InvalidFileFormatException();
+    }
+
+    if (offset % sizeof(double) != 0 || offset + SensorDataShard::kDataSetHeaderSize > size) {
+        throw InvalidFileFormatException();
+    }
+    boost::uint32_t header[4];
+    std::memcpy(header, data + offset, sizeof(header));
+    stream->num_rows_ = header[1];
+    stream->dimensions_ = header[2];
+
+    const boost::uint64_t begin = offset + SensorDataShard::kDataSetHeaderSize;
+    const boost::uint64_t num_sensor_values = static_cast<boost::uint64_t>(stream->num_rows_) * stream->dimensions_;
+    if (begin + (num_sensor_values + 3 * static_cast<boost::uint64_t>(stream->num_rows_)) * sizeof(double) > size) {
+        throw InvalidFileFormatException();
+    }
+
+    // mappings are page aligned, hence the 8 byte aligned offsets are aligned for doubles
+    stream->sensor_data_ = reinterpret_cast<const double*>(data + begin);
+    stream->thrusts_ = stream->sensor_data_ + num_sensor_values;
+
+    return stream;
+}
+
+unsigned int SensorStream::NumRows() const {
+    return num_rows_;
+}
+
+unsigned int SensorStream::Dimensions() const {
+    return dimensions_;
+}
+
+unsigned int SensorStream::Columns() const {
+    return dimensions_ + 3;
+}
+
+const double* SensorStream::SensorData() const {
+    return sensor_data_;
+}
+
+const double* SensorStream::Thrusts() const {
+    return thrusts_;
+}
+
+unsigned int SensorStream::NumWindows(const unsigned int &sequence_length, const unsigned int &stride) const {
+    if (stride == 0) {
+        throw InvalidStrideException();
+    }
+    if (num_rows_ <= sequence_length) {
+        return 0;
+    }
+    return (num_rows_ - sequence_length - 1) / stride + 1;
+}
+
+void SensorStream::MaterializeWindows(const unsigned int &sequence_length, const std::vector<unsigned int> &feature_columns, const std::vector<unsigned int> &label_columns, const unsigned int &stride, double *features, double *labels) const {
+    const unsigned int num_windows = NumWindows(sequence_length, stride);
+    const unsigned int columns = Columns();
+
+    // every column is a base pointer and a row stride into one of the two arrays
+    const unsigned int num_feature_columns = feature_columns.size();
+    const unsigned int num_label_columns = label_columns.size();
+    std::vector<const double*> column_bases(num_feature_columns + num_label_columns);
+    std::vector<unsigned int> column_strides(num_feature_columns + num_label_columns);
+    for (unsigned int i = 0; i < column_bases.size(); ++i) {
+        const unsigned int &column = (i < num_feature_columns ? feature_columns[i] : label_columns[i - num_feature_columns]);
+        if (column >= columns) {
+            throw InvalidColumnException();
+        }
+        if (column < dimensions_) {
+            column_bases[i] = sensor_data_ + column;
+            column_strides[i] = dimensions_;
+        } else {
+            column_bases[i] = thrusts_ + (column - dimensions_);
+            column_strides[i] = 3;
+        }
+    }
+
+    const unsigned int window_size = sequence_length * num_feature_columns;
+    for (unsigned int window = 0; window < num_windows; ++window) {
+        const unsigned int first_row = window * stride;
+
+        double *feature_row = features + static_cast<boost::uint64_t>(window) * window_size;
+        for (unsigned int j = 0; j < sequence_length; ++j) {
+            const unsigned int row = first_row + j;
+            for (unsigned int k = 0; k < num_feature_columns; ++k) {
+                *feature_row++ = column_bases[k][static_cast<boost::uint64_t>(row) * column_strides[k]];
+            }
+        }
+
+        double *label_row = labels + static_cast<boost::uint64_t>(window) * num_label_columns;
+        const unsigned int row = first_row + sequence_length;
+        for (unsigned int k = 0; k < num_label_columns; ++k) {
+            label_row[k] = column_bases[num_feature_columns + k][static_cast<boost::uint64_t>(row) * column_strides[num_feature_columns + k]];
+        }
+    }
+}
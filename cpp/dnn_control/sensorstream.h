@@ -0,0 +1,80 @@
+#ifndef SENSORSTREAM_H
+#define SENSORSTREAM_H
+
+#include <vector>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+class SensorStream {
+    /*
+    * This class represents one recorded sensor stream: per tick the sensor data and the thrust taken, i.e. a row of
+    * Dimensions() sensor values followed by 3 thrust values (Columns() in total), as in the files written by
+    * FileWriter::CreateSensorDataFile.
+    *
+    * Text files are memory mapped and parsed in a single pass into two contiguous row major arrays. Data sets of a
+    * SensorDataShard are used in place: the shard file stays mapped and SensorData() and Thrusts() point into it.
+    *
+    * MaterializeWindows builds the sliding window design matrix and labels (as data_loader.sliding_window does) directly
+    * into caller provided buffers, e.g. the memory of NumPy arrays.
+    */
+public:
+    // Loads the first "num_lines" rows (0 for all) of text file "path_to_file"
+    static boost::shared_ptr<SensorStream> FromTextFile(const std::string &path_to_file, const unsigned int &num_lines=0);
+
+    // Maps the data set starting at byte "offset" (as listed in the manifest) of shard file "path_to_file"
+    static boost::shared_ptr<SensorStream> FromShardFile(const std::string &path_to_file, const boost::uint64_t &offset);
+
+    // The number of rows (ticks)
+    unsigned int NumRows() const;
+
+    // The number of sensor values per row
+    unsigned int Dimensions() const;
+
+    // Dimensions() + 3 thrust values
+    unsigned int Columns() const;
+
+    // Row major sensor data [NumRows()][Dimensions()]
+    const double* SensorData() const;
+
+    // Row major thrusts [NumRows()][3]
+    const double* Thrusts() const;
+
+    // The number of windows of "sequence_length" rows plus one label row, starting every "stride" rows
+    unsigned int NumWindows(const unsigned int &sequence_length, const unsigned int &stride=1) const;
+
+    // Window w starts at row i = w * stride. Writes the columns "feature_columns" of rows i, ..., i + sequence_length - 1
+    // to features[w][sequence_length * feature_columns.size()] and the columns "label_columns" of row i + sequence_length
+    // to labels[w][label_columns.size()], for all windows w < NumWindows(sequence_length, stride).
+    void MaterializeWindows(const unsigned int &sequence_length, const std::vector<unsigned int> &feature_columns, const std::vector<unsigned int> &label_columns, const unsigned int &stride, double *features, double *labels) const;
+
+    // SensorStream can throw the following exceptions
+    class Exception {};
+    class FileNotReadableException : public Exception {};
+    class InvalidFileFormatException : public Exception {};
+    class InvalidColumnException : public Exception {};
+    class InvalidStrideException : public Exception {};
+
+private:
+    SensorStream();
+    SensorStream(const SensorStream &other);
+    SensorStream& operator=(const SensorStream &other);
+
+    // The mapped file, if any
+    boost::iostreams::mapped_file_source file_;
+
+    // The parsed values of a text file
+    std::vector<double> parsed_sensor_data_;
+    std::vector<double> parsed_thrusts_;
+
+    // The arrays, pointing into file_ or the parsed values
+    const double *sensor_data_;
+    const double *thrusts_;
+
+    // The stream's size
+    unsigned int num_rows_;
+    unsigned int dimensions_;
+};
+
+#endif // SENSORSTREAM_H
@@ -0,0 +1,9 @@
+#include "shapemodel.h"
+
+ShapeModel::~ShapeModel() {
+
+}
+
+boost::tuple<Vector3D, double> ShapeModel::NearestPointOnSurfaceToPositionWithHint(const Vector3D &position, unsigned int &hint) const {
+    return NearestPointOnSurfaceToPosition(position);
+}
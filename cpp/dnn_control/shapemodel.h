@@ -0,0 +1,27 @@
+#ifndef SHAPEMODEL_H
+#define SHAPEMODEL_H
+
+#include "vector.h"
+
+#include <boost/tuple/tuple.hpp>
+
+class ShapeModel {
+    /*
+    * This abstract class represents the surface of an asteroid in its body fixed RF.
+    */
+public:
+    virtual ~ShapeModel();
+
+    // Computes the distance "distance" and orthogonal projection of a position "position" outside the asteroid onto the asteroid's surface "point"
+    virtual boost::tuple<Vector3D, double> NearestPointOnSurfaceToPosition(const Vector3D &position) const = 0;
+
+    // Same as NearestPointOnSurfaceToPosition for consecutive positions of one trajectory. "hint" is an opaque surface element
+    // which is used as a starting guess and updated to the result's element, it has to be 0 for the first query.
+    // The default ignores the hint.
+    virtual boost::tuple<Vector3D, double> NearestPointOnSurfaceToPositionWithHint(const Vector3D &position, unsigned int &hint) const;
+
+    // Returns true if position "position" is inside the asteroid
+    virtual bool PositionIsInside(const Vector3D &position) const = 0;
+};
+
+#endif // SHAPEMODEL_H
@@ -0,0 +1,217 @@
+#include "sparselstdq.h"
+
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+// Marks samples without a greedy next action yet
+static const unsigned int kNoAction = std::numeric_limits<unsigned int>::max();
+
+const unsigned int SparseLSTDQ::kBlockSize;
+const double SparseLSTDQ::kTolerance = 1e-12;
+
+SparseLSTDQ::SparseLSTDQ(ThreadPool &thread_pool, const ActionBlockBasis &basis, const LSPISampleSet &samples, const double &gamma, const double &ridge, const Solver &solver)
+    : thread_pool_(thread_pool), basis_(basis), samples_(samples), gamma_(gamma), ridge_(ridge), solver_(solver), statistics_() {
+
+    if (samples_.StateDimension() != basis_.StateBasis().StateDimension() || ridge_ < 0.0) {
+        throw InvalidParameterException();
+    }
+
+    const unsigned int num_samples = samples_.Size();
+    std::vector<unsigned int> actions(num_samples);
+    Eigen::VectorXd rewards(num_samples);
+    for (unsigned int i = 0; i < num_samples; ++i) {
+        actions[i] = samples_.Action(i);
+        if (actions[i] >= basis_.NumActions()) {
+            throw InvalidParameterException();
+        }
+        rewards(i) = samples_.Reward(i);
+    }
+
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> indices;
+    std::vector<double> values;
+    ComputeStateFeatures(false, offsets, indices, values);
+
+    // the features which are nonzero for some sample, numbered in ascending order
+    const unsigned int num_state_features = basis_.StateBasis().NumFeatures();
+    active_index_ = std::vector<int>(basis_.NumFeatures(), -1);
+    for (unsigned int i = 0; i < num_samples; ++i) {
+        for (unsigned int k = offsets[i]; k < offsets[i + 1]; ++k) {
+            active_index_[actions[i] * num_state_features + indices[k]] = 0;
+        }
+    }
+    for (unsigned int j = 0; j < active_index_.size(); ++j) {
+        if (active_index_[j] == 0) {
+            active_index_[j] = active_features_.size();
+            active_features_.push_back(j);
+        }
+    }
+
+    phi_ = Features(actions, offsets, indices, values);
+    vector_b_ = phi_.transpose() * rewards;
+
+    ComputeStateFeatures(true, next_offsets_, next_indices_, next_values_);
+    next_actions_ = std::vector<unsigned int>(num_samples, kNoAction);
+}
+
+Eigen::VectorXd SparseLSTDQ::Solve(SampleFactory &sample_factory, const Eigen::VectorXd &weights) {
+    if (weights.size() != basis_.NumFeatures()) {
+        throw InvalidParameterException();
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    statistics_ = LSTDQStatistics();
+    const unsigned int seed = sample_factory.SampleRandomNatural();
+    const unsigned int num_samples = samples_.Size();
+    const unsigned int num_blocks = (num_samples + kBlockSize - 1) / kBlockSize;
+    std::vector<Eigen::VectorXd> q_values(thread_pool_.NumThreads());
+    std::vector<unsigned int> num_changed_actions(num_blocks, 0);
+
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &thread_index) {
+        SampleFactory block_sample_factory(seed, block);
+        const unsigned int end_index = std::min(num_samples, (block + 1) * kBlockSize);
+        for (unsigned int i = block * kBlockSize; i < end_index; ++i) {
+            const unsigned int begin = next_offsets_[i];
+            basis_.QValues(next_indices_.data() + begin, next_values_.data() + begin, next_offsets_[i + 1] - begin, weights, q_values[thread_index]);
+            const unsigned int a_prime = ActionBlockBasis::Greedy(block_sample_factory, q_values[thread_index]);
+            if (a_prime != next_actions_[i]) {
+                next_actions_[i] = a_prime;
+                num_changed_actions[block]++;
+            }
+        }
+    });
+
+    for (unsigned int block = 0; block < num_blocks; ++block) {
+        statistics_.num_changed_actions += num_changed_actions[block];
+    }
+    const std::chrono::steady_clock::time_point policy_end = std::chrono::steady_clock::now();
+    statistics_.policy_time = std::chrono::duration<double>(policy_end - start).count();
+    if (statistics_.num_changed_actions == 0 && solution_.size() > 0) {
+        return solution_;
+    }
+
+    // the rows of A of inactive features are ridge e_j^T with b_j = 0, their weights are 0 and their columns drop out
+    const RowMajorMatrix phi_prime = Features(next_actions_, next_offsets_, next_indices_, next_values_);
+    const RowMajorMatrix phi_difference = phi_ - gamma_ * phi_prime;
+    Eigen::SparseMatrix<double> matrix_A = phi_.transpose() * phi_difference;
+    Eigen::SparseMatrix<double> ridge(matrix_A.rows(), matrix_A.cols());
+    ridge.setIdentity();
+    matrix_A += ridge_ * ridge;
+    matrix_A.makeCompressed();
+    statistics_.num_non_zeros = matrix_A.nonZeros();
+    const std::chrono::steady_clock::time_point accumulation_end = std::chrono::steady_clock::now();
+    statistics_.accumulation_time = std::chrono::duration<double>(accumulation_end - policy_end).count();
+
+    bool solved = false;
+    if (solver_ == BiCGSTABSolver) {
+        Eigen::BiCGSTAB<Eigen::SparseMatrix<double>, Eigen::IncompleteLUT<double> > iterative_solver;
+        iterative_solver.setTolerance(kTolerance);
+        iterative_solver.compute(matrix_A);
+        Eigen::VectorXd guess = active_solution_;
+        if (guess.size() == 0) {
+            guess.resize(active_features_.size());
+            for (unsigned int j = 0; j < active_features_.size(); ++j) {
+                guess(j) = weights(active_features_[j]);
+            }
+        }
+        const Eigen::VectorXd solution = iterative_solver.solveWithGuess(vector_b_, guess);
+        statistics_.solver_iterations = iterative_solver.iterations();
+        statistics_.solver_error = iterative_solver.error();
+        if (iterative_solver.info() == Eigen::Success && solution.allFinite()) {
+            active_solution_ = solution;
+            solved = true;
+        }
+    }
+
+    // an unconverged iterate is never returned, BiCGSTAB falls back to the factorization
+    if (!solved) {
+        Eigen::SparseLU<Eigen::SparseMatrix<double> > decomposition;
+        decomposition.compute(matrix_A);
+        if (decomposition.info() != Eigen::Success) {
+            throw SolverFailedException();
+        }
+        active_solution_ = decomposition.solve(vector_b_);
+        if (decomposition.info() != Eigen::Success || !active_solution_.allFinite()) {
+            throw SolverFailedException();
+        }
+    }
+    const double norm_b = vector_b_.norm();
+    statistics_.residual = (matrix_A * active_solution_ - vector_b_).norm() / (norm_b > 0.0 ? norm_b : 1.0);
+    statistics_.solve_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - accumulation_end).count();
+
+    solution_ = Eigen::VectorXd::Zero(basis_.NumFeatures());
+    for (unsigned int j = 0; j < active_features_.size(); ++j) {
+        solution_(active_features_[j]) = active_solution_(j);
+    }
+
+    return solution_;
+}
+
+const LSTDQStatistics& SparseLSTDQ::Statistics() const {
+    return statistics_;
+}
+
+void SparseLSTDQ::ComputeStateFeatures(const bool &next, std::vector<unsigned int> &offsets, std::vector<unsigned int> &indices, std::vector<double> &values) const {
+    const unsigned int num_samples = samples_.Size();
+    const unsigned int num_blocks = (num_samples + kBlockSize - 1) / kBlockSize;
+    const unsigned int state_dimension = samples_.StateDimension();
+
+    std::vector<std::vector<unsigned int> > block_sizes(num_blocks);
+    std::vector<std::vector<unsigned int> > block_indices(num_blocks);
+    std::vector<std::vector<double> > block_values(num_blocks);
+    thread_pool_.ParallelFor(num_blocks, [&](const unsigned int &block, const unsigned int &) {
+        std::vector<double> state(state_dimension);
+        std::vector<unsigned int> state_indices;
+        std::vector<double> state_values;
+        const unsigned int end_index = std::min(num_samples, (block + 1) * kBlockSize);
+        for (unsigned int i = block * kBlockSize; i < end_index; ++i) {
+            const float *stored_state = (next ? samples_.NextState(i) : samples_.State(i));
+            for (unsigned int k = 0; k < state_dimension; ++k) {
+                state[k] = stored_state[k];
+            }
+            basis_.StateBasis().Features(state.data(), state_indices, state_values);
+            block_sizes[block].push_back(state_indices.size());
+            block_indices[block].insert(block_indices[block].end(), state_indices.begin(), state_indices.end());
+            block_values[block].insert(block_values[block].end(), state_values.begin(), state_values.end());
+        }
+    });
+
+    offsets.assign(1, 0);
+    indices.clear();
+    values.clear();
+    for (unsigned int block = 0; block < num_blocks; ++block) {
+        for (unsigned int k = 0; k < block_sizes[block].size(); ++k) {
+            offsets.push_back(offsets.back() + block_sizes[block][k]);
+        }
+        indices.insert(indices.end(), block_indices[block].begin(), block_indices[block].end());
+        values.insert(values.end(), block_values[block].begin(), block_values[block].end());
+        std::vector<unsigned int>().swap(block_indices[block]);
+        std::vector<double>().swap(block_values[block]);
+    }
+}
+
+SparseLSTDQ::RowMajorMatrix SparseLSTDQ::Features(const std::vector<unsigned int> &actions, const std::vector<unsigned int> &offsets, const std::vector<unsigned int> &indices, const std::vector<double> &values) const {
+    const unsigned int num_samples = actions.size();
+    const unsigned int num_state_features = basis_.StateBasis().NumFeatures();
+
+    // the state features and their active indices are ascending, so every row is filled in order
+    RowMajorMatrix features(num_samples, active_features_.size());
+    Eigen::VectorXi row_sizes(num_samples);
+    for (unsigned int i = 0; i < num_samples; ++i) {
+        row_sizes(i) = offsets[i + 1] - offsets[i];
+    }
+    features.reserve(row_sizes);
+    for (unsigned int i = 0; i < num_samples; ++i) {
+        const unsigned int block_offset = actions[i] * num_state_features;
+        for (unsigned int k = offsets[i]; k < offsets[i + 1]; ++k) {
+            const int column = active_index_[block_offset + indices[k]];
+            if (column >= 0) {
+                features.insert(i, column) = values[k];
+            }
+        }
+    }
+    features.makeCompressed();
+
+    return features;
+}
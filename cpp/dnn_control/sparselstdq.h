@@ -0,0 +1,102 @@
+#ifndef SPARSELSTDQ_H
+#define SPARSELSTDQ_H
+
+#include "actionblockbasis.h"
+#include "lspisampleset.h"
+#include "lstdqstatistics.h"
+#include "samplefactory.h"
+#include "threadpool.h"
+
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include <eigen3/Eigen/Sparse>
+
+class SparseLSTDQ {
+    /*
+    * This class solves LSTDQ repeatedly on a fixed set of samples with the sparse features of an ActionBlockBasis.
+    *
+    * The samples' features Phi (one row per sample), b = Phi^T r and the state features of the next states are computed
+    * once. Per call the greedy next actions are chosen on a thread pool, block i of kBlockSize samples breaking ties with
+    * Philox stream i, and A = Phi^T (Phi - gamma Phi') + ridge I is formed as a sparse product, so memory and time scale
+    * with the nonzeros of the visited action pairs instead of NumFeatures()^2.
+    *
+    * Only the features which are nonzero for some sample's state and action enter the system. With the ridge the other
+    * rows of A are ridge e_j^T with b_j = 0, so their weights are exactly 0 and the system of the active features is
+    * solved alone, e.g. the blocks of actions which no sample took are left out.
+    *
+    * A is solved with BiCGSTAB and an incomplete LU preconditioner, started from the previous solution, or with a sparse
+    * LU factorization. If BiCGSTAB does not reach kTolerance within its iterations, A is factorized by sparse LU instead,
+    * so the solution is never an unconverged iterate. If no greedy next action changed, the previous solution is returned.
+    */
+public:
+    // The solvers of the sparse system
+    enum Solver {
+        BiCGSTABSolver,
+        SparseLUSolver
+    };
+
+    // The number of samples whose next actions are chosen with one random stream
+    const static unsigned int kBlockSize = 1024;
+
+    // The relative residual BiCGSTAB has to reach
+    const static double kTolerance;
+
+    SparseLSTDQ(ThreadPool &thread_pool, const ActionBlockBasis &basis, const LSPISampleSet &samples, const double &gamma, const double &ridge=1e-6, const Solver &solver=BiCGSTABSolver);
+
+    // Returns the weights of the Q function of the greedy policy of weights "weights"
+    Eigen::VectorXd Solve(SampleFactory &sample_factory, const Eigen::VectorXd &weights);
+
+    // The statistics of the last call of Solve
+    const LSTDQStatistics& Statistics() const;
+
+    // SparseLSTDQ can throw the following exceptions
+    class Exception {};
+    class InvalidParameterException : public Exception {};
+    class SolverFailedException : public Exception {};
+
+private:
+    typedef Eigen::SparseMatrix<double, Eigen::RowMajor> RowMajorMatrix;
+
+    // Computes the state features of all states (or next states if "next") into "offsets", "indices" and "values", sample i's
+    // features are [offsets[i], offsets[i + 1])
+    void ComputeStateFeatures(const bool &next, std::vector<unsigned int> &offsets, std::vector<unsigned int> &indices, std::vector<double> &values) const;
+
+    // Returns the active features of all samples with the actions "actions", using the state features "offsets", "indices" and "values"
+    RowMajorMatrix Features(const std::vector<unsigned int> &actions, const std::vector<unsigned int> &offsets, const std::vector<unsigned int> &indices, const std::vector<double> &values) const;
+
+    ThreadPool &thread_pool_;
+
+    const ActionBlockBasis &basis_;
+
+    const LSPISampleSet &samples_;
+
+    double gamma_;
+
+    double ridge_;
+
+    Solver solver_;
+
+    // The state features of the next states
+    std::vector<unsigned int> next_offsets_;
+    std::vector<unsigned int> next_indices_;
+    std::vector<double> next_values_;
+
+    // The index of every feature among the active features, -1 if inactive, and the active features
+    std::vector<int> active_index_;
+    std::vector<unsigned int> active_features_;
+
+    // Phi and b of the active features
+    RowMajorMatrix phi_;
+    Eigen::VectorXd vector_b_;
+
+    // The greedy next action of every sample
+    std::vector<unsigned int> next_actions_;
+
+    LSTDQStatistics statistics_;
+
+    // The weights of the active features and of all features
+    Eigen::VectorXd active_solution_;
+    Eigen::VectorXd solution_;
+};
+
+#endif // SPARSELSTDQ_H
@@ -0,0 +1,197 @@
+#include "surfacegeometry.h"
+
+#include <cmath>
+#include <algorithm>
+
+SurfaceGeometry::SurfaceGeometry(const Asteroid &asteroid, const unsigned int &face_cells, const unsigned int &radial_cells)
+    : asteroid_(asteroid), face_cells_(face_cells), radial_cells_(radial_cells) {
+    if (face_cells_ == 0 || radial_cells_ == 0) {
+        throw InvalidResolutionException();
+    }
+
+    semi_axis_ = asteroid.SemiAxis();
+    largest_semi_axis_pow2_ = 0.0;
+    for (unsigned int i = 0; i < 3; ++i) {
+        semi_axis_pow2_[i] = semi_axis_[i] * semi_axis_[i];
+        inverse_semi_axis_pow2_[i] = 1.0 / semi_axis_pow2_[i];
+        largest_semi_axis_pow2_ = std::max(largest_semi_axis_pow2_, semi_axis_pow2_[i]);
+    }
+
+    relative_roots_.resize(3 * (face_cells_ + 1) * (face_cells_ + 1) * (radial_cells_ + 1));
+    for (unsigned int face = 0; face < 3; ++face) {
+        for (unsigned int i = 0; i <= face_cells_; ++i) {
+            for (unsigned int j = 0; j <= face_cells_; ++j) {
+                // keep the coordinates off 0, which Asteroid handles as lower dimensional case
+                Vector3D direction;
+                direction[face] = 1.0;
+                direction[(face + 1) % 3] = std::max(static_cast<double>(i) / face_cells_, 1e-9);
+                direction[(face + 2) % 3] = std::max(static_cast<double>(j) / face_cells_, 1e-9);
+                const Vector3D surface_point = asteroid.IntersectLineToCenterFromPosition(direction);
+
+                for (unsigned int k = 0; k <= radial_cells_; ++k) {
+                    double relative_root = 0.0;
+                    if (k == 0) {
+                        // w = 0: infinitely far away, t / sqrt(sum a_i^2 p_i^2) tends to 1
+                        relative_root = 1.0;
+                    } else if (k < radial_cells_) {
+                        const double w = static_cast<double>(k) / radial_cells_;
+                        const Vector3D position = VectorMul(1.0 / w, surface_point);
+                        const Vector3D point = boost::get<0>(asteroid.NearestPointOnSurfaceToPosition(position));
+
+                        // position = point + t (point_i / a_i^2)
+                        Vector3D normal;
+                        double scale = 0.0;
+                        for (unsigned int l = 0; l < 3; ++l) {
+                            normal[l] = point[l] / semi_axis_pow2_[l];
+                            scale += semi_axis_pow2_[l] * position[l] * position[l];
+                        }
+                        const double root = VectorDotProduct(VectorSub(position, point), normal) / VectorDotProduct(normal, normal);
+                        relative_root = root / sqrt(scale);
+                    }
+                    relative_roots_[NodeIndex(face, i, j, k)] = relative_root;
+                }
+            }
+        }
+    }
+}
+
+unsigned int SurfaceGeometry::NodeIndex(const unsigned int &face, const unsigned int &i, const unsigned int &j, const unsigned int &k) const {
+    return ((face * (face_cells_ + 1) + i) * (face_cells_ + 1) + j) * (radial_cells_ + 1) + k;
+}
+
+double SurfaceGeometry::InitialRoot(const Vector3D &abs_position, const double &eval, const double &scale) const {
+    unsigned int face = 0;
+    if (abs_position[1] > abs_position[face]) {
+        face = 1;
+    }
+    if (abs_position[2] > abs_position[face]) {
+        face = 2;
+    }
+
+    // continuous grid coordinates, their cells and the fractions within
+    const double inverse_largest = face_cells_ / abs_position[face];
+    const double coordinates[3] = {abs_position[(face + 1) % 3] * inverse_largest,
+                                   abs_position[(face + 2) % 3] * inverse_largest,
+                                   radial_cells_ / sqrt(eval)};
+    const unsigned int limits[3] = {face_cells_ - 1, face_cells_ - 1, radial_cells_ - 1};
+    unsigned int cells[3];
+    double fractions[3];
+    for (unsigned int l = 0; l < 3; ++l) {
+        cells[l] = std::min(static_cast<unsigned int>(coordinates[l]), limits[l]);
+        fractions[l] = coordinates[l] - cells[l];
+    }
+
+    // trilinear interpolation, k is the contiguous index
+    const double *node = &relative_roots_[NodeIndex(face, cells[0], cells[1], cells[2])];
+    const unsigned int stride_j = radial_cells_ + 1;
+    const unsigned int stride_i = (face_cells_ + 1) * stride_j;
+    const double value_00 = node[0] + fractions[2] * (node[1] - node[0]);
+    const double value_01 = node[stride_j] + fractions[2] * (node[stride_j + 1] - node[stride_j]);
+    const double value_10 = node[stride_i] + fractions[2] * (node[stride_i + 1] - node[stride_i]);
+    const double value_11 = node[stride_i + stride_j] + fractions[2] * (node[stride_i + stride_j + 1] - node[stride_i + stride_j]);
+    const double value_0 = value_00 + fractions[1] * (value_01 - value_00);
+    const double value_1 = value_10 + fractions[1] * (value_11 - value_10);
+
+    return (value_0 + fractions[0] * (value_1 - value_0)) * scale;
+}
+
+boost::tuple<Vector3D, double> SurfaceGeometry::NearestPointOnSurfaceToPosition(const Vector3D &position) const {
+    Vector3D abs_position;
+    Vector3D semi_axis_mul_pos;
+    double eval = 0.0;
+    double scale = 0.0;
+    for (unsigned int l = 0; l < 3; ++l) {
+        abs_position[l] = fabs(position[l]);
+        semi_axis_mul_pos[l] = semi_axis_[l] * abs_position[l];
+        eval += abs_position[l] * abs_position[l] * inverse_semi_axis_pow2_[l];
+        scale += semi_axis_mul_pos[l] * semi_axis_mul_pos[l];
+    }
+    if (eval <= 1.0 || abs_position[0] == 0.0 || abs_position[1] == 0.0 || abs_position[2] == 0.0) {
+        // inside or a lower dimensional case
+        return asteroid_.NearestPointOnSurfaceToPosition(position);
+    }
+    scale = sqrt(scale);
+
+    // Newton's method on David Eberly eq (26) from the interpolated root, with the tolerance of Asteroid
+    const double tolerance = 1e-3;
+    // With the largest semi axis a, sum (a_i p_i / (t + a_i^2))^2 >= sum (a_i p_i / (t + a^2))^2 bounds the root from
+    // below by sqrt(sum (a_i p_i)^2) - a^2. Newton's method converges monotonically from below the root, from above its
+    // first step lands below the root.
+    const double lower_bound = scale - largest_semi_axis_pow2_;
+    double root = std::max(InitialRoot(abs_position, eval, scale), lower_bound);
+    double error = 0.0;
+    do {
+        double f_root = -1.0;
+        double df_root = 0.0;
+        for (unsigned int l = 0; l < 3; ++l) {
+            const double inverse = 1.0 / (root + semi_axis_pow2_[l]);
+            const double value = semi_axis_mul_pos[l] * inverse;
+            f_root += value * value;
+            df_root -= 2.0 * value * value * inverse;
+        }
+        const double old_root = root;
+        root = std::max(root - f_root / df_root, lower_bound);
+        error = fabs(root - old_root);
+        if (std::isinf(root) || std::isnan(root)) {
+            throw Asteroid::PositionInsideException();
+        }
+    } while (error > tolerance);
+
+    Vector3D point;
+    for (unsigned int l = 0; l < 3; ++l) {
+        point[l] = semi_axis_pow2_[l] * position[l] / (root + semi_axis_pow2_[l]);
+    }
+    const double distance = VectorNorm(VectorSub(point, position));
+
+    return boost::make_tuple(point, distance);
+}
+
+Vector3D SurfaceGeometry::PositionAtLatitudeAndLongitude(const double &latitude, const double &longitude) const {
+    // latitude = acos(z / c), longitude = atan2(a y, b x)
+    const double sin_latitude = sin(latitude);
+    const Vector3D position = {semi_axis_[0] * sin_latitude * cos(longitude),
+                               semi_axis_[1] * sin_latitude * sin(longitude),
+                               semi_axis_[2] * cos(latitude)};
+    return position;
+}
+
+void SurfaceGeometry::NearestPointsOnSurfaceToPositions(const std::vector<Vector3D> &positions, std::vector<Vector3D> &points, std::vector<double> &distances) const {
+    const unsigned int num_positions = positions.size();
+    points.resize(num_positions);
+    distances.resize(num_positions);
+    for (unsigned int i = 0; i < num_positions; ++i) {
+        const boost::tuple<Vector3D, double> result = NearestPointOnSurfaceToPosition(positions[i]);
+        points[i] = boost::get<0>(result);
+        distances[i] = boost::get<1>(result);
+    }
+}
+
+void SurfaceGeometry::LatitudesAndLongitudesAtPositions(const std::vector<Vector3D> &positions, std::vector<double> &latitudes, std::vector<double> &longitudes) const {
+    const unsigned int num_positions = positions.size();
+    latitudes.resize(num_positions);
+    longitudes.resize(num_positions);
+    for (unsigned int i = 0; i < num_positions; ++i) {
+        const boost::tuple<double, double> result = asteroid_.LatitudeAndLongitudeAtPosition(positions[i]);
+        latitudes[i] = boost::get<0>(result);
+        longitudes[i] = boost::get<1>(result);
+    }
+}
+
+void SurfaceGeometry::PositionsAtLatitudesAndLongitudes(const std::vector<double> &latitudes, const std::vector<double> &longitudes, std::vector<Vector3D> &positions) const {
+    if (latitudes.size() != longitudes.size()) {
+        throw SizeMismatchException();
+    }
+    const unsigned int num_positions = latitudes.size();
+    positions.resize(num_positions);
+    for (unsigned int i = 0; i < num_positions; ++i) {
+        positions[i] = PositionAtLatitudeAndLongitude(latitudes[i], longitudes[i]);
+    }
+}
+
+void SurfaceGeometry::IntersectLinesToCenterFromPositions(const std::vector<Vector3D> &positions, std::vector<Vector3D> &points) const {
+    const unsigned int num_positions = positions.size();
+    points.resize(num_positions);
+    for (unsigned int i = 0; i < num_positions; ++i) {
+        points[i] = asteroid_.IntersectLineToCenterFromPosition(positions[i]);
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef SURFACEGEOMETRY_H
+#define SURFACEGEOMETRY_H
+
+#include "vector.h"
+#include "asteroid.h"
+
+#include <vector>
+
+class SurfaceGeometry {
+    /*
+    * This class provides batched surface geometry queries of an asteroid: projection onto the surface, latitude and
+    * longitude of surface points and the inverse mapping.
+    *
+    * The nearest point search is warm started from a precomputed grid. Positions are mirrored into the first octant and
+    * indexed by the cube map face of their direction (the largest coordinate), the two other coordinates divided by the
+    * largest one and w = 1 / sqrt(x^2/a^2 + y^2/b^2 + z^2/c^2), which is 1 on the surface and tends to 0 far away.
+    * The grid nodes store the root t of David Eberly eq (26) relative to sqrt(a^2 x^2 + b^2 y^2 + c^2 z^2), which is smooth
+    * and in [0, 1). Interpolating it leaves Newton's method a few iterations instead of about ten. The index needs no
+    * trigonometric functions, the results agree with Asteroid::NearestPointOnSurfaceToPosition to the method's tolerance.
+    */
+public:
+    // "face_cells" cells along both axis of every cube face and "radial_cells" cells along w
+    SurfaceGeometry(const Asteroid &asteroid, const unsigned int &face_cells=16, const unsigned int &radial_cells=16);
+
+    // Asteroid::NearestPointOnSurfaceToPosition, warm started
+    boost::tuple<Vector3D, double> NearestPointOnSurfaceToPosition(const Vector3D &position) const;
+
+    // Returns the inverse of Asteroid::LatitudeAndLongitudeAtPosition, a point on the surface
+    Vector3D PositionAtLatitudeAndLongitude(const double &latitude, const double &longitude) const;
+
+    // Batched versions, the outputs are resized to the number of inputs
+    void NearestPointsOnSurfaceToPositions(const std::vector<Vector3D> &positions, std::vector<Vector3D> &points, std::vector<double> &distances) const;
+    void LatitudesAndLongitudesAtPositions(const std::vector<Vector3D> &positions, std::vector<double> &latitudes, std::vector<double> &longitudes) const;
+    void PositionsAtLatitudesAndLongitudes(const std::vector<double> &latitudes, const std::vector<double> &longitudes, std::vector<Vector3D> &positions) const;
+    void IntersectLinesToCenterFromPositions(const std::vector<Vector3D> &positions, std::vector<Vector3D> &points) const;
+
+    // SurfaceGeometry can throw the following exceptions
+    class Exception {};
+    class InvalidResolutionException : public Exception {};
+    class SizeMismatchException : public Exception {};
+
+private:
+    // Returns the interpolated root for the first octant position "abs_position" outside the asteroid,
+    // "eval" is x^2/a^2 + y^2/b^2 + z^2/c^2 and "scale" sqrt(a^2 x^2 + b^2 y^2 + c^2 z^2)
+    double InitialRoot(const Vector3D &abs_position, const double &eval, const double &scale) const;
+
+    // Returns the index of grid node (face, i, j, k)
+    unsigned int NodeIndex(const unsigned int &face, const unsigned int &i, const unsigned int &j, const unsigned int &k) const;
+
+    // The asteroid the geometry belongs to
+    const Asteroid &asteroid_;
+
+    // Cached semi axis and their power of 2
+    Vector3D semi_axis_;
+    Vector3D semi_axis_pow2_;
+    Vector3D inverse_semi_axis_pow2_;
+
+    // The largest power of 2 of the semi axis, the axis of Asteroid are not sorted
+    double largest_semi_axis_pow2_;
+
+    // Grid resolution
+    unsigned int face_cells_;
+    unsigned int radial_cells_;
+
+    // The relative roots at the grid nodes
+    std::vector<double> relative_roots_;
+};
+
+#endif // SURFACEGEOMETRY_H
@@ -0,0 +1,105 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(const unsigned int &num_threads)
+    : task_(NULL), num_tasks_(0), next_task_(0), loop_generation_(0), busy_workers_(0), shutdown_(false) {
+    unsigned int threads = num_threads;
+    if (threads == 0) {
+        threads = HardwareThreads();
+    }
+
+    for (unsigned int i = 1; i < threads; ++i) {
+        workers_.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    loop_started_.notify_all();
+
+    for (unsigned int i = 0; i < workers_.size(); ++i) {
+        workers_.at(i).join();
+    }
+}
+
+void ThreadPool::ParallelFor(const unsigned int &num_tasks, const std::function<void(const unsigned int &, const unsigned int &)> &task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        num_tasks_ = num_tasks;
+        next_task_ = 0;
+        exception_ = std::exception_ptr();
+        busy_workers_ = workers_.size();
+        ++loop_generation_;
+    }
+    loop_started_.notify_all();
+
+    RunTasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (busy_workers_ > 0) {
+        loop_finished_.wait(lock);
+    }
+    task_ = NULL;
+
+    if (exception_) {
+        const std::exception_ptr exception = exception_;
+        exception_ = std::exception_ptr();
+        std::rethrow_exception(exception);
+    }
+}
+
+unsigned int ThreadPool::NumThreads() const {
+    return workers_.size() + 1;
+}
+
+unsigned int ThreadPool::HardwareThreads() {
+    const unsigned int threads = std::thread::hardware_concurrency();
+    return (threads > 0 ? threads : 1);
+}
+
+void ThreadPool::WorkerLoop(const unsigned int &thread_index) {
+    unsigned int seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!shutdown_ && loop_generation_ == seen_generation) {
+                loop_started_.wait(lock);
+            }
+            if (shutdown_) {
+                return;
+            }
+            seen_generation = loop_generation_;
+        }
+
+        RunTasks(thread_index);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        --busy_workers_;
+        if (busy_workers_ == 0) {
+            loop_finished_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::RunTasks(const unsigned int &thread_index) {
+    while (true) {
+        const unsigned int task_index = next_task_++;
+        if (task_index >= num_tasks_) {
+            return;
+        }
+
+        try {
+            (*task_)(task_index, thread_index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!exception_) {
+                exception_ = std::current_exception();
+            }
+            // skip the remaining tasks
+            next_task_ = num_tasks_;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+class ThreadPool {
+    /*
+    * This class represents a fixed set of worker threads which run loops of independent tasks.
+    *
+    * ParallelFor hands the task indices out one by one (dynamic scheduling), so tasks of very different duration (e.g.
+    * simulations which crash early) balance over the threads. The calling thread works as thread 0, the pool starts
+    * NumThreads() - 1 additional threads which sleep between loops.
+    *
+    * The first exception a task throws is rethrown by ParallelFor once all threads have finished the loop, the remaining
+    * tasks of the loop are skipped.
+    */
+public:
+    // num_threads == 0 uses one thread per hardware thread
+    ThreadPool(const unsigned int &num_threads=0);
+
+    ~ThreadPool();
+
+    // Runs task(task_index, thread_index) for all task_index in [0, num_tasks) and returns when all are done.
+    // thread_index is in [0, NumThreads()) and can be used to select per thread state. Tasks must not call ParallelFor.
+    void ParallelFor(const unsigned int &num_tasks, const std::function<void(const unsigned int &, const unsigned int &)> &task);
+
+    // Returns the number of threads working on a loop, including the calling thread
+    unsigned int NumThreads() const;
+
+    // Returns the number of hardware threads, at least 1
+    static unsigned int HardwareThreads();
+
+private:
+    ThreadPool(const ThreadPool &other);
+    ThreadPool& operator=(const ThreadPool &other);
+
+    // The loop of the additional threads
+    void WorkerLoop(const unsigned int &thread_index);
+
+    // Runs tasks of the current loop until none are left
+    void RunTasks(const unsigned int &thread_index);
+
+    // The additional threads
+    std::vector<std::thread> workers_;
+
+    // Protects the loop state below
+    std::mutex mutex_;
+    std::condition_variable loop_started_;
+    std::condition_variable loop_finished_;
+
+    // The task of the current loop
+    const std::function<void(const unsigned int &, const unsigned int &)> *task_;
+
+    // The number of tasks of the current loop
+    unsigned int num_tasks_;
+
+    // The next task index to hand out
+    std::atomic<unsigned int> next_task_;
+
+    // Incremented for every loop, wakes the workers
+    unsigned int loop_generation_;
+
+    // Number of additional threads still working on the current loop
+    unsigned int busy_workers_;
+
+    // The first exception thrown by a task of the current loop
+    std::exception_ptr exception_;
+
+    // Set on destruction
+    bool shutdown_;
+};
+
+#endif // THREADPOOL_H
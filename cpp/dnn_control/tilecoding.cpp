@@ -0,0 +1,93 @@
+#include "tilecoding.h"
+
+#include <cmath>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+
+TileCoding::TileCoding(const std::vector<double> &lower, const std::vector<double> &upper, const unsigned int &num_tilings, const unsigned int &tiles_per_dimension, const unsigned int &memory_size)
+    : lower_(lower), upper_(upper), num_tilings_(num_tilings), tiles_per_dimension_(tiles_per_dimension), memory_size_(memory_size), tiles_per_tiling_(0) {
+
+    if (lower.empty() || lower.size() != upper.size() || num_tilings == 0 || tiles_per_dimension == 0) {
+        throw InvalidParameterException();
+    }
+
+    double num_tiles = 1.0;
+    for (unsigned int i = 0; i < lower.size(); ++i) {
+        if (upper[i] <= lower[i]) {
+            throw InvalidParameterException();
+        }
+        tile_width_.push_back((upper[i] - lower[i]) / tiles_per_dimension);
+        num_tiles *= tiles_per_dimension + 1;
+    }
+
+    if (memory_size_ > 0) {
+        num_features_ = memory_size_;
+    } else {
+        if (num_tiles * num_tilings > 4294967295.0) {
+            throw InvalidParameterException();
+        }
+        tiles_per_tiling_ = static_cast<unsigned int>(num_tiles);
+        num_features_ = tiles_per_tiling_ * num_tilings;
+    }
+}
+
+TileCoding::~TileCoding() {
+
+}
+
+unsigned int TileCoding::NumFeatures() const {
+    return num_features_;
+}
+
+unsigned int TileCoding::StateDimension() const {
+    return lower_.size();
+}
+
+void TileCoding::Features(const double *state, std::vector<unsigned int> &indices, std::vector<double> &values) const {
+    const unsigned int dimension = lower_.size();
+    indices.clear();
+    values.clear();
+
+    for (unsigned int t = 0; t < num_tilings_; ++t) {
+        boost::uint64_t tile = 0;
+        boost::uint64_t hash = 14695981039346656037ULL ^ t;
+        for (unsigned int i = 0; i < dimension; ++i) {
+            const double offset = std::fmod(static_cast<double>(t * (2 * i + 1)) / num_tilings_, 1.0);
+            const double position = (state[i] - lower_[i]) / tile_width_[i] + offset;
+            const int coordinate = std::min(static_cast<int>(tiles_per_dimension_), std::max(0, static_cast<int>(std::floor(position))));
+            tile = tile * (tiles_per_dimension_ + 1) + coordinate;
+            hash = (hash ^ static_cast<boost::uint64_t>(coordinate)) * 1099511628211ULL;
+        }
+
+        if (memory_size_ > 0) {
+            indices.push_back(hash % memory_size_);
+        } else {
+            indices.push_back(t * tiles_per_tiling_ + tile);
+        }
+        values.push_back(1.0);
+    }
+
+    if (memory_size_ > 0) {
+        // hashed tiles are unordered and can collide
+        std::sort(indices.begin(), indices.end());
+        unsigned int num_unique = 0;
+        for (unsigned int k = 0; k < indices.size(); ++k) {
+            if (num_unique > 0 && indices[num_unique - 1] == indices[k]) {
+                values[num_unique - 1] += 1.0;
+            } else {
+                indices[num_unique] = indices[k];
+                values[num_unique] = 1.0;
+                ++num_unique;
+            }
+        }
+        indices.resize(num_unique);
+        values.resize(num_unique);
+    }
+}
+
+void TileCoding::WriteTo(std::ostream &stream) const {
+    const boost::uint32_t header[5] = {TileCodingType, static_cast<boost::uint32_t>(lower_.size()), num_tilings_, tiles_per_dimension_, memory_size_};
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(lower_.data()), lower_.size() * sizeof(double));
+    stream.write(reinterpret_cast<const char*>(upper_.data()), upper_.size() * sizeof(double));
+}
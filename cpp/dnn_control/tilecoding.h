@@ -0,0 +1,57 @@
+#ifndef TILECODING_H
+#define TILECODING_H
+
+#include "lspistatebasis.h"
+
+#include <vector>
+
+class TileCoding : public LSPIStateBasis {
+    /*
+    * This class represents tile coding of the box [lower, upper] of the state space: "num_tilings" grids of
+    * "tiles_per_dimension" tiles per dimension, each displaced by a different fraction of a tile (by (1, 3, 5, ...) / num_tilings
+    * tiles in dimension (0, 1, 2, ...), as recommended by Sutton & Barto), so every tiling has one more tile per
+    * dimension to cover the box. A state activates one tile per tiling with value 1, states outside the box the nearest
+    * border tile.
+    *
+    * If "memory_size" is not 0, the tiles are hashed into "memory_size" features, so high dimensional states do not need
+    * a feature per tile. Colliding tiles of one state add up.
+    *
+    * WriteTo stores uint32 type, uint32 D, uint32 number of tilings, uint32 tiles per dimension, uint32 memory size,
+    * double lower[D], double upper[D].
+    */
+public:
+    TileCoding(const std::vector<double> &lower, const std::vector<double> &upper, const unsigned int &num_tilings, const unsigned int &tiles_per_dimension, const unsigned int &memory_size=0);
+
+    virtual ~TileCoding();
+
+    virtual unsigned int NumFeatures() const;
+
+    virtual unsigned int StateDimension() const;
+
+    virtual void Features(const double *state, std::vector<unsigned int> &indices, std::vector<double> &values) const;
+
+    virtual void WriteTo(std::ostream &stream) const;
+
+    // TileCoding can throw the following exceptions
+    class Exception {};
+    class InvalidParameterException : public Exception {};
+
+private:
+    std::vector<double> lower_;
+    std::vector<double> upper_;
+
+    std::vector<double> tile_width_;
+
+    unsigned int num_tilings_;
+
+    unsigned int tiles_per_dimension_;
+
+    unsigned int memory_size_;
+
+    // The number of tiles of one tiling, 0 if the tiles are hashed
+    unsigned int tiles_per_tiling_;
+
+    unsigned int num_features_;
+};
+
+#endif // TILECODING_H
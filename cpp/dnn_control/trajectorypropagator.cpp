@@ -0,0 +1,126 @@
+#include "trajectorypropagator.h"
+#include "odesystem.h"
+#include "odeint.h"
+#include "modifiedcontrolledrungekutta.h"
+
+#include <cmath>
+
+TrajectoryPropagator::TrajectoryPropagator(const Asteroid &asteroid, const double &spacecraft_specific_impulse, const double &spacecraft_minimum_mass, const bool &fuel_usage_enabled, const double &minimum_step_size)
+    : asteroid_(asteroid), spacecraft_specific_impulse_(spacecraft_specific_impulse), spacecraft_minimum_mass_(spacecraft_minimum_mass), fuel_usage_enabled_(fuel_usage_enabled), minimum_step_size_(minimum_step_size) {
+
+}
+
+void TrajectoryPropagator::AttitudeSystem::operator ()(const Quaternion &q, Quaternion &d_q_dt, const double &time) {
+    const Vector3D angular_velocity = boost::get<0>(asteroid_.AngularVelocityAndAccelerationAtTime(time));
+    const double &wx = angular_velocity[0];
+    const double &wy = angular_velocity[1];
+    const double &wz = angular_velocity[2];
+
+    // 1/2 Q(q) w
+    d_q_dt[0] = 0.5 * (q[3] * wx - q[2] * wy + q[1] * wz);
+    d_q_dt[1] = 0.5 * (q[2] * wx + q[3] * wy - q[0] * wz);
+    d_q_dt[2] = 0.5 * (-q[1] * wx + q[0] * wy + q[3] * wz);
+    d_q_dt[3] = 0.5 * (-q[0] * wx - q[1] * wy - q[2] * wz);
+}
+
+void TrajectoryPropagator::IntegrateAttitude(Quaternion &attitude, const double &start_time, const double &end_time) const {
+    typedef odeint::runge_kutta_cash_karp54<Quaternion> ErrorStepper;
+
+    if (end_time > start_time) {
+        AttitudeSystem attitude_system(asteroid_);
+        odeint::integrate_adaptive(odeint::make_controlled<ErrorStepper>(1e-10, 1e-10), attitude_system, attitude, start_time, end_time, end_time - start_time);
+    }
+
+    double norm = 0.0;
+    for (unsigned int i = 0; i < 4; ++i) {
+        norm += attitude[i] * attitude[i];
+    }
+    norm = sqrt(norm);
+    for (unsigned int i = 0; i < 4; ++i) {
+        attitude[i] /= norm;
+    }
+}
+
+unsigned int TrajectoryPropagator::Propagate(const SystemState &initial_system_state, const std::vector<double> &times, const std::vector<Vector3D> &thrusts, std::vector<SystemState> &system_states, std::vector<Quaternion> &attitudes) const {
+    typedef odeint::runge_kutta_cash_karp54<SystemState> ErrorStepper;
+    typedef odeint::modified_controlled_runge_kutta<ErrorStepper> ControlledStepper;
+
+    const unsigned int num_times = times.size();
+    if (num_times == 0 || thrusts.size() + 1 < num_times) {
+        throw InvalidScheduleException();
+    }
+    for (unsigned int i = 1; i < num_times; ++i) {
+        if (times[i] < times[i - 1]) {
+            throw InvalidScheduleException();
+        }
+    }
+
+    system_states.resize(num_times);
+    attitudes.resize(num_times);
+
+    ControlledStepper controlled_stepper;
+    const Vector3D perturbations_acceleration = {0.0, 0.0, 0.0};
+
+    SystemState system_state(initial_system_state);
+    Quaternion attitude = {{0.0, 0.0, 0.0, 1.0}};
+    system_states[0] = system_state;
+    attitudes[0] = attitude;
+
+    unsigned int num_states = 1;
+    try {
+        for (; num_states < num_times; ++num_states) {
+            const double &start_time = times[num_states - 1];
+            const double &end_time = times[num_states];
+
+            if (end_time > start_time) {
+                ODESystem ode_system(asteroid_, perturbations_acceleration, thrusts[num_states - 1], spacecraft_specific_impulse_, spacecraft_minimum_mass_, 0.0, fuel_usage_enabled_);
+                integrate_adaptive(controlled_stepper, ode_system, system_state, start_time, end_time, minimum_step_size_);
+            }
+            IntegrateAttitude(attitude, start_time, end_time);
+
+            system_states[num_states] = system_state;
+            attitudes[num_states] = attitude;
+        }
+    } catch (const Asteroid::Exception &exception) {
+        // The spacecraft crashed into the asteroid's surface.
+    } catch (const ODESystem::Exception &exception) {
+        // The spacecraft is out of fuel.
+    }
+
+    system_states.resize(num_states);
+    attitudes.resize(num_states);
+
+    return num_states;
+}
+
+void TrajectoryPropagator::Attitudes(const std::vector<double> &times, std::vector<Quaternion> &attitudes) const {
+    attitudes.resize(times.size());
+
+    Quaternion attitude = {{0.0, 0.0, 0.0, 1.0}};
+    for (unsigned int i = 0; i < times.size(); ++i) {
+        if (i > 0) {
+            if (times[i] < times[i - 1]) {
+                throw InvalidScheduleException();
+            }
+            IntegrateAttitude(attitude, times[i - 1], times[i]);
+        }
+        attitudes[i] = attitude;
+    }
+}
+
+boost::array<double,9> TrajectoryPropagator::RotationMatrix(const Quaternion &q) {
+    const boost::array<double,9> rotation = {{
+        q[3] * q[3] + q[0] * q[0] - q[1] * q[1] - q[2] * q[2], 2.0 * (q[0] * q[1] - q[3] * q[2]), 2.0 * (q[0] * q[2] + q[3] * q[1]),
+        2.0 * (q[0] * q[1] + q[3] * q[2]), q[3] * q[3] - q[0] * q[0] + q[1] * q[1] - q[2] * q[2], 2.0 * (q[1] * q[2] - q[3] * q[0]),
+        2.0 * (q[0] * q[2] - q[3] * q[1]), 2.0 * (q[1] * q[2] + q[3] * q[0]), q[3] * q[3] - q[0] * q[0] - q[1] * q[1] + q[2] * q[2]}};
+    return rotation;
+}
+
+Vector3D TrajectoryPropagator::BodyToInertial(const Quaternion &quaternion, const Vector3D &vector) {
+    const boost::array<double,9> rotation = RotationMatrix(quaternion);
+    Vector3D result;
+    for (unsigned int i = 0; i < 3; ++i) {
+        result[i] = rotation[3 * i] * vector[0] + rotation[3 * i + 1] * vector[1] + rotation[3 * i + 2] * vector[2];
+    }
+    return result;
+}
@@ -0,0 +1,72 @@
+#ifndef TRAJECTORYPROPAGATOR_H
+#define TRAJECTORYPROPAGATOR_H
+
+#include "vector.h"
+#include "systemstate.h"
+#include "asteroid.h"
+
+#include <vector>
+#include <boost/array.hpp>
+
+// The asteroid's attitude as unit quaternion (x, y, z, w)
+typedef boost::array<double,4> Quaternion;
+
+class TrajectoryPropagator {
+    /*
+    * This class integrates a spacecraft trajectory in the asteroid's body frame for a given thrust schedule, with the same
+    * ODESystem and controlled Cash-Karp stepper as the simulations (without perturbations and engine noise).
+    *
+    * Along with the states it integrates the asteroid's attitude q, dq/dt = 1/2 Q(q) w(t), starting at (0, 0, 0, 1) at
+    * the first time. RotationMatrix(q) maps body frame vectors into the inertial frame.
+    */
+public:
+    TrajectoryPropagator(const Asteroid &asteroid, const double &spacecraft_specific_impulse, const double &spacecraft_minimum_mass, const bool &fuel_usage_enabled, const double &minimum_step_size=0.1);
+
+    // Integrates from "initial_system_state" at times[0] over the increasing "times", thrusts[i] acts during
+    // [times[i], times[i + 1]). Writes the state and attitude at every time reached to "system_states" and "attitudes"
+    // and returns their number, which is less than times.size() if the spacecraft crashed or ran out of fuel.
+    unsigned int Propagate(const SystemState &initial_system_state, const std::vector<double> &times, const std::vector<Vector3D> &thrusts, std::vector<SystemState> &system_states, std::vector<Quaternion> &attitudes) const;
+
+    // Writes the asteroid's attitude at the increasing "times" to "attitudes"
+    void Attitudes(const std::vector<double> &times, std::vector<Quaternion> &attitudes) const;
+
+    // Returns the body to inertial frame rotation of attitude "quaternion", row major
+    static boost::array<double,9> RotationMatrix(const Quaternion &quaternion);
+
+    // Returns body frame vector "vector" in the inertial frame of attitude "quaternion"
+    static Vector3D BodyToInertial(const Quaternion &quaternion, const Vector3D &vector);
+
+    // TrajectoryPropagator can throw the following exceptions
+    class Exception {};
+    class InvalidScheduleException : public Exception {};
+
+private:
+    // dq/dt of the asteroid's attitude
+    class AttitudeSystem {
+    public:
+        AttitudeSystem(const Asteroid &asteroid) : asteroid_(asteroid) {}
+        void operator () (const Quaternion &q, Quaternion &d_q_dt, const double &time);
+    private:
+        const Asteroid &asteroid_;
+    };
+
+    // Integrates "attitude" from "start_time" to "end_time" and normalizes it
+    void IntegrateAttitude(Quaternion &attitude, const double &start_time, const double &end_time) const;
+
+    // The asteroid the trajectory is integrated around
+    const Asteroid &asteroid_;
+
+    // The spacecraft's Isp
+    double spacecraft_specific_impulse_;
+
+    // The spacecraft's minimum mass
+    double spacecraft_minimum_mass_;
+
+    // Is fuel usage enabled
+    bool fuel_usage_enabled_;
+
+    // Minimum step size of the adaptive integrator
+    double minimum_step_size_;
+};
+
+#endif // TRAJECTORYPROPAGATOR_H
@@ -0,0 +1,271 @@
+#include "trianglemesh.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <boost/cstdint.hpp>
+
+// A property of a PLY element, lists have a count type
+struct PLYProperty {
+    std::string name;
+    std::string type;
+    std::string count_type;
+    bool is_list;
+};
+
+// An element of a PLY file
+struct PLYElement {
+    std::string name;
+    unsigned int count;
+    std::vector<PLYProperty> properties;
+};
+
+// Reads one value of PLY type "type" from "file"
+static double ReadPLYValue(std::istream &file, const std::string &type, const bool &binary) {
+    if (!binary) {
+        double value = 0.0;
+        if (!(file >> value)) {
+            throw TriangleMesh::InvalidFileFormatException();
+        }
+        return value;
+    }
+
+    char bytes[8];
+    unsigned int size = 0;
+    if (type == "char" || type == "int8" || type == "uchar" || type == "uint8") {
+        size = 1;
+    } else if (type == "short" || type == "int16" || type == "ushort" || type == "uint16") {
+        size = 2;
+    } else if (type == "int" || type == "int32" || type == "uint" || type == "uint32" || type == "float" || type == "float32") {
+        size = 4;
+    } else if (type == "double" || type == "float64") {
+        size = 8;
+    } else {
+        throw TriangleMesh::InvalidFileFormatException();
+    }
+    if (!file.read(bytes, size)) {
+        throw TriangleMesh::InvalidFileFormatException();
+    }
+
+    // binary little endian files are read on little endian hosts
+    if (type == "char" || type == "int8") {
+        boost::int8_t value; std::memcpy(&value, bytes, size); return value;
+    } else if (type == "uchar" || type == "uint8") {
+        boost::uint8_t value; std::memcpy(&value, bytes, size); return value;
+    } else if (type == "short" || type == "int16") {
+        boost::int16_t value; std::memcpy(&value, bytes, size); return value;
+    } else if (type == "ushort" || type == "uint16") {
+        boost::uint16_t value; std::memcpy(&value, bytes, size); return value;
+    } else if (type == "int" || type == "int32") {
+        boost::int32_t value; std::memcpy(&value, bytes, size); return value;
+    } else if (type == "uint" || type == "uint32") {
+        boost::uint32_t value; std::memcpy(&value, bytes, size); return value;
+    } else if (type == "float" || type == "float32") {
+        float value; std::memcpy(&value, bytes, size); return value;
+    }
+    double value; std::memcpy(&value, bytes, size); return value;
+}
+
+// Appends the fan triangulation of polygon "polygon" to "faces"
+static void AppendPolygon(const std::vector<unsigned int> &polygon, std::vector<TriangleFace> &faces) {
+    for (unsigned int i = 1; i + 1 < polygon.size(); ++i) {
+        const TriangleFace face = {{polygon[0], polygon[i], polygon[i + 1]}};
+        faces.push_back(face);
+    }
+}
+
+TriangleMesh::TriangleMesh(const std::vector<Vector3D> &vertices, const std::vector<TriangleFace> &faces)
+    : vertices_(vertices), faces_(faces) {
+    if (faces_.size() < 4) {
+        throw InvalidMeshException();
+    }
+
+    // sum of the signed tetrahedra spanned by the origin and every face
+    volume_ = 0.0;
+    centroid_.fill(0.0);
+    for (unsigned int i = 0; i < faces_.size(); ++i) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            if (faces_[i][j] >= vertices_.size()) {
+                throw InvalidMeshException();
+            }
+        }
+        const Vector3D &vertex_0 = vertices_[faces_[i][0]];
+        const Vector3D &vertex_1 = vertices_[faces_[i][1]];
+        const Vector3D &vertex_2 = vertices_[faces_[i][2]];
+        const double volume = VectorDotProduct(vertex_0, VectorCrossProduct(vertex_1, vertex_2)) / 6.0;
+        volume_ += volume;
+        for (unsigned int j = 0; j < 3; ++j) {
+            centroid_[j] += volume * (vertex_0[j] + vertex_1[j] + vertex_2[j]) / 4.0;
+        }
+    }
+
+    if (volume_ < 0.0) {
+        for (unsigned int i = 0; i < faces_.size(); ++i) {
+            std::swap(faces_[i][1], faces_[i][2]);
+        }
+        volume_ = -volume_;
+        for (unsigned int j = 0; j < 3; ++j) {
+            centroid_[j] = -centroid_[j];
+        }
+    }
+    if (volume_ == 0.0) {
+        throw InvalidMeshException();
+    }
+    centroid_ = VectorMul(1.0 / volume_, centroid_);
+}
+
+TriangleMesh TriangleMesh::FromOBJFile(const std::string &path_to_file, const double &scale) {
+    std::ifstream file(path_to_file.c_str());
+    if (!file.is_open()) {
+        throw FileNotReadableException();
+    }
+
+    std::vector<Vector3D> vertices;
+    std::vector<TriangleFace> faces;
+    std::vector<unsigned int> polygon;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "v") {
+            Vector3D vertex;
+            if (!(tokens >> vertex[0] >> vertex[1] >> vertex[2])) {
+                throw InvalidFileFormatException();
+            }
+            vertices.push_back(VectorMul(scale, vertex));
+        } else if (keyword == "f") {
+            // "f 1 2 3", "f 1/1 2/2 3/3" or "f 1//1 ...", indices start at 1, negative ones count from the end
+            polygon.clear();
+            std::string token;
+            while (tokens >> token) {
+                const long index = strtol(token.c_str(), NULL, 10);
+                if (index == 0 || (index < 0 && -index > static_cast<long>(vertices.size()))) {
+                    throw InvalidFileFormatException();
+                }
+                polygon.push_back(index > 0 ? index - 1 : vertices.size() + index);
+            }
+            AppendPolygon(polygon, faces);
+        }
+    }
+
+    return TriangleMesh(vertices, faces);
+}
+
+TriangleMesh TriangleMesh::FromPLYFile(const std::string &path_to_file, const double &scale) {
+    std::ifstream file(path_to_file.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw FileNotReadableException();
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line.compare(0, 3, "ply") != 0) {
+        throw InvalidFileFormatException();
+    }
+
+    bool binary = false;
+    std::vector<PLYElement> elements;
+    while (true) {
+        if (!std::getline(file, line)) {
+            throw InvalidFileFormatException();
+        }
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "format") {
+            std::string format;
+            tokens >> format;
+            if (format == "binary_little_endian") {
+                binary = true;
+            } else if (format != "ascii") {
+                throw InvalidFileFormatException();
+            }
+        } else if (keyword == "element") {
+            PLYElement element;
+            if (!(tokens >> element.name >> element.count)) {
+                throw InvalidFileFormatException();
+            }
+            elements.push_back(element);
+        } else if (keyword == "property") {
+            if (elements.empty()) {
+                throw InvalidFileFormatException();
+            }
+            PLYProperty property;
+            tokens >> property.type;
+            property.is_list = (property.type == "list");
+            if (property.is_list) {
+                tokens >> property.count_type >> property.type;
+            }
+            tokens >> property.name;
+            elements.back().properties.push_back(property);
+        } else if (keyword == "end_header") {
+            break;
+        }
+    }
+
+    std::vector<Vector3D> vertices;
+    std::vector<TriangleFace> faces;
+    std::vector<unsigned int> polygon;
+    for (unsigned int e = 0; e < elements.size(); ++e) {
+        const PLYElement &element = elements[e];
+        for (unsigned int i = 0; i < element.count; ++i) {
+            Vector3D vertex = {0.0, 0.0, 0.0};
+            polygon.clear();
+            for (unsigned int p = 0; p < element.properties.size(); ++p) {
+                const PLYProperty &property = element.properties[p];
+                if (property.is_list) {
+                    const unsigned int count = ReadPLYValue(file, property.count_type, binary);
+                    for (unsigned int j = 0; j < count; ++j) {
+                        const double value = ReadPLYValue(file, property.type, binary);
+                        if (property.name == "vertex_indices" || property.name == "vertex_index") {
+                            polygon.push_back(static_cast<unsigned int>(value));
+                        }
+                    }
+                } else {
+                    const double value = ReadPLYValue(file, property.type, binary);
+                    if (property.name == "x") {
+                        vertex[0] = value;
+                    } else if (property.name == "y") {
+                        vertex[1] = value;
+                    } else if (property.name == "z") {
+                        vertex[2] = value;
+                    }
+                }
+            }
+
+            if (element.name == "vertex") {
+                vertices.push_back(VectorMul(scale, vertex));
+            } else if (element.name == "face") {
+                AppendPolygon(polygon, faces);
+            }
+        }
+    }
+
+    return TriangleMesh(vertices, faces);
+}
+
+const std::vector<Vector3D>& TriangleMesh::Vertices() const {
+    return vertices_;
+}
+
+const std::vector<TriangleFace>& TriangleMesh::Faces() const {
+    return faces_;
+}
+
+double TriangleMesh::Volume() const {
+    return volume_;
+}
+
+Vector3D TriangleMesh::Centroid() const {
+    return centroid_;
+}
+
+double TriangleMesh::BoundingRadius() const {
+    double radius = 0.0;
+    for (unsigned int i = 0; i < vertices_.size(); ++i) {
+        radius = std::max(radius, VectorNorm(vertices_[i]));
+    }
+    return radius;
+}
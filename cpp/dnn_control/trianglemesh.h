@@ -0,0 +1,61 @@
+#ifndef TRIANGLEMESH_H
+#define TRIANGLEMESH_H
+
+#include "vector.h"
+
+#include <vector>
+#include <string>
+#include <boost/array.hpp>
+
+// The three vertex indices of a triangle, counter clockwise seen from outside
+typedef boost::array<unsigned int, 3> TriangleFace;
+
+class TriangleMesh {
+    /*
+    * This class represents a closed triangle mesh of an asteroid's surface in its body fixed RF, e.g. a shape model
+    * loaded from an OBJ or PLY file.
+    *
+    * Polygons are triangulated as fans. The faces are oriented outwards on construction: if the enclosed signed volume
+    * is negative all faces are flipped.
+    */
+public:
+    TriangleMesh(const std::vector<Vector3D> &vertices, const std::vector<TriangleFace> &faces);
+
+    // Loads the "v" and "f" lines of a Wavefront OBJ file, the coordinates are multiplied by "scale"
+    static TriangleMesh FromOBJFile(const std::string &path_to_file, const double &scale=1.0);
+
+    // Loads the vertex and face elements of an ascii or binary little endian PLY file, the coordinates are multiplied by "scale"
+    static TriangleMesh FromPLYFile(const std::string &path_to_file, const double &scale=1.0);
+
+    const std::vector<Vector3D>& Vertices() const;
+
+    const std::vector<TriangleFace>& Faces() const;
+
+    // The enclosed volume
+    double Volume() const;
+
+    // The centroid of the enclosed volume
+    Vector3D Centroid() const;
+
+    // The largest distance of a vertex from the origin
+    double BoundingRadius() const;
+
+    // TriangleMesh can throw the following exceptions
+    class Exception {};
+    class FileNotReadableException : public Exception {};
+    class InvalidFileFormatException : public Exception {};
+    class InvalidMeshException : public Exception {};
+
+private:
+    // The mesh's vertices
+    std::vector<Vector3D> vertices_;
+
+    // The mesh's faces
+    std::vector<TriangleFace> faces_;
+
+    // Enclosed volume and its centroid
+    double volume_;
+    Vector3D centroid_;
+};
+
+#endif // TRIANGLEMESH_H
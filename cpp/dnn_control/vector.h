@@ -115,4 +115,45 @@ inline double VectorDotProduct(const Vector2D &first, const Vector2D &second) {
     return first[0] * second[0] + first[1] * second[1];
 }
 
+// c = u x (u x v), without the intermediate vector
+inline Vector3D VectorDoubleCrossProduct(const Vector3D &vector_u, const Vector3D &vector_v) {
+    const double uv_0 = vector_u[1] * vector_v[2] - vector_u[2] * vector_v[1];
+    const double uv_1 = vector_u[2] * vector_v[0] - vector_u[0] * vector_v[2];
+    const double uv_2 = vector_u[0] * vector_v[1] - vector_u[1] * vector_v[0];
+    Vector3D result = {vector_u[1] * uv_2 - vector_u[2] * uv_1,
+                       vector_u[2] * uv_0 - vector_u[0] * uv_2,
+                       vector_u[0] * uv_1 - vector_u[1] * uv_0};
+    return result;
+}
+
+// a = external - 2w x r' - w' x r - w x (w x r)
+// Acceleration in the rotating frame of angular velocity w and angular acceleration w'. All three fictitious
+// terms are evaluated per component in one pass, in the same operation order as composing VectorCrossProduct calls.
+inline Vector3D VectorRotatingFrameAcceleration(const Vector3D &external_acceleration, const Vector3D &angular_velocity, const Vector3D &angular_acceleration, const Vector3D &position, const Vector3D &velocity) {
+    const double w_0 = angular_velocity[0];
+    const double w_1 = angular_velocity[1];
+    const double w_2 = angular_velocity[2];
+    const double w2_0 = 2.0 * w_0;
+    const double w2_1 = 2.0 * w_1;
+    const double w2_2 = 2.0 * w_2;
+
+    // w x (w x r)
+    const Vector3D centrifugal = VectorDoubleCrossProduct(angular_velocity, position);
+
+    Vector3D result;
+    result[0] = external_acceleration[0]
+            - (w2_1 * velocity[2] - w2_2 * velocity[1])
+            - (angular_acceleration[1] * position[2] - angular_acceleration[2] * position[1])
+            - centrifugal[0];
+    result[1] = external_acceleration[1]
+            - (w2_2 * velocity[0] - w2_0 * velocity[2])
+            - (angular_acceleration[2] * position[0] - angular_acceleration[0] * position[2])
+            - centrifugal[1];
+    result[2] = external_acceleration[2]
+            - (w2_0 * velocity[1] - w2_1 * velocity[0])
+            - (angular_acceleration[0] * position[1] - angular_acceleration[1] * position[0])
+            - centrifugal[2];
+    return result;
+}
+
 #endif // VECTOR_H
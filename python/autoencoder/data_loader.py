@@ -78,7 +78,50 @@ def load_sensor_file(file_path, num_lines=None):
     return states, actions
 
 
+def load_data_set_windows(file_paths, num_samples_per_file, history_length, feature_indexes=None, label_indexes=None,
+                          stride=1):
+    # Parses the files and builds the sliding windows in C++, returns numpy arrays (windows, labels)
+    from boost_sensor_stream import boost_sensor_stream
+
+    print '... loading ' + str(num_samples_per_file) + ' samples from each file'
+    num_lines = 0 if num_samples_per_file is None else num_samples_per_file
+    streams = [boost_sensor_stream.BoostSensorStream(file_path, num_lines) for file_path in file_paths]
+
+    print '... historifying and labelling data'
+    return boost_sensor_stream.windows(streams, history_length, feature_indexes, label_indexes, stride)
+
+
+def load_shard_manifest(manifest_path):
+    # Returns the data sets listed in a manifest written by the SensorDataGenerator as (shard path, seed, offset) tuples
+    from os.path import dirname, join
+
+    folder = dirname(manifest_path)
+    data_sets = []
+    with open(manifest_path, 'r') as manifest_file:
+        for line in manifest_file:
+            if line.startswith("#") or line.strip() == "":
+                continue
+            values = [value.strip() for value in line.split(",")]
+            data_sets.append((join(folder, values[1]), int(values[2]), int(values[3])))
+
+    return data_sets
+
+
+def load_shard_data_set(manifest_path, history_length, feature_indexes=None, label_indexes=None, stride=1):
+    # Maps all data sets of a manifest and builds their sliding windows, returns numpy arrays (windows, labels)
+    from boost_sensor_stream import boost_sensor_stream
+
+    streams = [boost_sensor_stream.load_shard(shard_path, offset)
+               for shard_path, _, offset in load_shard_manifest(manifest_path)]
+    return boost_sensor_stream.windows(streams, history_length, feature_indexes, label_indexes, stride)
+
+
 def load_data_set(file_paths, num_samples_per_file, history_length, feature_indexes=None, label_indexes=None):
+    try:
+        return load_data_set_windows(file_paths, num_samples_per_file, history_length, feature_indexes, label_indexes)
+    except ImportError:
+        pass
+
     total_states = []
     total_actions = []
     print '... loading ' + str(num_samples_per_file) + ' samples from each file'
@@ -57,7 +57,7 @@ while val <= times[-1]:
 
 ticks = array(ticks)
 
-surface_points = array([asteroid.intersect_line_to_center_from_position(pos.tolist()) for pos in positions])
+surface_points = asteroid.intersect_lines_to_center_from_positions(positions)
 norm_positions = norm(positions, axis=1)
 norm_surface_points = norm(surface_points, axis=1)
 
@@ -11,13 +11,12 @@ examples:
 
 import sys
 import matplotlib.pyplot as plt
-from numpy import array, linspace, arange
+from numpy import array, linspace, arange, cos
 from numpy.linalg import norm
 from numpy import pi
 import math
 from boost_asteroid import boost_asteroid
 Asteroid = boost_asteroid.BoostAsteroid
-from scipy.integrate import odeint
 
 import seaborn as sns
 sns.set_context("notebook", font_scale=5, rc={"lines.linewidth": 4})
@@ -62,12 +61,10 @@ heights = data[:,3:7]
 
 surface_positions = positions - heights
 
-latitude_longitudes = [asteroid.latitude_and_longitude_at_position(pos.tolist()) for pos in surface_positions]
-latitudes = [val for val, _ in latitude_longitudes]
-longitudes = [val for _, val in latitude_longitudes]
+latitudes, longitudes = asteroid.latitudes_and_longitudes_at_positions(surface_positions)
 
-latitudes = [math.cos(val) * 90.0 for val in latitudes]
-longitudes = [val / (2.0 * pi) * 360 for val in longitudes]
+latitudes = cos(latitudes) * 90.0
+longitudes = longitudes / (2.0 * pi) * 360
 
 plt.plot(longitudes, latitudes)
 plt.plot(longitudes[0],latitudes[0], 'go', markersize=15, label="Start")
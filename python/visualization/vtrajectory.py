@@ -21,7 +21,6 @@ from numpy.linalg import norm, det
 from time import sleep
 from numpy import array, eye, dot, linspace
 from math import cos, sin
-from scipy.integrate import odeint
 
 speedup = 400
 reference_frame = "body"
@@ -55,24 +54,10 @@ states = [[float(value) for value in line] for line in states]
 
 
 if reference_frame == "inertial":
-    def d_dt_q(q, t):
-        from math import isnan
-
-        Q = 0.5 * array([[q[3], -q[2], q[1]],
-                         [q[2], q[3], -q[0]],
-                         [-q[1], q[0], q[3]],
-                         [-q[0], -q[1], -q[2]]])
-
-        w, _ = array(asteroid.angular_velocity_and_acceleration_at_time(t))
-        q_dot = Q.dot(w).tolist()
-        return q_dot
-
-    q0 = [0.0, 0.0, 0.0, 1.0]
+    propagator = boost_asteroid.TrajectoryPropagator(asteroid, 200.0, 0.0, False)
     t = linspace(0.0, total_time, num_samples)
-    quaternions = odeint(d_dt_q, q0, t)
-    rotation_matrices = [array([[q[3] ** 2 + q[0] ** 2 - q[1] ** 2 - q[2] ** 2, 2.0 * (q[0] * q[1] - q[3] * q[2]), 2.0 * (q[0] * q[2] + q[3] * q[1])],
-                                [2.0 * (q[0] * q[1] + q[3] * q[2]), q[3] ** 2 - q[0] ** 2 + q[1] ** 2 - q[2] ** 2, 2.0 * (q[1] * q[2] - q[3] * q[0])],
-                                [2.0 * (q[0] * q[2] - q[3] * q[1]), 2.0 * (q[1] * q[2] + q[3] * q[0]), q[3] ** 2 - q[0] ** 2 - q[1] ** 2 + q[2] ** 2]]) for q in quaternions]
+    quaternions = propagator.attitudes(t)
+    rotation_matrices = boost_asteroid.TrajectoryPropagator.rotation_matrices(quaternions)
 
 scene.background=(1,1,1)
 scene.up = vector(0, 0, 1)